@@ -24,6 +24,8 @@
 #include "SemanticModel.h"
 #include "SyntaxTree.h"
 
+#include "parser/LexemeInterner.h"
+
 using namespace psy;
 using namespace C;
 
@@ -33,6 +35,7 @@ struct Compilation::CompilationImpl
         : Q_(compilation)
         , id_(id)
         , curUnit_(nullptr)
+        , interner_(new LexemeInterner)
     {}
 
     ~CompilationImpl()
@@ -41,6 +44,7 @@ struct Compilation::CompilationImpl
     Compilation* Q_;
     std::string id_;
     SyntaxTree* curUnit_;
+    std::shared_ptr<LexemeInterner> interner_;
 };
 
 Compilation::Compilation(const std::string& id)
@@ -52,7 +56,12 @@ Compilation::~Compilation()
 
 std::unique_ptr<Compilation> Compilation::create(const std::string& id)
 {
-    return nullptr;
+    return std::unique_ptr<Compilation>(new Compilation(id));
+}
+
+std::shared_ptr<LexemeInterner> Compilation::lexemeInterner() const
+{
+    return P->interner_;
 }
 
 std::unique_ptr<SemanticModel> Compilation::semanticModel(SyntaxTree* tree) const
@@ -33,6 +33,7 @@
 namespace psy {
 namespace C {
 
+class LexemeInterner;
 class SemanticModel;
 
 /**
@@ -52,7 +53,16 @@ public:
     /**
      * Create a new compilation.
      */
-    std::unique_ptr<Compilation> create(const std::string& id);
+    static std::unique_ptr<Compilation> create(const std::string& id);
+
+    /**
+     * The lexeme interner of \c this compilation. To share lexemes across the
+     * trees of the compilation, parse them with ParseOptions whose interner is
+     * this one.
+     *
+     * \see ParseOptions::setLexemeInterner
+     */
+    std::shared_ptr<LexemeInterner> lexemeInterner() const;
 
     /**
      * The semantic model associated to the given \p tree, which
@@ -52,6 +52,23 @@ void MemoryPool::reset()
     ptr_ = end_ = 0;
 }
 
+void MemoryPool::rollback(const Mark& mark)
+{
+    blockCount_ = mark.blockIdx_;
+    ptr_ = mark.ptr_;
+    end_ = blockCount_ == -1 ? nullptr : blocks_[blockCount_] + BLOCK_SIZE;
+}
+
+std::size_t MemoryPool::reservedBytes() const
+{
+    std::size_t cnt = 0;
+    for (int i = 0; i < allocatedBlocks_; ++i) {
+        if (blocks_[i])
+            ++cnt;
+    }
+    return cnt * BLOCK_SIZE;
+}
+
 void* MemoryPool::allocate_helper(size_t size)
 {
     if (++blockCount_ == allocatedBlocks_) {
@@ -39,6 +39,32 @@ public:
 
     void reset();
 
+    /**
+     * The bytes of the blocks reserved by \c this MemoryPool; since blocks
+     * are reused (not released) upon a reset, this is the peak of its usage.
+     */
+    std::size_t reservedBytes() const;
+
+    /**
+     * The position of the next allocation in a MemoryPool.
+     */
+    struct Mark
+    {
+        int blockIdx_;
+        char* ptr_;
+    };
+
+    /**
+     * Mark the position of the next allocation; see rollback.
+     */
+    Mark mark() const { return Mark{ blockCount_, ptr_ }; }
+
+    /**
+     * Roll back the allocations made after the \p mark, whose memory is
+     * then reused (the blocks aren't released).
+     */
+    void rollback(const Mark& mark);
+
     void* allocate(size_t size)
     {
         size = (size + 7) & ~7;
@@ -25,13 +25,17 @@
 #include "MemoryPool.h"
 
 #include "parser/Binder.h"
+#include "parser/LexemeInterner.h"
 #include "parser/Lexer.h"
 #include "parser/Parser.h"
+#include "parser/TokenCache.h"
 #include "parser/TypeChecker.h"
 #include "syntax/SyntaxLexemes.h"
 #include "syntax/SyntaxNodes.h"
 
+#include "../common/infra/PsycheAssert.h"
 #include "../common/text/TextElementTable.h"
+#include "../common/text/TextScanner.h"
 
 #include <algorithm>
 #include <cstdarg>
@@ -39,6 +43,7 @@
 #include <functional>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <stack>
 #include <vector>
 
@@ -50,45 +55,74 @@ using namespace C;
 
 struct SyntaxTree::SyntaxTreeImpl
 {
-    SyntaxTreeImpl(SourceText text,
+    SyntaxTreeImpl(SyntaxTree* q,
+                   SourceText text,
                    ParseOptions options,
                    const std::string& path)
         : pool_(new MemoryPool())
         , text_(std::move(text))
         , options_(std::move(options))
-        , path_(path)
+        , fileId_(FileId::of(path.empty() ? "<buffer>" : path))
+        , lexemes_(new Lexemes)
         , rootNode_(nullptr)
-    {
-        if (path_.empty())
-            path_ = "<buffer>";
-    }
+        , tokens_(q)
+        , relexable_(true)
+    {}
 
     std::unique_ptr<MemoryPool> pool_;
+    // Of the parsers that work, in parallel, on the translation unit.
+    std::vector<std::unique_ptr<MemoryPool>> extraPools_;
 
     SourceText text_;
     ParseOptions options_;
-    std::string path_;
+    FileId fileId_;
+
+    struct Lexemes
+    {
+        TextElementTable<Identifier> identifiers_;
+        TextElementTable<IntegerConstant> integers_;
+        TextElementTable<FloatingConstant> floatings_;
+        TextElementTable<CharacterConstant> characters_;
+        TextElementTable<StringLiteral> strings_;
+
+        unsigned int count() const
+        {
+            return identifiers_.size()
+                    + integers_.size()
+                    + floatings_.size()
+                    + characters_.size()
+                    + strings_.size();
+        }
 
-    TextElementTable<Identifier> identifiers_;
-    TextElementTable<IntegerConstant> integers_;
-    TextElementTable<FloatingConstant> floatings_;
-    TextElementTable<CharacterConstant> characters_;
-    TextElementTable<StringLiteral> strings_;
+        // Held by the lexer of a tree (created through a text change) that
+        // inserts into the tables, which are shared with other trees.
+        std::mutex mutex_;
+    };
+    // Shared with the trees created, through text changes, from this one.
+    std::shared_ptr<Lexemes> lexemes_;
 
     SyntaxNode* rootNode_;
 
     LexedTokens tokens_;
     std::vector<LineDirective> lineDirectives_;
-    std::vector<unsigned int> startOfLineOffsets_;
+    std::unordered_map<const StringLiteral*, FileId> lineDirectiveFileIds_;
     SyntaxTree::ExpansionsTable expansions_;
+    SyntaxTree::NameScope fileScopeNames_;
+    bool relexable_;
 
+    // The diagnostics yet to be rendered, and those already rendered; both
+    // are guarded by the mutex, for diagnostics may be reported concurrently.
+    std::vector<DiagnosticRecord> pendingDiagnostics_;
     std::vector<Diagnostic> diagnostics_;
+    std::mutex diagnosticsMutex_;
+
+    std::mutex deferredBodiesMutex_;
 };
 
 SyntaxTree::SyntaxTree(SourceText text,
                        ParseOptions options,
                        const std::string& path)
-    : P(new SyntaxTreeImpl(text, options, path))
+    : P(new SyntaxTreeImpl(this, std::move(text), std::move(options), path))
 {}
 
 SyntaxTree::~SyntaxTree()
@@ -100,19 +134,45 @@ MemoryPool* SyntaxTree::unitPool() const
     return P->pool_.get();
 }
 
+/**
+ * Add a MemoryPool, owned by \c this SyntaxTree, for a parser that works (in
+ * parallel with others) on the translation unit.
+ */
+MemoryPool* SyntaxTree::addUnitPool()
+{
+    P->extraPools_.emplace_back(new MemoryPool());
+    return P->extraPools_.back().get();
+}
+
+/**
+ * The bytes reserved by the MemoryPools of the translation unit.
+ */
+std::size_t SyntaxTree::unitPoolBytes() const
+{
+    auto bytes = P->pool_->reservedBytes();
+    for (const auto& pool : P->extraPools_)
+        bytes += pool->reservedBytes();
+    return bytes;
+}
+
 std::unique_ptr<SyntaxTree> SyntaxTree::parseText(SourceText text,
                                                   ParseOptions options,
                                                   const std::string& path,
                                                   SyntaxCategory syntaxCategory)
 {
-    std::unique_ptr<SyntaxTree> tree(new SyntaxTree(text, options, path));
+    std::unique_ptr<SyntaxTree> tree(new SyntaxTree(std::move(text), std::move(options), path));
     tree->buildTree(syntaxCategory);
     return tree;
 }
 
 std::string SyntaxTree::filePath() const
 {
-    return P->path_;
+    return P->fileId_.path();
+}
+
+FileId SyntaxTree::fileId() const
+{
+    return P->fileId_;
 }
 
 const SourceText& SyntaxTree::text() const
@@ -127,7 +187,7 @@ SyntaxNode* SyntaxTree::root() const
 
 bool SyntaxTree::hasTranslationUnitRoot() const
 {
-    return static_cast<bool>(P->rootNode_->asTranslationUnit());
+    return P->rootNode_ && P->rootNode_->asTranslationUnit();
 }
 
 TranslationUnitSyntax* SyntaxTree::translationUnitRoot() const
@@ -139,21 +199,169 @@ TranslationUnitSyntax* SyntaxTree::translationUnitRoot() const
 
 std::vector<Diagnostic> SyntaxTree::diagnostics() const
 {
+    std::lock_guard<std::mutex> lock(P->diagnosticsMutex_);
+    if (!P->pendingDiagnostics_.empty()) {
+        P->diagnostics_.reserve(P->diagnostics_.size() + P->pendingDiagnostics_.size());
+        for (const auto& record : P->pendingDiagnostics_)
+            P->diagnostics_.push_back(renderDiagnostic(record));
+        P->pendingDiagnostics_.clear();
+    }
     return P->diagnostics_;
 }
 
+std::size_t SyntaxTree::diagnosticCount() const
+{
+    std::lock_guard<std::mutex> lock(P->diagnosticsMutex_);
+    return P->diagnostics_.size() + P->pendingDiagnostics_.size();
+}
+
+std::vector<LinePosition> SyntaxTree::linePositions(const std::vector<unsigned int>& offsets) const
+{
+    PSYCHE_ASSERT(std::is_sorted(offsets.begin(), offsets.end()),
+                  return std::vector<LinePosition>(),
+                  "expected sorted offsets");
+
+    const auto& lineStarts = P->text_.lineStarts();
+    const auto& lineDirs = P->lineDirectives_;
+    const auto& expansions = P->expansions_;
+
+    std::vector<LinePosition> positions;
+    positions.reserve(offsets.size());
+
+    // Each cursor is at the first entry not before the current offset,
+    // which is the result of the lower bound searched by computePosition.
+    auto expansionIt = expansions.begin();
+    std::size_t lineIdx = 0;
+    std::size_t lineDirIdx = 0;
+
+    // The text lineno of the line directive in effect.
+    std::size_t curLineDirIdx = lineDirs.size();
+    unsigned int lineDirTextLineno = 0;
+
+    // The column of the previous offset (if in the same line).
+    unsigned int prevLineno = ~0U;
+    unsigned int prevOffset = 0;
+    unsigned int prevColumn = 0;
+
+    for (auto offset : offsets) {
+        while (expansionIt != expansions.end() && expansionIt->first < offset)
+            ++expansionIt;
+        if (expansionIt != expansions.end() && expansionIt->first == offset) {
+            positions.emplace_back(expansionIt->second.first, expansionIt->second.second + 1);
+            continue;
+        }
+
+        while (lineIdx < lineStarts.size() && lineStarts[lineIdx] < offset)
+            ++lineIdx;
+        unsigned int lineno = lineIdx ? lineIdx - 1 : 0;
+
+        unsigned int column = 0;
+        if (offset) {
+            column = lineno == prevLineno
+                    ? prevColumn + computeColumn(prevOffset, offset)
+                    : computeColumn(lineStarts[lineno], offset);
+            prevLineno = lineno;
+            prevOffset = offset;
+            prevColumn = column;
+        }
+
+        while (lineDirIdx < lineDirs.size() && lineDirs[lineDirIdx].offset() < offset)
+            ++lineDirIdx;
+        auto lineDirInEffectIdx = lineDirIdx ? lineDirIdx - 1 : 0;
+        if (lineDirInEffectIdx != curLineDirIdx) {
+            curLineDirIdx = lineDirInEffectIdx;
+            lineDirTextLineno = searchForLineno(lineDirs[curLineDirIdx].offset());
+        }
+        lineno -= lineDirTextLineno + 1;
+        lineno += lineDirs[curLineDirIdx].lineno();
+
+        positions.emplace_back(lineno, column);
+    }
+
+    return positions;
+}
+
 /* Forward calls to the lexed-tokens container */
-void SyntaxTree::addToken(SyntaxToken tk) { P->tokens_.add(tk); }
-SyntaxToken& SyntaxTree::tokenAt(LexedTokens::IndexType tkIdx) { return P->tokens_.tokenAt(tkIdx); }
-const SyntaxToken& SyntaxTree::tokenAt(LexedTokens::IndexType tkIdx) const { return P->tokens_.tokenAt(tkIdx); }
-SyntaxTree::TokenSequenceType::size_type SyntaxTree::tokenCount() { return P->tokens_.count(); }
+void SyntaxTree::addToken(const LexedTokens::Record& tk) { P->tokens_.add(tk); }
+SyntaxToken SyntaxTree::tokenAt(LexedTokens::IndexType tkIdx) const { return SyntaxToken(&P->tokens_, tkIdx); }
+LexedTokens& SyntaxTree::tokens() { return P->tokens_; }
+const LexedTokens& SyntaxTree::tokens() const { return P->tokens_; }
+LexedTokens::SizeType SyntaxTree::tokenCount() const { return P->tokens_.count(); }
 LexedTokens::IndexType SyntaxTree::freeTokenSlot() const { return P->tokens_.freeSlot(); }
 
+void SyntaxTree::releaseTokensBefore(LexedTokens::IndexType tkIdx)
+{
+    P->tokens_.releaseBefore(tkIdx);
+
+    // As with the tokens, compact the comments only when it pays off.
+    const auto offset = P->tokens_.byteOffsetAt(tkIdx);
+    auto it = std::lower_bound(_comments.begin(), _comments.end(), offset,
+                               [] (const LexedTokens::Record& tk, unsigned int offset) {
+                                   return tk.byteOffset_ < offset;
+                               });
+    if (2 * (it - _comments.begin()) >= static_cast<std::ptrdiff_t>(_comments.size()))
+        _comments.erase(_comments.begin(), it);
+}
+
+std::unique_ptr<SyntaxTree> SyntaxTree::streamText(SourceText text,
+                                                   ParseOptions options,
+                                                   const std::string& path,
+                                                   const DeclarationHandler& handler)
+{
+    std::unique_ptr<SyntaxTree> tree(new SyntaxTree(std::move(text), std::move(options), path));
+    Lexer lexer(tree.get());
+    Parser parser(tree.get());
+    parser.parseTranslationUnit_Streamed(&lexer, handler);
+    return tree;
+}
+
+std::unique_ptr<SyntaxTree> SyntaxTree::withChangedText(const TextChange& change,
+                                                        SyntaxCategory syntaxCategory) const
+{
+    auto newTree = [this, &change] () {
+        return std::unique_ptr<SyntaxTree>(new SyntaxTree(P->text_.withChange(change), P->options_, filePath()));
+    };
+
+    // The lexemes are shared (and, so, accumulated across a sequence of text
+    // changes) only while they don't outnumber the tokens by much.
+    static constexpr unsigned int kMinSharedLexemeCnt = 1 << 12;
+    const bool relexable = lexemeCount() <= std::max(kMinSharedLexemeCnt, 2 * tokenCount());
+
+    std::unique_ptr<SyntaxTree> tree;
+    if (relexable) {
+        tree = newTree();
+        tree->P->lexemes_ = P->lexemes_;
+        std::lock_guard<std::mutex> lock(P->lexemes_->mutex_);
+        if (!Lexer(tree.get()).relex(this, change))
+            tree.reset();
+    }
+    if (!tree) {
+        tree = newTree();
+        Lexer(tree.get()).lex();
+    }
+    tree->parseTokens(syntaxCategory);
+    return tree;
+}
+
 void SyntaxTree::buildTree(SyntaxCategory syntaxCat)
+{
+    TokenCache cache(this);
+    if (!cache.load()) {
+        lexText();
+        cache.store();
+    }
+
+    parseTokens(syntaxCat);
+}
+
+void SyntaxTree::lexText()
 {
     Lexer lexer(this);
     lexer.lex();
+}
 
+void SyntaxTree::parseTokens(SyntaxCategory syntaxCat)
+{
 #ifdef DEBUG_LEXED_TOKENS
     std::cout << "\n\n" << P->text_.rawText() << std::endl;
 
@@ -214,6 +422,33 @@ void SyntaxTree::buildTree(SyntaxCategory syntaxCat)
     }
 }
 
+StatementSyntax* SyntaxTree::parseDeferredFunctionBody(const FunctionDefinitionSyntax* funcDef)
+{
+    Parser parser(this);
+    return parser.parseDeferredFunctionBody(funcDef);
+}
+
+/**
+ * The mutex that serializes the parses of the deferred function bodies of
+ * \c this SyntaxTree, which share its pool, its tokens, and the state of its
+ * file scope.
+ */
+std::mutex& SyntaxTree::deferredBodiesMutex() const
+{
+    return P->deferredBodiesMutex_;
+}
+
+/**
+ * The names declared in the file scope, when typedef-names are tracked (see
+ * ParseOptions::trackTypedefNames); they're kept by \c this SyntaxTree, so
+ * that they're known to the parse of a deferred function body, which sees
+ * only those declared before it.
+ */
+SyntaxTree::NameScope& SyntaxTree::fileScopeNames()
+{
+    return P->fileScopeNames_;
+}
+
 void SyntaxTree::createSymbols()
 {
 
@@ -226,45 +461,121 @@ const ParseOptions& SyntaxTree::options() const
 
 const Identifier* SyntaxTree::identifier(const char* s, unsigned size)
 {
-    return P->identifiers_.findOrInsert(s, size);
+    if (P->options_.lexemeInterner())
+        return P->options_.lexemeInterner()->identifier(s, size);
+    return P->lexemes_->identifiers_.findOrInsert(s, size);
 }
 
 const StringLiteral* SyntaxTree::stringLiteral(const char* s, unsigned size)
 {
-    return P->strings_.findOrInsert(s, size);
+    if (P->options_.lexemeInterner())
+        return P->options_.lexemeInterner()->stringLiteral(s, size);
+    return P->lexemes_->strings_.findOrInsert(s, size);
 }
 
 const IntegerConstant* SyntaxTree::integerConstant(const char* s, unsigned int size)
 {
-    return P->integers_.findOrInsert(s, size);
+    if (P->options_.lexemeInterner())
+        return P->options_.lexemeInterner()->integerConstant(s, size);
+    return P->lexemes_->integers_.findOrInsert(s, size);
 }
 
 const FloatingConstant* SyntaxTree::floatingConstant(const char* s, unsigned int size)
 {
-    return P->floatings_.findOrInsert(s, size);
+    if (P->options_.lexemeInterner())
+        return P->options_.lexemeInterner()->floatingConstant(s, size);
+    return P->lexemes_->floatings_.findOrInsert(s, size);
 }
 
 const CharacterConstant* SyntaxTree::characterConstant(const char* s, unsigned int size)
 {
-    return P->characters_.findOrInsert(s, size);
+    if (P->options_.lexemeInterner())
+        return P->options_.lexemeInterner()->characterConstant(s, size);
+    return P->lexemes_->characters_.findOrInsert(s, size);
 }
 
 
-void SyntaxTree::relayLineStart(unsigned int offset)
+unsigned int SyntaxTree::lexemeCount() const
 {
-    P->startOfLineOffsets_.push_back(offset);
+    return P->lexemes_->count();
+}
+
+void SyntaxTree::mergeLexemes(const SyntaxTree* chunkTree, LexemeMap& lexemes)
+{
+    // With an interner, the lexemes of a chunk are already those of the tree.
+    if (P->options_.lexemeInterner())
+        return;
+
+    // Merge in the order of insertion, so that a table ends up as if its
+    // lexemes had been interned while lexing the entire text.
+    auto merge = [&lexemes] (auto& table, const auto& chunkTable) {
+        for (auto lexeme : chunkTable) {
+            lexemes[lexeme] = const_cast<SyntaxLexeme*>(
+                        static_cast<const SyntaxLexeme*>(
+                            table.findOrInsert(lexeme->c_str(), lexeme->size())));
+        }
+    };
+
+    merge(P->lexemes_->identifiers_, chunkTree->P->lexemes_->identifiers_);
+    merge(P->lexemes_->integers_, chunkTree->P->lexemes_->integers_);
+    merge(P->lexemes_->floatings_, chunkTree->P->lexemes_->floatings_);
+    merge(P->lexemes_->characters_, chunkTree->P->lexemes_->characters_);
+    merge(P->lexemes_->strings_, chunkTree->P->lexemes_->strings_);
+}
+
+bool SyntaxTree::isRelexable() const
+{
+    return P->relexable_;
+}
+
+void SyntaxTree::setRelexable(bool yes)
+{
+    P->relexable_ = yes;
 }
 
 void SyntaxTree::relayExpansion(unsigned int offset, std::pair<unsigned int, unsigned int> p)
 {
-    P->expansions_.insert(std::make_pair(offset, p));
+    // Expansions are relayed in the order of the tokens, so they're appended.
+    auto& expansions = P->expansions_;
+    if (expansions.empty() || expansions.back().first < offset) {
+        expansions.emplace_back(offset, p);
+        return;
+    }
+
+    auto it = std::lower_bound(expansions.begin(),
+                               expansions.end(),
+                               offset,
+                               [] (const auto& expansion, auto value) { return expansion.first < value; });
+    if (it->first != offset)
+        expansions.emplace(it, offset, p);
 }
 
 void SyntaxTree::relayLineDirective(unsigned int offset,
                                     unsigned int lineno,
-                                    const std::string& filePath)
+                                    FileId fileId)
+{
+    P->lineDirectives_.emplace_back(lineno, fileId, offset);
+}
+
+FileId SyntaxTree::fileIdOf(const StringLiteral* fileName)
+{
+    auto it = P->lineDirectiveFileIds_.find(fileName);
+    if (it != P->lineDirectiveFileIds_.end())
+        return it->second;
+
+    auto fileId = FileId::of(fileName->c_str());
+    P->lineDirectiveFileIds_.emplace(fileName, fileId);
+    return fileId;
+}
+
+const std::vector<LineDirective>& SyntaxTree::lineDirectives() const
+{
+    return P->lineDirectives_;
+}
+
+const SyntaxTree::ExpansionsTable& SyntaxTree::expansions() const
 {
-    P->lineDirectives_.emplace_back(lineno, filePath, offset);
+    return P->expansions_;
 }
 
 LinePosition SyntaxTree::computePosition(unsigned int offset) const
@@ -272,8 +583,11 @@ LinePosition SyntaxTree::computePosition(unsigned int offset) const
     unsigned int lineno = 0;
     unsigned int column = 0;
 
-    auto it = P->expansions_.find(offset);
-    if (it != P->expansions_.end()) {
+    auto it = std::lower_bound(P->expansions_.begin(),
+                               P->expansions_.end(),
+                               offset,
+                               [] (const auto& expansion, auto value) { return expansion.first < value; });
+    if (it != P->expansions_.end() && it->first == offset) {
         lineno = it->second.first;
         column = it->second.second + 1;
     }
@@ -290,24 +604,44 @@ LinePosition SyntaxTree::computePosition(unsigned int offset) const
     return LinePosition(lineno, column);
 }
 
+LinePosition SyntaxTree::computeTextPosition(unsigned int offset) const
+{
+    const auto& lineStarts = P->text_.lineStarts();
+    auto it = std::upper_bound(lineStarts.begin(), lineStarts.end(), offset);
+    unsigned int lineno = std::distance(lineStarts.begin(), it);
+    return LinePosition(lineno, computeColumn(*(it - 1), offset));
+}
+
+unsigned int SyntaxTree::computeColumn(unsigned int lineStart, unsigned int offset) const
+{
+    if (!P->options_.IsUTF16OffsetsTracked())
+        return offset - lineStart;
+
+    unsigned int units = 0;
+    TextScanner::findAnyOfCountingUTF16(P->text_.c_str() + lineStart,
+                                        P->text_.c_str() + offset,
+                                        '\0', '\0', '\0',
+                                        units);
+    return units;
+}
+
 unsigned int SyntaxTree::searchForLineno(unsigned int offset) const
 {
-    auto it = std::lower_bound(P->startOfLineOffsets_.begin(),
-                               P->startOfLineOffsets_.end(),
-                               offset);
-    if (it == P->startOfLineOffsets_.end())
-        return P->startOfLineOffsets_.size() - 1;
+    const auto& lineStarts = P->text_.lineStarts();
+    auto it = std::lower_bound(lineStarts.begin(), lineStarts.end(), offset);
+    if (it == lineStarts.end())
+        return lineStarts.size() - 1;
 
-    if (it != P->startOfLineOffsets_.begin())
+    if (it != lineStarts.begin())
         --it;
-    return std::distance(P->startOfLineOffsets_.begin(), it);
+    return std::distance(lineStarts.begin(), it);
 }
 
 unsigned int SyntaxTree::searchForColumn(unsigned int offset, unsigned int lineno) const
 {
     if (!offset)
         return 0;
-    return offset - P->startOfLineOffsets_[lineno];
+    return computeColumn(P->text_.lineStarts()[lineno], offset);
 }
 
 LineDirective SyntaxTree::searchForLineDirective(unsigned int offset) const
@@ -322,21 +656,34 @@ LineDirective SyntaxTree::searchForLineDirective(unsigned int offset) const
     return *it;
 }
 
-void SyntaxTree::newDiagnostic(DiagnosticDescriptor descriptor, LexedTokens::IndexType tkIdx)
+void SyntaxTree::newDiagnostic(const DiagnosticSpec& spec,
+                               const DiagnosticArguments& args,
+                               LexedTokens::IndexType tkIdx)
 {
     SyntaxToken tk = tokenAt(tkIdx);
-    LinePosition start = computePosition(tk.charStart());
-    LinePosition end = computePosition(tk.charEnd());
-    FileLinePositionSpan line(P->path_, start, end);
+    DiagnosticRecord record { &spec, args, tk.byteStart(), tk.byteEnd() };
+
+    std::lock_guard<std::mutex> lock(P->diagnosticsMutex_);
+    P->pendingDiagnostics_.push_back(record);
+}
+
+Diagnostic SyntaxTree::renderDiagnostic(const DiagnosticRecord& record) const
+{
+    const auto byteStart = record.byteStart_;
+    LinePosition start = computePosition(byteStart);
+    LinePosition end = computePosition(record.byteEnd_);
+    FileLinePositionSpan line(P->fileId_, start, end);
     std::string snippet;
 
-    auto it = std::lower_bound(P->startOfLineOffsets_.begin(), P->startOfLineOffsets_.end(), tk.charStart());
-    if (it != P->startOfLineOffsets_.begin()) {
+    const auto& lineStarts = P->text_.lineStarts();
+    auto it = std::lower_bound(lineStarts.begin(), lineStarts.end(), byteStart);
+    if (it != lineStarts.begin()) {
         --it;
 
-        auto lineBegIt = P->text_.rawText().begin() + *it;
+        auto rawText = P->text_.rawText();
+        auto lineBegIt = rawText.begin() + *it;
         auto lineCurIt = lineBegIt;
-        while (lineCurIt != P->text_.rawText().end()) {
+        while (lineCurIt != rawText.end()) {
             if (*lineCurIt == '\n')
                 break;
             ++lineCurIt;
@@ -348,5 +695,5 @@ void SyntaxTree::newDiagnostic(DiagnosticDescriptor descriptor, LexedTokens::Ind
         snippet += "\n" + marker + "\n";
     }
 
-    P->diagnostics_.emplace_back(descriptor, Location::create(line), snippet);
+    return Diagnostic(record.spec_->descriptor(record.args_), Location::create(line), std::move(snippet));
 }
@@ -25,6 +25,7 @@
 #include "API.h"
 #include "APIFwds.h"
 
+#include "parser/DiagnosticRecord.h"
 #include "parser/LexedTokens.h"
 #include "parser/LineDirective.h"
 #include "parser/ParseOptions.h"
@@ -34,10 +35,13 @@
 #include "../common/diagnostics/Diagnostic.h"
 #include "../common/infra/Pimpl.h"
 #include "../common/text/SourceText.h"
+#include "../common/text/TextChange.h"
 
 #include <cstdio>
+#include <functional>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <ostream>
 #include <string>
 #include <unordered_map>
@@ -79,17 +83,74 @@ public:
     /**
      * Parse the input \p text, as according to the \p syntaxCategory,
      * in order to build \c this SyntaxTree.
+     *
+     * The \p text is lexed in place (it's not copied) and kept alive by
+     * the SyntaxTree; to parse a file without reading it into memory, see
+     * SourceText::mapFile.
      */
     static std::unique_ptr<SyntaxTree> parseText(SourceText text,
                                                  ParseOptions options = ParseOptions(),
                                                  const std::string& path = "",
                                                  SyntaxCategory syntaxCategory = SyntaxCategory::Unspecified);
 
+    /**
+     * Parse the text of \c this SyntaxTree, as changed by the \p change (whose
+     * span is in bytes), in order to build a new SyntaxTree; the \p syntaxCategory
+     * is as in \c parseText.
+     *
+     * The changed text is relexed incrementally: lexing restarts after the last
+     * token unaffected by the \p change, and stops as soon as the relexed tokens
+     * resynchronize with those of \c this SyntaxTree, which are then reused (with
+     * shifted offsets) up to the end of the text.
+     *
+     * \remark
+     * Only the lexing work is proportional to the \p change (and the tokens it
+     * affects); the rest is proportional to the whole text: the changed text
+     * is a copy (whose line starts are computed anew), the reused tokens are
+     * copied into the new SyntaxTree, and the tokens are parsed from scratch.
+     *
+     * \remark
+     * The new SyntaxTree shares the lexemes of \c this one (those of the reused
+     * tokens), and adds those of the relexed tokens to them; concurrent text
+     * changes of trees that share lexemes are serialized (during lexing). Once
+     * the shared lexemes far outnumber the tokens, the changed text is lexed
+     * in full, with lexemes of its own, so that they're bounded across a long
+     * sequence of changes.
+     */
+    std::unique_ptr<SyntaxTree> withChangedText(const TextChange& change,
+                                                SyntaxCategory syntaxCategory = SyntaxCategory::Unspecified) const;
+
+    /**
+     * The handler of the (external) declarations of a streamed text; the
+     * declaration, its nodes and tokens, are valid only during the call.
+     */
+    using DeclarationHandler = std::function<void (const DeclarationSyntax*)>;
+
+    /**
+     * Parse the input \p text as a \a translation-unit, in streaming mode:
+     * the tokens are lexed on demand, and each external declaration is passed
+     * to the \p handler as soon as it's parsed, after which its tokens and
+     * syntax nodes are released. The memory used doesn't grow with the size
+     * of the \p text, but with that of its largest declaration (lexemes and
+     * diagnostics are still retained).
+     *
+     * The returned SyntaxTree has no root, but has the diagnostics.
+     */
+    static std::unique_ptr<SyntaxTree> streamText(SourceText text,
+                                                  ParseOptions options,
+                                                  const std::string& path,
+                                                  const DeclarationHandler& handler);
+
     /**
      * The path of the file associated to \c this SyntaxTree.
      */
     std::string filePath() const;
 
+    /**
+     * The (interned) identity of the file associated to \c this SyntaxTree.
+     */
+    FileId fileId() const;
+
     /**
      * The SourceText associated to \c this SyntaxTree.
      */
@@ -112,9 +173,36 @@ public:
 
     /**
      * The diagnostics in \c this SyntaxTree.
+     *
+     * \remark
+     * A diagnostic is recorded (as the specification of its ID, a few
+     * arguments, and a token span) when it's reported, and only rendered,
+     * with its descriptor, location, and snippet, upon the first access
+     * through this function.
+     *
+     * \remark
+     * Diagnostics may be reported, and this function called, from multiple
+     * threads (e.g., as deferred function bodies are parsed); the returned
+     * vector is a snapshot of the diagnostics at the time of the call.
      */
     std::vector<Diagnostic> diagnostics() const;
 
+    /**
+     * The count of diagnostics in \c this SyntaxTree (none is rendered).
+     */
+    std::size_t diagnosticCount() const;
+
+    /**
+     * The line positions of the given (byte) \p offsets, which must be sorted
+     * in ascending order; line directives and macro expansions are taken into
+     * consideration, as in the positions of diagnostics.
+     *
+     * The \p offsets are resolved in a single pass over the line, expansion,
+     * and line-directive tables of \c this SyntaxTree; prefer this function
+     * over repeated queries when positions for many tokens are needed.
+     */
+    std::vector<LinePosition> linePositions(const std::vector<unsigned int>& offsets) const;
+
 private:
     SyntaxTree(SourceText text,
                ParseOptions options,
@@ -123,29 +211,52 @@ private:
     DECL_PIMPL(SyntaxTree)
 
     MemoryPool* unitPool() const;
+    MemoryPool* addUnitPool();
+    std::size_t unitPoolBytes() const;
 
-    using TokenSequenceType = std::vector<SyntaxToken>;
     using LineColum = std::pair<unsigned int, unsigned int>;
-    using ExpansionsTable = std::unordered_map<unsigned int, LineColum>;
+    /* The expansions, sorted by the offset of the expanded token */
+    using ExpansionsTable = std::vector<std::pair<unsigned int, LineColum>>;
 
     friend class SyntaxNode;
     friend class SyntaxNodeList;
+    friend class SyntaxToken;
     friend class Lexer;
     friend class Parser;
     friend class Binder;
+    friend class TokenCache;
+    friend class FunctionDefinitionSyntax;
+    friend class SyntaxTreeInternals;
+    friend class TestSyntaxTree;
 
     // TODO: To be removed.
     friend class Unparser;
     friend class SyntaxWriterDOTFormat;
 
     /* Lexed-tokens access and manipulation */
-    void addToken(SyntaxToken tk);
-    SyntaxToken& tokenAt(LexedTokens::IndexType tkIdx);
-    const SyntaxToken& tokenAt(LexedTokens::IndexType tkIdx) const;
-    TokenSequenceType::size_type tokenCount();
+    void addToken(const LexedTokens::Record& tk);
+    SyntaxToken tokenAt(LexedTokens::IndexType tkIdx) const;
+    LexedTokens& tokens();
+    const LexedTokens& tokens() const;
+    LexedTokens::SizeType tokenCount() const;
     LexedTokens::IndexType freeTokenSlot() const;
+    void releaseTokensBefore(LexedTokens::IndexType tkIdx);
 
     void buildTree(SyntaxCategory syntaxCat);
+    void lexText();
+    void parseTokens(SyntaxCategory syntaxCat);
+    StatementSyntax* parseDeferredFunctionBody(const FunctionDefinitionSyntax* funcDef);
+    std::mutex& deferredBodiesMutex() const;
+
+    /* The names of a scope: whether each one is a typedef-name, and where */
+    struct ScopedName
+    {
+        bool isTypedefName_;
+        LexedTokens::IndexType tkIdx_;
+    };
+    using NameScope = std::unordered_map<const SyntaxLexeme*, ScopedName>;
+    NameScope& fileScopeNames();
+
     void createSymbols();
     void typeCheck() {}
     const ParseOptions& options() const;
@@ -156,23 +267,40 @@ private:
     const CharacterConstant* characterConstant(const char* s, unsigned int size);
     const StringLiteral* stringLiteral(const char* s, unsigned size);
 
-    void relayLineStart(unsigned int offset);
+    /* Lexemes of a tree whose text is a chunk of \c this tree's text */
+    using LexemeMap = std::unordered_map<const SyntaxLexeme*, SyntaxLexeme*>;
+    void mergeLexemes(const SyntaxTree* chunkTree, LexemeMap& lexemes);
+    unsigned int lexemeCount() const;
+
+    /* Whether the tokens may be relexed: the lexer neither marked expansions
+       nor reported diagnostics, which a relex doesn't reproduce */
+    bool isRelexable() const;
+    void setRelexable(bool yes);
+
     void relayExpansion(unsigned int offset, std::pair<unsigned, unsigned> p);
-    void relayLineDirective(unsigned int offset, unsigned int lineno, const std::string& filePath);
+    void relayLineDirective(unsigned int offset, unsigned int lineno, FileId fileId);
+    FileId fileIdOf(const StringLiteral* fileName);
+    const std::vector<LineDirective>& lineDirectives() const;
+    const ExpansionsTable& expansions() const;
 
     LinePosition computePosition(unsigned int offset) const;
+    LinePosition computeTextPosition(unsigned int offset) const;
+    unsigned int computeColumn(unsigned int lineStart, unsigned int offset) const;
     unsigned int searchForLineno(unsigned int offset) const;
     unsigned int searchForColumn(unsigned int offset, unsigned int lineno) const;
     LineDirective searchForLineDirective(unsigned int offset) const;
 
-    void newDiagnostic(DiagnosticDescriptor descriptor, LexedTokens::IndexType tkIdx);
+    void newDiagnostic(const DiagnosticSpec& spec,
+                       const DiagnosticArguments& args,
+                       LexedTokens::IndexType tkIdx);
+    Diagnostic renderDiagnostic(const DiagnosticRecord& record) const;
 
     LanguageDialect dialect() const { return dialect_; }
     void setDialect(LanguageDialect dialect) { dialect_ = dialect; }
 
     // TODO: Move to implementaiton.
     LanguageDialect dialect_;
-    std::vector<SyntaxToken> _comments;
+    std::vector<LexedTokens::Record> _comments;
 };
 
 } // C
@@ -0,0 +1,53 @@
+// Copyright (c) 2016/17/18/19/20/21 Leandro T. C. Melo <ltcmelo@gmail.com>
+// Copyright (c) 2008 Roberto Raggi <roberto.raggi@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+
+#include "SyntaxTreeInternals.h"
+
+#include "SyntaxTree.h"
+
+using namespace psy;
+using namespace C;
+
+std::unique_ptr<SyntaxTree> SyntaxTreeInternals::newTree(SourceText text,
+                                                         ParseOptions options,
+                                                         const std::string& path)
+{
+    return std::unique_ptr<SyntaxTree>(new SyntaxTree(std::move(text), std::move(options), path));
+}
+
+void SyntaxTreeInternals::lex(SyntaxTree* tree)
+{
+    tree->lexText();
+}
+
+void SyntaxTreeInternals::parse(SyntaxTree* tree)
+{
+    tree->parseTokens(SyntaxTree::SyntaxCategory::Unspecified);
+}
+
+LexedTokens::SizeType SyntaxTreeInternals::tokenCount(const SyntaxTree* tree)
+{
+    return tree->tokenCount();
+}
+
+std::size_t SyntaxTreeInternals::unitPoolBytes(const SyntaxTree* tree)
+{
+    return tree->unitPoolBytes();
+}
@@ -0,0 +1,83 @@
+// Copyright (c) 2016/17/18/19/20/21 Leandro T. C. Melo <ltcmelo@gmail.com>
+// Copyright (c) 2008 Roberto Raggi <roberto.raggi@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+
+#ifndef PSYCHE_C_SYNTAX_TREE_INTERNALS_H__
+#define PSYCHE_C_SYNTAX_TREE_INTERNALS_H__
+
+#include "API.h"
+#include "APIFwds.h"
+
+#include "parser/LexedTokens.h"
+#include "parser/ParseOptions.h"
+
+#include "../common/text/SourceText.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace psy {
+namespace C {
+
+/**
+ * \brief The SyntaxTreeInternals class.
+ *
+ * Access to the phases in which a SyntaxTree is built (lexing and parsing),
+ * one at a time, and to some of its internal figures; for tools, such as
+ * benchmarks, that measure them separately.
+ *
+ * \attention
+ * This is not part of the API; prefer SyntaxTree::parseText.
+ */
+class PSY_C_API SyntaxTreeInternals
+{
+public:
+    /**
+     * Create a SyntaxTree for the \p text, yet to be lexed and parsed.
+     */
+    static std::unique_ptr<SyntaxTree> newTree(SourceText text,
+                                               ParseOptions options,
+                                               const std::string& path);
+
+    /**
+     * Lex the text of the \p tree (no token cache is involved).
+     */
+    static void lex(SyntaxTree* tree);
+
+    /**
+     * Parse the tokens of the \p tree, as a \a translation-unit.
+     */
+    static void parse(SyntaxTree* tree);
+
+    /**
+     * The count of tokens of the \p tree (including the initial marker).
+     */
+    static LexedTokens::SizeType tokenCount(const SyntaxTree* tree);
+
+    /**
+     * The bytes reserved by the memory pool of the \p tree.
+     */
+    static std::size_t unitPoolBytes(const SyntaxTree* tree);
+};
+
+} // C
+} // psy
+
+#endif
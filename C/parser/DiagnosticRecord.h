@@ -0,0 +1,82 @@
+// Copyright (c) 2016/17/18/19/20/21 Leandro T. C. Melo <ltcmelo@gmail.com>
+// Copyright (c) 2008 Roberto Raggi <roberto.raggi@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PSYCHE_C_DIAGNOSTIC_RECORD_H__
+#define PSYCHE_C_DIAGNOSTIC_RECORD_H__
+
+#include "API.h"
+
+#include "../common/diagnostics/DiagnosticDescriptor.h"
+#include "../common/diagnostics/DiagnosticSeverity.h"
+
+#include <cstdint>
+#include <string>
+
+namespace psy {
+namespace C {
+
+/**
+ * The arguments of a reported diagnostic, from which its description is
+ * composed when it's rendered. The texts are either static or owned by the
+ * tree (the lexeme of a token), so that a record is cheap to create.
+ */
+struct PSY_C_API DiagnosticArguments
+{
+    static constexpr unsigned int kMaxTkKinds = 4;
+
+    const char* tkText_ = nullptr;
+    const char* text_ = nullptr;
+    std::uint16_t tkKinds_[kMaxTkKinds] = {};
+    std::uint8_t tkKindCnt_ = 0;
+    std::uint8_t value_ = 0;
+};
+
+/**
+ * The (static) specification of the diagnostics of an ID: its severity is
+ * stated only here, and consulted both by the filter of reported diagnostics
+ * and by the descriptor.
+ */
+struct PSY_C_API DiagnosticSpec
+{
+    const char* id_;
+    const char* title_;
+    DiagnosticSeverity severity_;
+    std::string (*describe_)(const DiagnosticArguments& args);
+
+    DiagnosticDescriptor descriptor(const DiagnosticArguments& args) const;
+};
+
+/**
+ * A diagnostic as reported (but not yet rendered): its specification and
+ * arguments, and the byte span of the token at which it was reported.
+ */
+struct PSY_C_API DiagnosticRecord
+{
+    const DiagnosticSpec* spec_;
+    DiagnosticArguments args_;
+    unsigned int byteStart_;
+    unsigned int byteEnd_;
+};
+
+} // C
+} // psy
+
+#endif
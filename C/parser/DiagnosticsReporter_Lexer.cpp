@@ -19,25 +19,44 @@
 // THE SOFTWARE.
 
 #include "Lexer.h"
+#include "DiagnosticRecord.h"
 
 #include "SyntaxTree.h"
 
 #include "../common/diagnostics/Diagnostic.h"
 
+#include <string>
+
 using namespace psy;
 using namespace C;
 
-const std::string Lexer::DiagnosticsReporter::ID_of_IncompatibleLanguageDialect = "Lexer-001";
+namespace {
+
+const DiagnosticSpec kIncompatibleLanguageDialect {
+    "Lexer-001",
+    "Incompatible language dialect",
+    DiagnosticSeverity::Warning,
+    [] (const DiagnosticArguments& args) {
+        return std::string(args.text_)
+                + " is available in "
+                + to_string(static_cast<LanguageDialect::Std>(args.value_));
+    }
+};
+
+} // anonymous
+
+const std::string Lexer::DiagnosticsReporter::ID_of_IncompatibleLanguageDialect = kIncompatibleLanguageDialect.id_;
 
-void Lexer::DiagnosticsReporter::IncompatibleLanguageDialect(
-        const std::string& feature,
-        LanguageDialect::Std expectedStd)
+void Lexer::DiagnosticsReporter::IncompatibleLanguageDialect(const char* feature,
+                                                             LanguageDialect::Std expectedStd)
 {
-    DiagnosticDescriptor descriptor(ID_of_IncompatibleLanguageDialect,
-                                    "Incompatible language dialect",
-                                    feature + " is available in " + to_string(expectedStd),
-                                    DiagnosticSeverity::Warning,
-                                    DiagnosticCategory::Syntax);
+    const auto& spec = kIncompatibleLanguageDialect;
+    if (!lexer_->tree_->options().isDiagnosticReported(spec.id_, spec.severity_))
+        return;
 
-    lexer_->tree_->newDiagnostic(descriptor, lexer_->tree_->freeTokenSlot());
+    DiagnosticArguments args;
+    args.text_ = feature;
+    args.value_ = static_cast<std::uint8_t>(expectedStd);
+    lexer_->tree_->newDiagnostic(spec, args, lexer_->tree_->freeTokenSlot());
+    lexer_->tree_->setRelexable(false);
 }
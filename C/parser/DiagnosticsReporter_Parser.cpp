@@ -20,65 +20,24 @@
 
 #include "Parser.h"
 
-using namespace psy;
-using namespace C;
+#include "common/infra/PsycheAssert.h"
 
-/* General */
-const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFeature = "Parser-000";
+#include <initializer_list>
+#include <string>
 
-/* Terminal */
-const std::string Parser::DiagnosticsReporter::ID_of_ExpectedToken = "Parser-101";
-const std::string Parser::DiagnosticsReporter::ID_of_ExpectedTokenWithin = "Parser-102";
-const std::string Parser::DiagnosticsReporter::ID_of_ExpectedTokenOfCategoryConstant = "Parser-104";
-const std::string Parser::DiagnosticsReporter::ID_of_ExpectedTokenOfCategoryStringLiteral = "Parser-105";
-const std::string Parser::DiagnosticsReporter::ID_of_ExpectedTokenOfCategoryIdentifier = "Parser-106";
+using namespace psy;
+using namespace C;
 
-/* Non-terminal */
-const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFIRSTofExpression = "Parser-200-6.5";
-const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFIRSTofEnumerationConstant= "Parser-201-6.7.2.2";
-const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFIRSTofDirectDeclarator = "Parser--202-6.7.6";
-const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFIRSTofSpecifierQualifier = "Parser-203-6.7.2.1";
-const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFOLLOWofDesignatedInitializer = "Parser-204-6.7.9";
-const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFOLLOWofDeclarator = "Parser-205-6.7.6";
-const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFOLLOWofInitializedDeclarator = "Parser-206";
-const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFOLLOWofStructOrUnionOrEnum = "Parser-207-6.7.2.1";
-const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFOLLOWofEnum = "Parser-208-6.7.2.1";
+namespace {
 
-/* Detailed */
-const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFieldName = "Parser-300-6.5.2";
-const std::string Parser::DiagnosticsReporter::ID_of_ExpectedBraceEnclosedInitializerList = "Parser-301-6.7.9";
-const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFieldDesignator = "Parser-302-6.7.9";
-const std::string Parser::DiagnosticsReporter::ID_of_UnexpectedInitializerOfDeclarator = "Parser-303-6.7.9";
-const std::string Parser::DiagnosticsReporter::ID_of_UnexpectedStaticOrTypeQualifierInArrayDeclarator = "Parser-304-6.7.6";
-const std::string Parser::DiagnosticsReporter::ID_of_UnexpectedPointerInArrayDeclarator = "Parser-305-6.7.6";
-const std::string Parser::DiagnosticsReporter::ID_of_ExpectedNamedParameterBeforeEllipsis = "Parser-306-6.7.6.3";
-const std::string Parser::DiagnosticsReporter::ID_of_ExpectedTypeSpecifier = "Parser-307-6.7";
-const std::string Parser::DiagnosticsReporter::ID_of_UnexpectedCaseLabelOutsideSwitch = "Parser-308-6.8.1-2";
-const std::string Parser::DiagnosticsReporter::ID_of_UnexpectedDefaultLabelOutsideSwitch = "Parser-309-6.8.1-2";
-const std::string Parser::DiagnosticsReporter::ID_of_UnexpectedContinueOutsideLoop = "Parser-310-6.8.6.2-1";
-const std::string Parser::DiagnosticsReporter::ID_of_UnexpectedBreakOutsideSwitchOrLoop = "Parser-311-6.8.6.3-1";
-const std::string Parser::DiagnosticsReporter::ID_of_UnexpectedGNUExtensionFlag = "Parser-312-GNU";
-
-
-std::string Parser::DiagnosticsReporter::joinTokenNames(const std::vector<SyntaxKind>& validTkKinds)
+std::string joinTokenNames(const std::uint16_t* tkKinds, unsigned int tkKindCnt)
 {
     std::string s;
-    if (!validTkKinds.empty()) {
-        auto tkK = validTkKinds.front();
-        auto tkCat = SyntaxToken::category(tkK);
-        if (tkCat == SyntaxToken::Category::Keywords
-                || tkCat == SyntaxToken::Category::Punctuators)
-            s += "`";
-        s += to_string(tkK);
-        if (tkCat == SyntaxToken::Category::Keywords
-                || tkCat == SyntaxToken::Category::Punctuators)
-            s += "'";
-    }
-
-    for (std::vector<int>::size_type i = 1; i < validTkKinds.size(); ++i) {
-        auto tkK = validTkKinds[i];
+    for (auto i = 0U; i < tkKindCnt; ++i) {
+        auto tkK = static_cast<SyntaxKind>(tkKinds[i]);
         auto tkCat = SyntaxToken::category(tkK);
-        s += " or ";
+        if (i)
+            s += " or ";
         if (tkCat == SyntaxToken::Category::Keywords
                 || tkCat == SyntaxToken::Category::Punctuators)
             s += "`";
@@ -92,329 +51,494 @@ std::string Parser::DiagnosticsReporter::joinTokenNames(const std::vector<Syntax
     return s;
 }
 
-void Parser::DiagnosticsReporter::diagnose(DiagnosticDescriptor&& desc)
+std::string joinTokenNames(std::initializer_list<SyntaxKind> tkKinds)
 {
-    if (!parser_->inBactrackingMode())
-        parser_->tree_->newDiagnostic(desc, parser_->curTkIdx_);
-};
-
-/* Generic */
+    std::uint16_t rawTkKinds[DiagnosticArguments::kMaxTkKinds];
+    unsigned int tkKindCnt = 0;
+    for (auto tkK : tkKinds)
+        rawTkKinds[tkKindCnt++] = tkK;
+    return joinTokenNames(rawTkKinds, tkKindCnt);
+}
 
-void Parser::DiagnosticsReporter::ExpectedFeature(const std::string& name)
+std::string got(const DiagnosticArguments& args)
 {
-    diagnose(DiagnosticDescriptor(ID_of_ExpectedFeature,
-                                  "[[unexpected extension or C dialect]]",
-                                  name + " is either an extension or unsupported in this dialect",
-                                  DiagnosticSeverity::Warning,
-                                  DiagnosticCategory::Syntax));
+    return std::string("got `") + args.tkText_ + "'";
 }
 
-void Parser::DiagnosticsReporter::ExpectedToken(SyntaxKind tkK)
+/*
+ * The specifications of the diagnostics, whose descriptions are composed
+ * only when they're rendered.
+ */
+
+/* General */
+const DiagnosticSpec kExpectedFeature {
+    "Parser-000",
+    "[[unexpected extension or C dialect]]",
+    DiagnosticSeverity::Warning,
+    [] (const DiagnosticArguments& args) {
+        return std::string(args.text_) + " is either an extension or unsupported in this dialect";
+    }
+};
+
+/* Terminal */
+const DiagnosticSpec kExpectedToken {
+    "Parser-101",
+    "[[expected token]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments& args) {
+        return "expected `"
+                + to_string(static_cast<SyntaxKind>(args.tkKinds_[0]))
+                + "', " + got(args);
+    }
+};
+
+const DiagnosticSpec kExpectedTokenWithin {
+    "Parser-102",
+    "[[expected one of tokens]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments& args) {
+        return "expected "
+                + joinTokenNames(args.tkKinds_, args.tkKindCnt_)
+                + ", " + got(args);
+    }
+};
+
+std::string describeExpectedTokenOfCategory(SyntaxToken::Category category,
+                                            const DiagnosticArguments& args)
 {
-    auto s = "expected `"
-            + to_string(tkK)
-            + "', got `"
-            + parser_->peek().valueText_c_str()
-            + "'";
-
-    diagnose(DiagnosticDescriptor(ID_of_ExpectedToken,
-                                  "[[expected token]]",
-                                  s,
-                                  DiagnosticSeverity::Error,
-                                  DiagnosticCategory::Syntax));
+    return "expected " + to_string(category) + " " + got(args);
 }
 
-void Parser::DiagnosticsReporter::ExpectedTokenWithin(const std::vector<SyntaxKind>& validTkKinds)
+const DiagnosticSpec kExpectedTokenOfCategoryConstant {
+    "Parser-104",
+    "[[expected token of category]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments& args) {
+        return describeExpectedTokenOfCategory(SyntaxToken::Category::Constants, args);
+    }
+};
+
+const DiagnosticSpec kExpectedTokenOfCategoryStringLiteral {
+    "Parser-105",
+    "[[expected token of category]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments& args) {
+        return describeExpectedTokenOfCategory(SyntaxToken::Category::StringLiterals, args);
+    }
+};
+
+const DiagnosticSpec kExpectedTokenOfCategoryIdentifier {
+    "Parser-106",
+    "[[expected token of category]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments& args) {
+        return describeExpectedTokenOfCategory(SyntaxToken::Category::Constants, args);
+    }
+};
+
+/* Non-terminal */
+const DiagnosticSpec kExpectedFIRSTofExpression {
+    "Parser-200-6.5",
+    "[[expected FIRST of]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments& args) {
+        return "expected expression " + got(args);
+    }
+};
+
+const DiagnosticSpec kExpectedFIRSTofEnumerationConstant {
+    "Parser-201-6.7.2.2",
+    "[[expected FIRST of]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments& args) {
+        return "expected enumeration-constant " + got(args);
+    }
+};
+
+const DiagnosticSpec kExpectedFIRSTofDirectDeclarator {
+    "Parser--202-6.7.6",
+    "[[unexpected FIRST of direct-declarator]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments& args) {
+        return "expected "
+                + joinTokenNames({ IdentifierToken, OpenParenToken })
+                + "starting direct-declarator, " + got(args);
+    }
+};
+
+const DiagnosticSpec kExpectedFIRSTofSpecifierQualifier {
+    "Parser-203-6.7.2.1",
+    "[[unexpected FIRST of specifier-qualifier-list]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments& args) {
+        return "expected specifier-qualifier-list, " + got(args);
+    }
+};
+
+const DiagnosticSpec kExpectedFOLLOWofDesignatedInitializer {
+    "Parser-204-6.7.9",
+    "[[obsolete array designator syntax]]",
+    DiagnosticSeverity::Warning,
+    [] (const DiagnosticArguments&) {
+        return std::string("obsolete array designator without `='");
+    }
+};
+
+const DiagnosticSpec kExpectedFOLLOWofDeclarator {
+    "Parser-205-6.7.6",
+    "[[unexpected FOLLOW of declarator]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments& args) {
+        return "expected "
+                + joinTokenNames({ CommaToken, SemicolonToken, EqualsToken })
+                + "after declarator, " + got(args);
+    }
+};
+
+const DiagnosticSpec kExpectedFOLLOWofInitializedDeclarator {
+    "Parser-206",
+    "[[unexpected FOLLOW of initialized declarator]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments& args) {
+        return "expected "
+                + joinTokenNames({ CommaToken, SemicolonToken })
+                + "after initialized declarator, " + got(args);
+    }
+};
+
+const DiagnosticSpec kExpectedFOLLOWofStructOrUnionOrEnum {
+    "Parser-207-6.7.2.1",
+    "[[unexpected struct-or-union or enum FOLLOW]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments& args) {
+        return "expected "
+                + joinTokenNames({ IdentifierToken, OpenBraceToken })
+                + "following struct-or-union or enum, " + got(args);
+    }
+};
+
+/* Detailed */
+const DiagnosticSpec kExpectedFieldName {
+    "Parser-300-6.5.2",
+    "[[expected field name]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments& args) {
+        return "expected field name, " + got(args);
+    }
+};
+
+const DiagnosticSpec kExpectedBraceEnclosedInitializerList {
+    "Parser-301-6.7.9",
+    "[[unexpected empty brace-enclosed initializer]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments&) {
+        return std::string("ISO C forbids empty initializer braces");
+    }
+};
+
+const DiagnosticSpec kExpectedFieldDesignator {
+    "Parser-302-6.7.9",
+    "[[expected field designator]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments& args) {
+        return "expected field designator, " + got(args);
+    }
+};
+
+const DiagnosticSpec kUnexpectedInitializerOfDeclarator {
+    "Parser-303-6.7.9",
+    "[[unexpected initializer for declarator]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments&) {
+        return std::string("declarator may not be initialized");
+    }
+};
+
+const DiagnosticSpec kUnexpectedStaticOrTypeQualifierInArrayDeclarator {
+    "Parser-304-6.7.6",
+    "[[unexpected static or type qualifier in array declarator]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments&) {
+        return std::string("`static' and type-qualifiers are only allowed in array declarators "
+                           "within function parameters");
+    }
+};
+
+const DiagnosticSpec kUnexpectedPointerInArrayDeclarator {
+    "Parser-305-6.7.6",
+    "[[unexpected pointer in array declarator]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments&) {
+        return std::string("`*' is only allowed in array declarators "
+                           "within function parameters");
+    }
+};
+
+const DiagnosticSpec kExpectedNamedParameterBeforeEllipsis {
+    "Parser-306-6.7.6.3",
+    "[[unexpected ellipsis before named parameter]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments&) {
+        return std::string("ISO C requires a named parameter before `...'");
+    }
+};
+
+const DiagnosticSpec kExpectedTypeSpecifier {
+    "Parser-307-6.7",
+    "[[declaration without type specifier]]",
+    DiagnosticSeverity::Warning,
+    [] (const DiagnosticArguments&) {
+        return std::string("missing type specifier, assume `int'");
+    }
+};
+
+const DiagnosticSpec kUnexpectedCaseLabelOutsideSwitch {
+    "Parser-308-6.8.1-2",
+    "[[case label outside switch-statement]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments&) {
+        return std::string("`case' label not within a switch");
+    }
+};
+
+const DiagnosticSpec kUnexpectedDefaultLabelOutsideSwitch {
+    "Parser-309-6.8.1-2",
+    "[[default label outside switch-statement]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments&) {
+        return std::string("`default' label not within a switch");
+    }
+};
+
+const DiagnosticSpec kUnexpectedContinueOutsideLoop {
+    "Parser-310-6.8.6.2-1",
+    "[[continue outside iteration-statement]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments&) {
+        return std::string("`continue' not within a loop");
+    }
+};
+
+const DiagnosticSpec kUnexpectedBreakOutsideSwitchOrLoop {
+    "Parser-311-6.8.6.3-1",
+    "[[break outside iteration- or switch-statement]]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments&) {
+        return std::string("`break' not within a loop or switch");
+    }
+};
+
+const DiagnosticSpec kUnexpectedGNUExtensionFlag {
+    "Parser-312-GNU",
+    "[[unexpected `__extension__']]",
+    DiagnosticSeverity::Error,
+    [] (const DiagnosticArguments&) {
+        return std::string("unrecognized `__extension__'");
+    }
+};
+
+} // anonymous
+
+/* General */
+const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFeature = kExpectedFeature.id_;
+
+/* Terminal */
+const std::string Parser::DiagnosticsReporter::ID_of_ExpectedToken = kExpectedToken.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_ExpectedTokenWithin = kExpectedTokenWithin.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_ExpectedTokenOfCategoryConstant = kExpectedTokenOfCategoryConstant.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_ExpectedTokenOfCategoryStringLiteral = kExpectedTokenOfCategoryStringLiteral.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_ExpectedTokenOfCategoryIdentifier = kExpectedTokenOfCategoryIdentifier.id_;
+
+/* Non-terminal */
+const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFIRSTofExpression = kExpectedFIRSTofExpression.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFIRSTofEnumerationConstant = kExpectedFIRSTofEnumerationConstant.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFIRSTofDirectDeclarator = kExpectedFIRSTofDirectDeclarator.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFIRSTofSpecifierQualifier = kExpectedFIRSTofSpecifierQualifier.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFOLLOWofDesignatedInitializer = kExpectedFOLLOWofDesignatedInitializer.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFOLLOWofDeclarator = kExpectedFOLLOWofDeclarator.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFOLLOWofInitializedDeclarator = kExpectedFOLLOWofInitializedDeclarator.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFOLLOWofStructOrUnionOrEnum = kExpectedFOLLOWofStructOrUnionOrEnum.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFOLLOWofEnum = "Parser-208-6.7.2.1";
+
+/* Detailed */
+const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFieldName = kExpectedFieldName.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_ExpectedBraceEnclosedInitializerList = kExpectedBraceEnclosedInitializerList.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_ExpectedFieldDesignator = kExpectedFieldDesignator.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_UnexpectedInitializerOfDeclarator = kUnexpectedInitializerOfDeclarator.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_UnexpectedStaticOrTypeQualifierInArrayDeclarator = kUnexpectedStaticOrTypeQualifierInArrayDeclarator.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_UnexpectedPointerInArrayDeclarator = kUnexpectedPointerInArrayDeclarator.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_ExpectedNamedParameterBeforeEllipsis = kExpectedNamedParameterBeforeEllipsis.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_ExpectedTypeSpecifier = kExpectedTypeSpecifier.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_UnexpectedCaseLabelOutsideSwitch = kUnexpectedCaseLabelOutsideSwitch.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_UnexpectedDefaultLabelOutsideSwitch = kUnexpectedDefaultLabelOutsideSwitch.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_UnexpectedContinueOutsideLoop = kUnexpectedContinueOutsideLoop.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_UnexpectedBreakOutsideSwitchOrLoop = kUnexpectedBreakOutsideSwitchOrLoop.id_;
+const std::string Parser::DiagnosticsReporter::ID_of_UnexpectedGNUExtensionFlag = kUnexpectedGNUExtensionFlag.id_;
+
+
+void Parser::DiagnosticsReporter::diagnose(const DiagnosticSpec& spec, DiagnosticArguments args)
 {
-    std::string s = "expected "
-            + joinTokenNames(validTkKinds)
-            + ", got `"
-            + parser_->peek().valueText()
-            + "'";
+    if (parser_->inBactrackingMode()) {
+        ++parser_->suppressedDiagnosticCnt_;
+        return;
+    }
+    if (!parser_->tree_->options().isDiagnosticReported(spec.id_, spec.severity_))
+        return;
+
+    args.tkText_ = parser_->peek().valueText_c_str();
+    if (parser_->heldDiagnostics_)
+        parser_->heldDiagnostics_->push_back({ &spec, args, parser_->curTkIdx_ });
+    else
+        parser_->tree_->newDiagnostic(spec, args, parser_->curTkIdx_);
+};
+
+/* Generic */
 
-    diagnose(DiagnosticDescriptor(ID_of_ExpectedTokenWithin,
-                                  "[[expected one of tokens]]",
-                                  s,
-                                  DiagnosticSeverity::Error,
-                                  DiagnosticCategory::Syntax));
+void Parser::DiagnosticsReporter::ExpectedFeature(const char* name)
+{
+    DiagnosticArguments args;
+    args.text_ = name;
+    diagnose(kExpectedFeature, args);
 }
 
-void Parser::DiagnosticsReporter::ExpectedTokenOfCategory(SyntaxToken::Category category,
-                                                          const std::string& id)
+void Parser::DiagnosticsReporter::ExpectedToken(SyntaxKind tkK)
 {
-    std::string s = "expected "
-                + to_string(category)
-                + " got `"
-                + parser_->peek().valueText() + "'";
+    DiagnosticArguments args;
+    args.tkKinds_[0] = tkK;
+    args.tkKindCnt_ = 1;
+    diagnose(kExpectedToken, args);
+}
 
-    diagnose(DiagnosticDescriptor(id,
-                                  "[[expected token of category]]",
-                                  s,
-                                  DiagnosticSeverity::Error,
-                                  DiagnosticCategory::Syntax));
+void Parser::DiagnosticsReporter::ExpectedTokenWithin(std::initializer_list<SyntaxKind> validTkKinds)
+{
+    PSYCHE_ASSERT(validTkKinds.size() <= DiagnosticArguments::kMaxTkKinds,
+                  return,
+                  "too many token kinds");
+
+    DiagnosticArguments args;
+    for (auto tkK : validTkKinds)
+        args.tkKinds_[args.tkKindCnt_++] = tkK;
+    diagnose(kExpectedTokenWithin, args);
 }
 
 void Parser::DiagnosticsReporter::ExpectedTokenOfCategoryIdentifier()
 {
-    ExpectedTokenOfCategory(SyntaxToken::Category::Constants, ID_of_ExpectedTokenOfCategoryIdentifier);
+    diagnose(kExpectedTokenOfCategoryIdentifier);
 }
 
 void Parser::DiagnosticsReporter::ExpectedTokenOfCategoryConstant()
 {
-    ExpectedTokenOfCategory(SyntaxToken::Category::Constants, ID_of_ExpectedTokenOfCategoryConstant);
+    diagnose(kExpectedTokenOfCategoryConstant);
 }
 
 void Parser::DiagnosticsReporter::ExpectedTokenOfCategoryStringLiteral()
 {
-    ExpectedTokenOfCategory(SyntaxToken::Category::StringLiterals, ID_of_ExpectedTokenOfCategoryStringLiteral);
+    diagnose(kExpectedTokenOfCategoryStringLiteral);
 }
 
 /* Expressions, declarations, and statements */
 
-void Parser::DiagnosticsReporter::ExpectedFIRSTof(const std::string& rule,
-                                                  const std::string& id)
-{
-    std::string s = "expected "
-                + rule
-                + " got `"
-                + parser_->peek().valueText() + "'";
-
-    diagnose(DiagnosticDescriptor(id,
-                                  "[[expected FIRST of]]",
-                                  s,
-                                  DiagnosticSeverity::Error,
-                                  DiagnosticCategory::Syntax));
-
-}
-
 void Parser::DiagnosticsReporter::ExpectedFIRSTofExpression()
 {
-    return ExpectedFIRSTof("expression", ID_of_ExpectedFIRSTofExpression);
+    diagnose(kExpectedFIRSTofExpression);
 }
 
 void Parser::DiagnosticsReporter::ExpectedFIRSTofEnumerationConstant()
 {
-    return ExpectedFIRSTof("enumeration-constant", ID_of_ExpectedFIRSTofEnumerationConstant);
+    diagnose(kExpectedFIRSTofEnumerationConstant);
 }
 
 void Parser::DiagnosticsReporter::ExpectedFieldName()
 {
-    auto s = "expected field name, got `"
-           + parser_->peek().valueText()
-           + "'";
-
-    diagnose(DiagnosticDescriptor(ID_of_ExpectedFieldName,
-                                  "[[expected field name]]",
-                                  s,
-                                  DiagnosticSeverity::Error,
-                                  DiagnosticCategory::Syntax));
+    diagnose(kExpectedFieldName);
 }
 
 void Parser::DiagnosticsReporter::ExpectedBraceEnclosedInitializerList()
 {
-    diagnose(DiagnosticDescriptor(ID_of_ExpectedBraceEnclosedInitializerList,
-                                  "[[unexpected empty brace-enclosed initializer]]",
-                                  "ISO C forbids empty initializer braces",
-                                  DiagnosticSeverity::Error,
-                                  DiagnosticCategory::Syntax));
+    diagnose(kExpectedBraceEnclosedInitializerList);
 }
 
 void Parser::DiagnosticsReporter::ExpectedFieldDesignator()
 {
-    auto s = "expected field designator, got `"
-           + parser_->peek().valueText()
-           + "'";
-
-    diagnose(DiagnosticDescriptor(ID_of_ExpectedFieldDesignator,
-                                  "[[expected field designator]]",
-                                  s,
-                                  DiagnosticSeverity::Error,
-                                  DiagnosticCategory::Syntax));
+    diagnose(kExpectedFieldDesignator);
 }
 
 void Parser::DiagnosticsReporter::UnexpectedInitializerOfDeclarator()
 {
-    diagnose(DiagnosticDescriptor(ID_of_UnexpectedInitializerOfDeclarator,
-                                  "[[unexpected initializer for declarator]]",
-                                  "declarator may not be initialized",
-                                  DiagnosticSeverity::Error,
-                                  DiagnosticCategory::Syntax));
+    diagnose(kUnexpectedInitializerOfDeclarator);
 }
 
 void Parser::DiagnosticsReporter::ExpectedFOLLOWofDesignatedInitializer()
 {
-    diagnose(DiagnosticDescriptor(ID_of_ExpectedFOLLOWofDesignatedInitializer,
-                                  "[[obsolete array designator syntax]]",
-                                  "obsolete array designator without `='",
-                                  DiagnosticSeverity::Warning,
-                                  DiagnosticCategory::Syntax));
+    diagnose(kExpectedFOLLOWofDesignatedInitializer);
 }
 
 void Parser::DiagnosticsReporter::UnexpectedStaticOrTypeQualifiersInArrayDeclarator()
 {
-    diagnose(DiagnosticDescriptor(ID_of_UnexpectedStaticOrTypeQualifierInArrayDeclarator,
-                                  "[[unexpected static or type qualifier in array declarator]]",
-                                  "`static' and type-qualifiers are only allowed in array declarators "
-                                  "within function parameters",
-                                  DiagnosticSeverity::Error,
-                                  DiagnosticCategory::Syntax));
+    diagnose(kUnexpectedStaticOrTypeQualifierInArrayDeclarator);
 }
 
 void Parser::DiagnosticsReporter::UnexpectedPointerInArrayDeclarator()
 {
-    diagnose(DiagnosticDescriptor(ID_of_UnexpectedPointerInArrayDeclarator,
-                                  "[[unexpected pointer in array declarator]]",
-                                  "`*' is only allowed in array declarators "
-                                  "within function parameters",
-                                  DiagnosticSeverity::Error,
-                                  DiagnosticCategory::Syntax));
+    diagnose(kUnexpectedPointerInArrayDeclarator);
 }
 
 void Parser::DiagnosticsReporter::ExpectedFOLLOWofDeclarator()
 {
-    auto validTkKinds = { CommaToken,
-                          SemicolonToken,
-                          EqualsToken };
-
-    std::string s = "expected "
-                + joinTokenNames(validTkKinds)
-                + "after declarator, got `"
-                + parser_->peek().valueText_c_str()
-                + "'";
-
-    diagnose(DiagnosticDescriptor(ID_of_ExpectedFOLLOWofDeclarator,
-                                  "[[unexpected FOLLOW of declarator]]",
-                                  s,
-                                  DiagnosticSeverity::Error,
-                                  DiagnosticCategory::Syntax));
+    diagnose(kExpectedFOLLOWofDeclarator);
 }
 
 void Parser::DiagnosticsReporter::ExpectedFOLLOWofInitializedDeclarator()
 {
-    auto validTkKinds = { CommaToken,
-                          SemicolonToken };
-
-    std::string s = "expected "
-                + joinTokenNames(validTkKinds)
-                + "after initialized declarator, got `"
-                + parser_->peek().valueText_c_str()
-                + "'";
-
-    diagnose(DiagnosticDescriptor(ID_of_ExpectedFOLLOWofInitializedDeclarator,
-                                  "[[unexpected FOLLOW of initialized declarator]]",
-                                  s,
-                                  DiagnosticSeverity::Error,
-                                  DiagnosticCategory::Syntax));
+    diagnose(kExpectedFOLLOWofInitializedDeclarator);
 }
 
 void Parser::DiagnosticsReporter::ExpectedFIRSTofDirectDeclarator()
 {
-    auto validTkKinds = { IdentifierToken,
-                          OpenParenToken };
-
-    std::string s = "expected "
-                + joinTokenNames(validTkKinds)
-                + "starting direct-declarator, got `"
-                + parser_->peek().valueText_c_str()
-                + "'";
-
-    diagnose(DiagnosticDescriptor(ID_of_ExpectedFIRSTofDirectDeclarator,
-                                  "[[unexpected FIRST of direct-declarator]]",
-                                  s,
-                                  DiagnosticSeverity::Error,
-                                  DiagnosticCategory::Syntax));
+    diagnose(kExpectedFIRSTofDirectDeclarator);
 }
 
 void Parser::DiagnosticsReporter::ExpectedFIRSTofSpecifierQualifier()
 {
-    std::string s = "expected specifier-qualifier-list, got `"
-                + parser_->peek().valueText()
-                + "'";
-
-    diagnose(DiagnosticDescriptor(ID_of_ExpectedFIRSTofSpecifierQualifier,
-                                  "[[unexpected FIRST of specifier-qualifier-list]]",
-                                  s,
-                                  DiagnosticSeverity::Error,
-                                  DiagnosticCategory::Syntax));
+    diagnose(kExpectedFIRSTofSpecifierQualifier);
 }
 
 void Parser::DiagnosticsReporter::ExpectedFOLLOWofStructOrUnionOrEnum()
 {
-    auto validTkKinds = { IdentifierToken,
-                          OpenBraceToken };
-
-    std::string s = "expected "
-                + joinTokenNames(validTkKinds)
-                + "following struct-or-union or enum, got `"
-                + parser_->peek().valueText_c_str()
-                + "'";
-
-    diagnose(DiagnosticDescriptor(ID_of_ExpectedFOLLOWofStructOrUnionOrEnum,
-                                  "[[unexpected struct-or-union or enum FOLLOW]]",
-                                  s,
-                                  DiagnosticSeverity::Error,
-                                  DiagnosticCategory::Syntax));
+    diagnose(kExpectedFOLLOWofStructOrUnionOrEnum);
 }
 
 void Parser::DiagnosticsReporter::ExpectedNamedParameterBeforeEllipsis()
 {
-    diagnose(DiagnosticDescriptor(ID_of_ExpectedNamedParameterBeforeEllipsis,
-                                  "[[unexpected ellipsis before named parameter]]",
-                                  "ISO C requires a named parameter before `...'",
-                                  DiagnosticSeverity::Error,
-                                  DiagnosticCategory::Syntax));
+    diagnose(kExpectedNamedParameterBeforeEllipsis);
 }
 
 void Parser::DiagnosticsReporter::ExpectedTypeSpecifier()
 {
-    diagnose(DiagnosticDescriptor(ID_of_ExpectedTypeSpecifier,
-                                  "[[declaration without type specifier]]",
-                                  "missing type specifier, assume `int'",
-                                  DiagnosticSeverity::Warning,
-                                  DiagnosticCategory::Syntax));
+    diagnose(kExpectedTypeSpecifier);
 }
 
 void Parser::DiagnosticsReporter::UnexpectedCaseLabelOutsideSwitch()
 {
-    diagnose(DiagnosticDescriptor(ID_of_UnexpectedCaseLabelOutsideSwitch,
-                                  "[[case label outside switch-statement]]",
-                                  "`case' label not within a switch",
-                                  DiagnosticSeverity::Error,
-                                  DiagnosticCategory::Syntax));
+    diagnose(kUnexpectedCaseLabelOutsideSwitch);
 }
 
 void Parser::DiagnosticsReporter::UnexpectedDefaultLabelOutsideSwitch()
 {
-    diagnose(DiagnosticDescriptor(ID_of_UnexpectedDefaultLabelOutsideSwitch,
-                                  "[[default label outside switch-statement]]",
-                                  "`default' label not within a switch",
-                                  DiagnosticSeverity::Error,
-                                  DiagnosticCategory::Syntax));
+    diagnose(kUnexpectedDefaultLabelOutsideSwitch);
 }
 
 void Parser::DiagnosticsReporter::UnexpectedContinueOutsideLoop()
 {
-    diagnose(DiagnosticDescriptor(ID_of_UnexpectedContinueOutsideLoop,
-                                  "[[continue outside iteration-statement]]",
-                                  "`continue' not within a loop",
-                                  DiagnosticSeverity::Error,
-                                  DiagnosticCategory::Syntax));
+    diagnose(kUnexpectedContinueOutsideLoop);
 }
 
 void Parser::DiagnosticsReporter::UnexpectedBreakOutsideSwitchOrLoop()
 {
-    diagnose(DiagnosticDescriptor(ID_of_UnexpectedBreakOutsideSwitchOrLoop,
-                                  "[[break outside iteration- or switch-statement]]",
-                                  "`break' not within a loop or switch",
-                                  DiagnosticSeverity::Error,
-                                  DiagnosticCategory::Syntax));
+    diagnose(kUnexpectedBreakOutsideSwitchOrLoop);
 }
 
 void Parser::DiagnosticsReporter::UnexpectedGNUExtensionFlag()
 {
-    diagnose(DiagnosticDescriptor(ID_of_UnexpectedGNUExtensionFlag,
-                                  "[[unexpected `__extension__']]",
-                                  "unrecognized `__extension__'",
-                                  DiagnosticSeverity::Error,
-                                  DiagnosticCategory::Syntax));
+    diagnose(kUnexpectedGNUExtensionFlag);
 }
@@ -24,1366 +24,319 @@
 #include "syntax/SyntaxKind.h"
 #include "parser/ParseOptions.h"
 
-#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 
 namespace psy {
 namespace C {
 
-static inline SyntaxKind classify2(const char* s, const ParseOptions& opts)
-{
-    if (s[0] == 'd') {
-        if (s[1] == 'o') {
-            return Keyword_do;
-        }
-    }
-    else if (s[0] == 'i') {
-        if (s[1] == 'f') {
-            return Keyword_if;
-        }
-    }
-    return IdentifierToken;
-}
+namespace {
 
-static inline SyntaxKind classify3(const char* s, const ParseOptions& opts)
+/*
+ * What a spelling requires, from the dialect and extensions, in order to be
+ * classified; see Lexer::classificationMask.
+ */
+enum Requirement : std::uint32_t
 {
-    if (s[0] == 'a') {
-        if (s[1] == 's') {
-            if (s[2] == 'm') {
-                return KeywordAlias_asm;
-            }
-        }
-    }
-    else if (s[0] == 'f') {
-        if (s[1] == 'o') {
-            if (s[2] == 'r') {
-                return Keyword_for;
-            }
-        }
-    }
-    else if (s[0] == 'i') {
-        if (s[1] == 'n') {
-            if (s[2] == 't') {
-                return Keyword_int;
-            }
-        }
-    }
-    return IdentifierToken;
-}
+    Req_Keywords                    = 1u << 0,
+    Req_OperatorNames               = 1u << 1,
+    Req_C99                         = 1u << 2,
+    Req_C11                         = 1u << 3,
+    Req_ExtGNU_AlternateKeywords    = 1u << 4,
+    Req_ExtPSY_Generics             = 1u << 5,
+    Req_Expand_alignas              = 1u << 6,
+    Req_Expand_alignof              = 1u << 7,
+    Req_Expand_bool                 = 1u << 8,
+    Req_Expand_thread_local         = 1u << 9,
+    Req_CPP_nullptr                 = 1u << 10,
+    Req_NativeBooleans              = 1u << 11,
+    Req_NULLAsBuiltin               = 1u << 12,
+};
 
-static inline SyntaxKind classify4(const char* s, const ParseOptions& opts)
+struct Spelling
 {
-    if (s[0] == 'a') {
-        if (s[1] == 'u') {
-            if (s[2] == 't') {
-                if (s[3] == 'o') {
-                    return Keyword_auto;
-                }
-            }
-        }
-    }
-    else if (s[0] == 'b'
-             && opts.extensions().isEnabled_Expand_bool_AsKeyword()) {
-        if (s[1] == 'o') {
-            if (s[2] == 'o') {
-                if (s[3] == 'l') {
-                    return KeywordAlias_Bool;
-                }
-            }
-        }
-    }
-    else if (s[0] == 'c') {
-        if (s[1] == 'a') {
-            if (s[2] == 's') {
-                if (s[3] == 'e') {
-                    return Keyword_case;
-                }
-            }
-        }
-        else if (s[1] == 'h') {
-            if (s[2] == 'a') {
-                if (s[3] == 'r') {
-                    return Keyword_char;
-                }
-            }
-        }
-    }
-    else if (s[0] == 'e') {
-        if (s[1] == 'l') {
-            if (s[2] == 's') {
-                if (s[3] == 'e') {
-                    return Keyword_else;
-                }
-            }
-        }
-        else if (s[1] == 'n') {
-            if (s[2] == 'u') {
-                if (s[3] == 'm') {
-                    return Keyword_enum;
-                }
-            }
-        }
-    }
-    else if (s[0] == 'g') {
-        if (s[1] == 'o') {
-            if (s[2] == 't') {
-                if (s[3] == 'o') {
-                    return Keyword_goto;
-                }
-            }
-        }
-    }
-    else if (s[0] == 'l') {
-        if (s[1] == 'o') {
-            if (s[2] == 'n') {
-                if (s[3] == 'g') {
-                    return Keyword_long;
-                }
-            }
-        }
-    }
-    else if (s[0] == 'N'
-             && opts.extensions().isEnabled_NULLAsBuiltin()) {
-        if (s[1] == 'U') {
-            if (s[2] == 'L') {
-                if (s[3] == 'L') {
-                    return Keyword_Ext_NULL;
-                }
-            }
-        }
-    }
-    else if (s[0] == 't'
-             && opts.extensions().isEnabled_NativeBooleans()) {
-        if (s[1] == 'r') {
-            if (s[2] == 'u') {
-                if (s[3] == 'e') {
-                    return Keyword_Ext_true;
-                }
-            }
-        }
-    }
-    else if (s[0] == 'v') {
-        if (s[1] == 'o') {
-            if (s[2] == 'i') {
-                if (s[3] == 'd') {
-                    return Keyword_void;
-                }
-            }
-        }
-    }
-    return IdentifierToken;
-}
+    const char* text_;
+    int size_;
+    SyntaxKind kind_;
+    std::uint32_t reqs_;
+};
 
-static inline SyntaxKind classify5(const char* s, const ParseOptions& opts)
+constexpr int length(const char* s)
 {
-    if (s[0] == '_') {
-        if (s[1] == '_') {
-            if (s[2] == 'a') {
-                if (s[3] == 's') {
-                    if (s[4] == 'm') {
-                        return KeywordAlias___asm;
-                    }
-                }
-            }
-        }
-        else if (s[1] == 'B'
-                 && opts.extensions().isEnabled_Expand_bool_AsKeyword()) {
-            if (s[2] == 'o') {
-                if (s[3] == 'o') {
-                    if (s[4] == 'l') {
-                        return Keyword__Bool;
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 'b') {
-        if (s[1] == 'r') {
-            if (s[2] == 'e') {
-                if (s[3] == 'a') {
-                    if (s[4] == 'k') {
-                        return Keyword_break;
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 'c') {
-        if (s[1] == 'o') {
-            if (s[2] == 'n') {
-                if (s[3] == 's') {
-                    if (s[4] == 't') {
-                        return Keyword_const;
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 'f') {
-        if (s[1] == 'a'
-                && opts.extensions().isEnabled_NativeBooleans()) {
-            if (s[2] == 'l') {
-                if (s[3] == 's') {
-                    if (s[4] == 'e') {
-                        return Keyword_Ext_false;
-                    }
-                }
-            }
-        }
-        else if (s[1] == 'l') {
-            if (s[2] == 'o') {
-                if (s[3] == 'a') {
-                    if (s[4] == 't') {
-                        return Keyword_float;
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 's') {
-        if (s[1] == 'h') {
-            if (s[2] == 'o') {
-                if (s[3] == 'r') {
-                    if (s[4] == 't') {
-                        return Keyword_short;
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 'u') {
-        if (s[1] == 'n') {
-            if (s[2] == 'i') {
-                if (s[3] == 'o') {
-                    if (s[4] == 'n') {
-                        return Keyword_union;
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 'w') {
-        if (s[1] == 'h') {
-            if (s[2] == 'i') {
-                if (s[3] == 'l') {
-                    if (s[4] == 'e') {
-                        return Keyword_while;
-                    }
-                }
-            }
-        }
-    }
-    return IdentifierToken;
+    int n = 0;
+    while (s[n])
+        ++n;
+    return n;
 }
 
-static inline SyntaxKind classify6(const char* s, const ParseOptions& opts)
+constexpr Spelling keyword(const char* s, SyntaxKind k, std::uint32_t reqs = 0)
 {
-    if (s[0] == 'd') {
-        if (s[1] == 'o') {
-            if (s[2] == 'u') {
-                if (s[3] == 'b') {
-                    if (s[4] == 'l') {
-                        if (s[5] == 'e') {
-                            return Keyword_double;
-                        }
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 'e') {
-        if (s[1] == 'x') {
-            if (s[2] == 't') {
-                if (s[3] == 'e') {
-                    if (s[4] == 'r') {
-                        if (s[5] == 'n') {
-                            return Keyword_extern;
-                        }
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 'i'
-             && opts.dialect().std() >= LanguageDialect::Std::C99) {
-        if (s[1] == 'n') {
-            if (s[2] == 'l') {
-                if (s[3] == 'i') {
-                    if (s[4] == 'n') {
-                        if (s[5] == 'e') {
-                            return Keyword_inline;
-                        }
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 'r') {
-        if (s[1] == 'e') {
-            if (s[2] == 't') {
-                if (s[3] == 'u') {
-                    if (s[4] == 'r') {
-                        if (s[5] == 'n') {
-                            return Keyword_return;
-                        }
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 's') {
-        if (s[1] == 'i') {
-            if (s[2] == 'g') {
-                if (s[3] == 'n') {
-                    if (s[4] == 'e') {
-                        if (s[5] == 'd') {
-                            return Keyword_signed;
-                        }
-                    }
-                }
-            }
-            else if (s[2] == 'z') {
-                if (s[3] == 'e') {
-                    if (s[4] == 'o') {
-                        if (s[5] == 'f') {
-                            return Keyword_sizeof;
-                        }
-                    }
-                }
-            }
-        }
-        else if (s[1] == 't') {
-            if (s[2] == 'a') {
-                if (s[3] == 't') {
-                    if (s[4] == 'i') {
-                        if (s[5] == 'c') {
-                            return Keyword_static;
-                        }
-                    }
-                }
-            }
-            else if (s[2] == 'r') {
-                if (s[3] == 'u') {
-                    if (s[4] == 'c') {
-                        if (s[5] == 't') {
-                            return Keyword_struct;
-                        }
-                    }
-                }
-            }
-        }
-        else if (s[1] == 'w') {
-            if (s[2] == 'i') {
-                if (s[3] == 't') {
-                    if (s[4] == 'c') {
-                        if (s[5] == 'h') {
-                            return Keyword_switch;
-                        }
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 't') {
-        if (s[1] == 'y') {
-            if (s[2] == 'p') {
-                if (s[3] == 'e') {
-                    if (s[4] == 'o') {
-                        if (s[5] == 'f') {
-                            return KeywordAlias_typeof;
-                        }
-                    }
-                }
-            }
-        }
-    }
-    return IdentifierToken;
+    return Spelling{ s, length(s), k, Req_Keywords | reqs };
 }
 
-static inline SyntaxKind classify7(const char* s, const ParseOptions& opts)
+constexpr Spelling operatorName(const char* s, SyntaxKind k)
 {
-    if (s[0] == '_') {
-        if (s[1] == '_') {
-            if (s[2] == 'a') {
-                if (s[3] == 's') {
-                    if (s[4] == 'm') {
-                        if (s[5] == '_') {
-                            if (s[6] == '_') {
-                                return Keyword_ExtGNU___asm__;
-                            }
-                        }
-                    }
-                }
-            }
-            else if (s[2] == 'c') {
-                if (s[3] == 'o') {
-                    if (s[4] == 'n') {
-                        if (s[5] == 's') {
-                            if (s[6] == 't') {
-                                return KeywordAlias___const;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else if (s[1] == 'A'
-                 && opts.dialect().std() >= LanguageDialect::Std::C11) {
-            if (s[2] == 't') {
-                if (s[3] == 'o') {
-                    if (s[4] == 'm') {
-                        if (s[5] == 'i') {
-                            if (s[6] == 'c') {
-                                return Keyword__Atomic;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else if (s[1] == 'F'
-                 && opts.extensions().isEnabled_ExtPSY_Generics()) {
-            if (s[2] == 'o') {
-                if (s[3] == 'r') {
-                    if (s[4] == 'a') {
-                        if (s[5] == 'l') {
-                            if (s[6] == 'l') {
-                                return Keyword_ExtPSY__Forall;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else if (s[1] == 'E'
-                 && opts.extensions().isEnabled_ExtPSY_Generics()) {
-            if (s[2] == 'x') {
-                if (s[3] == 'i') {
-                    if (s[4] == 's') {
-                        if (s[5] == 't') {
-                            if (s[6] == 's') {
-                                return Keyword_ExtPSY__Exists;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 'a'
-                && opts.dialect().std() >= LanguageDialect::Std::C11) {
-        if (s[1] == 'l') {
-            if (s[2] == 'i') {
-                if (s[3] == 'g') {
-                    if (s[4] == 'n') {
-                        if (s[5] == 'a') {
-                            if (s[6] == 's'
-                                    && opts.extensions().isEnabled_Expand_alignas_AsKeyword()) {
-                                return Keyword__Alignas;
-                            }
-                        }
-                        else if (s[5] == 'o') {
-                            if (s[6] == 'f'
-                                    && opts.extensions().isEnabled_Expand_alignof_AsKeyword()) {
-                                return Keyword__Alignof;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 'd') {
-        if (s[1] == 'e') {
-            if (s[2] == 'f') {
-                if (s[3] == 'a') {
-                    if (s[4] == 'u') {
-                        if (s[5] == 'l') {
-                            if (s[6] == 't') {
-                                return Keyword_default;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 'n'
-             && opts.extensions().isEnabled_CPP_nullptr()) {
-        if (s[1] == 'u') {
-            if (s[2] == 'l') {
-                if (s[3] == 'l') {
-                    if (s[4] == 'p') {
-                        if (s[5] == 't') {
-                            if (s[6] == 'r') {
-                                return Keyword_Ext_nullptr;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 't') {
-        if (s[1] == 'y') {
-            if (s[2] == 'p') {
-                if (s[3] == 'e') {
-                    if (s[4] == 'd') {
-                        if (s[5] == 'e') {
-                            if (s[6] == 'f') {
-                                return Keyword_typedef;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 'w') {
-        if (s[1] == 'c') {
-            if (s[2] == 'h') {
-                if (s[3] == 'a') {
-                    if (s[4] == 'r') {
-                        if (s[5] == '_') {
-                            if (s[6] == 't') {
-                                return Keyword_Ext_wchar_t;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    return IdentifierToken;
+    return Spelling{ s, length(s), k, Req_OperatorNames };
 }
 
-static inline SyntaxKind classify8(const char* s, const ParseOptions& opts)
+constexpr Spelling spellings[] =
 {
-    if (s[0] == '_') {
-        if (s[1] == '_'
-                && opts.extensions().isEnabled_ExtGNU_AlternateKeywords()) {
-            if (s[2] == 'i') {
-                if (s[3] == 'n') {
-                    if (s[4] == 'l') {
-                        if (s[5] == 'i') {
-                            if (s[6] == 'n') {
-                                if (s[7] == 'e') {
-                                    return KeywordAlias___inline;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            else if (s[2] == 't') {
-                if (s[3] == 'y') {
-                    if (s[4] == 'p') {
-                        if (s[5] == 'e') {
-                            if (s[6] == 'o') {
-                                if (s[7] == 'f') {
-                                    return KeywordAlias___typeof;
-                                }
-                            }
-                        }
-                    }
-                }
-                else if (s[3] == 'h') {
-                    if (s[4] == 'r') {
-                        if (s[5] == 'e') {
-                            if (s[6] == 'a') {
-                                if (s[7] == 'd') {
-                                    return Keyword_ExtGNU___thread;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            else if (s[2] == 's'
-                     && opts.extensions().isEnabled_ExtGNU_AlternateKeywords()) {
-                if (s[3] == 'i') {
-                    if (s[4] == 'g') {
-                        if (s[5] == 'n') {
-                            if (s[6] == 'e') {
-                                if (s[7] == 'd') {
-                                    return KeywordAlias___signed;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else if (s[1] == 'A'
-                 && opts.dialect().std() >= LanguageDialect::Std::C11) {
-            if (s[2] == 'l') {
-                if (s[3] == 'i') {
-                    if (s[4] == 'g') {
-                        if (s[5] == 'n') {
-                            if (s[6] == 'a') {
-                                if (s[7] == 's') {
-                                    return Keyword__Alignas;
-                                }
-                            }
-                            else if (s[6] == 'o') {
-                                if (s[7] == 'f') {
-                                    return Keyword__Alignof;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else if (s[1] == 'C'
-                    && opts.dialect().std() >= LanguageDialect::Std::C99) {
-            if (s[2] == 'o') {
-                if (s[3] == 'm') {
-                    if (s[4] == 'p') {
-                        if (s[5] == 'l') {
-                            if (s[6] == 'e') {
-                                if (s[7] == 'x') {
-                                    return Keyword__Complex;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else if (s[1] == 'G'
-                    && opts.dialect().std() >= LanguageDialect::Std::C11) {
-            if (s[2] == 'e') {
-                if (s[3] == 'n') {
-                    if (s[4] == 'e') {
-                        if (s[5] == 'r') {
-                            if (s[6] == 'i') {
-                                if (s[7] == 'c') {
-                                    return Keyword__Generic;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 'c') {
-        if (s[1] == 'o') {
-            if (s[2] == 'n') {
-                if (s[3] == 't') {
-                    if (s[4] == 'i') {
-                        if (s[5] == 'n') {
-                            if (s[6] == 'u') {
-                                if (s[7] == 'e') {
-                                    return Keyword_continue;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else if (s[1] == 'h') {
-            if (s[2] == 'a') {
-                if (s[3] == 'r') {
-                    if (s[4] == '1') {
-                        if (s[5] == '6') {
-                            if (s[6] == '_') {
-                                if (s[7] == 't') {
-                                    return Keyword_Ext_char16_t;
-                                }
-                            }
-                        }
-                    } else if (s[4] == '3') {
-                        if (s[5] == '2') {
-                            if (s[6] == '_') {
-                                if (s[7] == 't') {
-                                    return Keyword_Ext_char32_t;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 'r') {
-        if (s[1] == 'e') {
-            if (s[2] == 'g') {
-                if (s[3] == 'i') {
-                    if (s[4] == 's') {
-                        if (s[5] == 't') {
-                            if (s[6] == 'e') {
-                                if (s[7] == 'r') {
-                                    return Keyword_register;
-                                }
-                            }
-                        }
-                    }
-                }
-            } else if (s[2] == 's') {
-                if (s[3] == 't') {
-                    if (s[4] == 'r') {
-                        if (s[5] == 'i') {
-                            if (s[6] == 'c') {
-                                if (s[7] == 't') {
-                                    return Keyword_restrict;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 'u') {
-        if (s[1] == 'n') {
-            if (s[2] == 's') {
-                if (s[3] == 'i') {
-                    if (s[4] == 'g') {
-                        if (s[5] == 'n') {
-                            if (s[6] == 'e') {
-                                if (s[7] == 'd') {
-                                    return Keyword_unsigned;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 'v') {
-        if (s[1] == 'o') {
-            if (s[2] == 'l') {
-                if (s[3] == 'a') {
-                    if (s[4] == 't') {
-                        if (s[5] == 'i') {
-                            if (s[6] == 'l') {
-                                if (s[7] == 'e') {
-                                    return Keyword_volatile;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    return IdentifierToken;
-}
+    /* C89/C90 */
+    keyword("auto", Keyword_auto),
+    keyword("break", Keyword_break),
+    keyword("case", Keyword_case),
+    keyword("char", Keyword_char),
+    keyword("const", Keyword_const),
+    keyword("continue", Keyword_continue),
+    keyword("default", Keyword_default),
+    keyword("do", Keyword_do),
+    keyword("double", Keyword_double),
+    keyword("else", Keyword_else),
+    keyword("enum", Keyword_enum),
+    keyword("extern", Keyword_extern),
+    keyword("float", Keyword_float),
+    keyword("for", Keyword_for),
+    keyword("goto", Keyword_goto),
+    keyword("if", Keyword_if),
+    keyword("int", Keyword_int),
+    keyword("long", Keyword_long),
+    keyword("register", Keyword_register),
+    keyword("restrict", Keyword_restrict),
+    keyword("return", Keyword_return),
+    keyword("short", Keyword_short),
+    keyword("signed", Keyword_signed),
+    keyword("sizeof", Keyword_sizeof),
+    keyword("static", Keyword_static),
+    keyword("struct", Keyword_struct),
+    keyword("switch", Keyword_switch),
+    keyword("typedef", Keyword_typedef),
+    keyword("union", Keyword_union),
+    keyword("unsigned", Keyword_unsigned),
+    keyword("void", Keyword_void),
+    keyword("volatile", Keyword_volatile),
+    keyword("while", Keyword_while),
 
-static inline SyntaxKind classify9(const char* s, const ParseOptions& opts)
-{
-    if (s[0] == '_') {
-        if (s[1] == 'N'
-                && opts.dialect().std() >= LanguageDialect::Std::C11) {
-            if (s[2] == 'o') {
-                if (s[3] == 'r') {
-                    if (s[4] == 'e') {
-                        if (s[5] == 't') {
-                            if (s[6] == 'u') {
-                                if (s[7] == 'r') {
-                                    if (s[8] == 'n') {
-                                        return Keyword__Noreturn;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        if (s[1] == '_') {
-            if (s[2] == 'c') {
-                if (s[3] == 'o') {
-                    if (s[4] == 'n') {
-                        if (s[5] == 's') {
-                            if (s[6] == 't') {
-                                if (s[7] == '_') {
-                                    if (s[8] == '_') {
-                                        return KeywordAlias___const__;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            else if (s[2] == 'a'
-                     && opts.extensions().isEnabled_ExtGNU_AlternateKeywords()) {
-                if (s[3] == 'l') {
-                    if (s[4] == 'i') {
-                        if (s[5] == 'g') {
-                            if (s[6] == 'n') {
-                                if (s[7] == 'o') {
-                                    if (s[8] == 'f') {
-                                        return KeywordAlias___alignof;
-                                    }
-                                }
-                                else if (s[7] == 'a') {
-                                    if (s[8] == 's') {
-                                        return KeywordAlias___alignas;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else if(s[1] == 'T'
-                    && opts.extensions().isEnabled_ExtPSY_Generics()) {
-            if (s[2] == 'e') {
-                if (s[3] == 'm') {
-                    if (s[4] == 'p') {
-                        if (s[5] == 'l') {
-                            if (s[6] == 'a') {
-                                if (s[7] == 't') {
-                                    if (s[8] == 'e') {
-                                        return Keyword_ExtPSY__Template;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    return IdentifierToken;
-}
+    /* C99 */
+    keyword("inline", Keyword_inline, Req_C99),
+    keyword("_Bool", Keyword__Bool, Req_Expand_bool),
+    keyword("_Complex", Keyword__Complex, Req_C99),
 
-static inline SyntaxKind classify10(const char* s, const ParseOptions& opts)
-{
-    if (s[0] == '_') {
-        if (s[1] == '_') {
-            if (s[2] == 'i') {
-                if (s[3] == 'n') {
-                    if (s[4] == 'l') {
-                        if (s[5] == 'i') {
-                            if (s[6] == 'n') {
-                                if (s[7] == 'e') {
-                                    if (s[8] == '_') {
-                                        if (s[9] == '_') {
-                                            return KeywordAlias___inline__;
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            else if (s[2] == 'r') {
-                if (s[3] == 'e') {
-                    if (s[4] == 's') {
-                        if (s[5] == 't') {
-                            if (s[6] == 'r') {
-                                if (s[7] == 'i') {
-                                    if (s[8] == 'c') {
-                                        if (s[9] == 't') {
-                                            return KeywordAlias___restrict;
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            else if (s[2] == 't') {
-                if (s[3] == 'y') {
-                    if (s[4] == 'p') {
-                        if (s[5] == 'e') {
-                            if (s[6] == 'o') {
-                                if (s[7] == 'f') {
-                                    if (s[8] == '_') {
-                                        if (s[9] == '_') {
-                                            return Keyword_ExtGNU___typeof__;
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            else if (s[2] == 's'
-                        && opts.extensions().isEnabled_ExtGNU_AlternateKeywords()) {
-                if (s[3] == 'i') {
-                    if (s[4] == 'g') {
-                        if (s[5] == 'n') {
-                            if (s[6] == 'e') {
-                                if (s[7] == 'd') {
-                                    if (s[8] == '_') {
-                                        if (s[9] == '_') {
-                                            return KeywordAlias___signed__;
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            else if (s[2] == 'v') {
-                if (s[3] == 'o') {
-                    if (s[4] == 'l') {
-                        if (s[5] == 'a') {
-                            if (s[6] == 't') {
-                                if (s[7] == 'i') {
-                                    if (s[8] == 'l') {
-                                        if (s[9] == 'e') {
-                                            return KeywordAlias___volatile;
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    return IdentifierToken;
-}
+    /* C11 */
+    keyword("_Alignas", Keyword__Alignas, Req_C11),
+    keyword("_Alignof", Keyword__Alignof, Req_C11),
+    keyword("_Atomic", Keyword__Atomic, Req_C11),
+    keyword("_Generic", Keyword__Generic, Req_C11),
+    keyword("_Noreturn", Keyword__Noreturn, Req_C11),
+    keyword("_Static_assert", Keyword__Static_assert, Req_C11),
+    keyword("_Thread_local", Keyword__Thread_local, Req_C11),
 
-static inline SyntaxKind classify11(const char* s, const ParseOptions& opts)
-{
-    if (s[0] == '_') {
-        if (s[1] == '_') {
-            if (s[2] == 'a') {
-                if (s[3] == 't') {
-                    if (s[4] == 't') {
-                        if (s[5] == 'r') {
-                            if (s[6] == 'i') {
-                                if (s[7] == 'b') {
-                                    if (s[8] == 'u') {
-                                        if (s[9] == 't') {
-                                            if (s[10] == 'e') {
-                                                return KeywordAlias___attribute;
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-                else if (s[3] == 'l') {
-                    if (s[4] == 'i') {
-                        if (s[5] == 'g') {
-                            if (s[6] == 'n') {
-                                if (s[7] == 'o') {
-                                    if (s[8] == 'f') {
-                                        if (s[9] == '_') {
-                                            if (s[10] == '_') {
-                                                return KeywordAlias___alignof__;
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    return IdentifierToken;
-}
+    /* Macros */
+    keyword("alignas", Keyword__Alignas, Req_C11 | Req_Expand_alignas),
+    keyword("alignof", Keyword__Alignof, Req_C11 | Req_Expand_alignof),
+    keyword("bool", KeywordAlias_Bool, Req_Expand_bool),
+    keyword("thread_local", Keyword__Thread_local, Req_Expand_thread_local),
 
-static inline SyntaxKind classify12(const char* s, const ParseOptions& opts)
-{
-    if (s[0] == '_') {
-        if (s[1] == '_'
-                && opts.extensions().isEnabled_ExtGNU_AlternateKeywords()) {
-            if (s[2] == 'v') {
-                if (s[3] == 'o') {
-                    if (s[4] == 'l') {
-                        if (s[5] == 'a') {
-                            if (s[6] == 't') {
-                                if (s[7] == 'i') {
-                                    if (s[8] == 'l') {
-                                        if (s[9] == 'e') {
-                                            if (s[10] == '_') {
-                                                if (s[11] == '_') {
-                                                    return KeywordAlias___volatile__;
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            else if (s[2] == 'r') {
-                if (s[3] == 'e') {
-                    if (s[4] == 's') {
-                        if (s[5] == 't') {
-                            if (s[6] == 'r') {
-                                if (s[7] == 'i') {
-                                    if (s[8] == 'c') {
-                                        if (s[9] == 't') {
-                                            if (s[10] == '_') {
-                                                if (s[11] == '_') {
-                                                    return KeywordAlias___restrict__;
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else if (s[1] == 't'
-                 && opts.extensions().isEnabled_Expand_thread_local_AsKeyword()) {
-            if (s[2] == 'h') {
-                if (s[3] == 'r') {
-                    if (s[4] == 'e') {
-                        if (s[5] == 'a') {
-                            if (s[6] == 'd') {
-                                if (s[7] == '_') {
-                                    if (s[8] == 'l') {
-                                        if (s[9] == 'o') {
-                                            if (s[10] == 'c') {
-                                                if (s[11] == 'a') {
-                                                    if (s[12] == 'l') {
-                                                        return Keyword__Thread_local;
-                                                    }
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    return IdentifierToken;
-}
+    /* Extensions */
+    keyword("char16_t", Keyword_Ext_char16_t),
+    keyword("char32_t", Keyword_Ext_char32_t),
+    keyword("false", Keyword_Ext_false, Req_NativeBooleans),
+    keyword("true", Keyword_Ext_true, Req_NativeBooleans),
+    keyword("NULL", Keyword_Ext_NULL, Req_NULLAsBuiltin),
+    keyword("nullptr", Keyword_Ext_nullptr, Req_CPP_nullptr),
+    keyword("wchar_t", Keyword_Ext_wchar_t),
 
-static inline SyntaxKind classify13(const char* s, const ParseOptions& opts)
-{
-    if (s[0] == '_') {
-        if (s[1] == '_'
-                && opts.extensions().isEnabled_ExtGNU_AlternateKeywords()) {
-            if (s[2] == 'a') {
-                if (s[3] == 't') {
-                    if (s[4] == 't') {
-                        if (s[5] == 'r') {
-                            if (s[6] == 'i') {
-                                if (s[7] == 'b') {
-                                    if (s[8] == 'u') {
-                                        if (s[9] == 't') {
-                                            if (s[10] == 'e') {
-                                                if (s[11] == '_') {
-                                                    if (s[12] == '_') {
-                                                        return Keyword_ExtGNU___attribute__;
-                                                    }
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            else if (s[2] == 'e'
-                     && opts.extensions().isEnabled_ExtGNU_AlternateKeywords()) {
-                if (s[3] == 'x') {
-                    if (s[4] == 't') {
-                        if (s[5] == 'e') {
-                            if (s[6] == 'n') {
-                                if (s[7] == 's') {
-                                    if (s[8] == 'i') {
-                                        if (s[9] == 'o') {
-                                            if (s[10] == 'n') {
-                                                if (s[11] == '_') {
-                                                    if (s[12] == '_') {
-                                                        return Keyword_ExtGNU___extension__;
-                                                    }
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        else if (s[1] == 'T'
-                 && opts.dialect().std() >= LanguageDialect::Std::C11) {
-            if (s[2] == 'h') {
-                if (s[3] == 'r') {
-                    if (s[4] == 'e') {
-                        if (s[5] == 'a') {
-                            if (s[6] == 'd') {
-                                if (s[7] == '_') {
-                                    if (s[8] == 'l') {
-                                        if (s[9] == 'o') {
-                                            if (s[10] == 'c') {
-                                                if (s[11] == 'a') {
-                                                    if (s[12] == 'l') {
-                                                        return Keyword__Thread_local;
-                                                    }
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    return IdentifierToken;
-}
+    /* GNU */
+    keyword("__asm__", Keyword_ExtGNU___asm__),
+    keyword("__attribute__", Keyword_ExtGNU___attribute__, Req_ExtGNU_AlternateKeywords),
+    keyword("__extension__", Keyword_ExtGNU___extension__, Req_ExtGNU_AlternateKeywords),
+    keyword("__thread", Keyword_ExtGNU___thread, Req_ExtGNU_AlternateKeywords),
+    keyword("__typeof__", Keyword_ExtGNU___typeof__),
+    keyword("asm", KeywordAlias_asm),
+    keyword("typeof", KeywordAlias_typeof),
+    keyword("__alignas", KeywordAlias___alignas, Req_ExtGNU_AlternateKeywords),
+    keyword("__alignof", KeywordAlias___alignof, Req_ExtGNU_AlternateKeywords),
+    keyword("__asm", KeywordAlias___asm),
+    keyword("__attribute", KeywordAlias___attribute),
+    keyword("__const", KeywordAlias___const),
+    keyword("__inline", KeywordAlias___inline, Req_ExtGNU_AlternateKeywords),
+    keyword("__restrict", KeywordAlias___restrict),
+    keyword("__signed", KeywordAlias___signed, Req_ExtGNU_AlternateKeywords),
+    keyword("__typeof", KeywordAlias___typeof, Req_ExtGNU_AlternateKeywords),
+    keyword("__volatile", KeywordAlias___volatile),
+    keyword("__alignof__", KeywordAlias___alignof__),
+    keyword("__const__", KeywordAlias___const__),
+    keyword("__inline__", KeywordAlias___inline__),
+    keyword("__restrict__", KeywordAlias___restrict__, Req_ExtGNU_AlternateKeywords),
+    keyword("__signed__", KeywordAlias___signed__, Req_ExtGNU_AlternateKeywords),
+    keyword("__volatile__", KeywordAlias___volatile__, Req_ExtGNU_AlternateKeywords),
 
-static inline SyntaxKind classify14(const char* s, const ParseOptions& opts)
-{
-    if (s[0] == '_'
-            && opts.dialect().std() >= LanguageDialect::Std::C11) {
-        if (s[1] == 'S') {
-            if (s[2] == 't') {
-                if (s[3] == 'a') {
-                    if (s[4] == 't') {
-                        if (s[5] == 'i') {
-                            if (s[6] == 'c') {
-                                if (s[7] == '_') {
-                                    if (s[8] == 'a') {
-                                        if (s[9] == 's') {
-                                            if (s[10] == 's') {
-                                                if (s[11] == 'e') {
-                                                    if (s[12] == 'r') {
-                                                        if (s[13] == 't') {
-                                                            return Keyword__Static_assert;
-                                                        }
-                                                    }
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
+    /* Psyche */
+    keyword("_Exists", Keyword_ExtPSY__Exists, Req_ExtPSY_Generics),
+    keyword("_Forall", Keyword_ExtPSY__Forall, Req_ExtPSY_Generics),
+    keyword("_Template", Keyword_ExtPSY__Template, Req_ExtPSY_Generics),
 
-                }
-            }
-        }
-    }
-    return IdentifierToken;
-}
+    /* Operator names (7.9) */
+    operatorName("and", OperatorName_ANDToken),
+    operatorName("and_eq", OperatorName_ANDEQToken),
+    operatorName("bitand", OperatorName_BITANDToken),
+    operatorName("bitor", OperatorName_BITORToken),
+    operatorName("compl", OperatorName_COMPLToken),
+    operatorName("not", OperatorName_NOTToken),
+    operatorName("not_eq", OperatorName_NOTEQToken),
+    operatorName("or", OperatorName_ORToken),
+    operatorName("or_eq", OperatorName_OREQToken),
+    operatorName("xor", OperatorName_XORToken),
+    operatorName("xor_eq", OperatorName_XOREQToken),
+};
 
-static inline SyntaxKind classify15(const char* s, const ParseOptions& opts)
-{
-    return IdentifierToken;
-}
+constexpr std::size_t spellingsCnt = sizeof(spellings) / sizeof(spellings[0]);
 
-static inline SyntaxKind classify16(const char* s, const ParseOptions& opts)
+constexpr int minSize()
 {
-    return IdentifierToken;
+    int n = spellings[0].size_;
+    for (const auto& sp : spellings)
+        n = sp.size_ < n ? sp.size_ : n;
+    return n;
 }
 
-static inline SyntaxKind classify17(const char* s, const ParseOptions& opts)
+constexpr int maxSize()
 {
-    return IdentifierToken;
+    int n = 0;
+    for (const auto& sp : spellings)
+        n = sp.size_ > n ? sp.size_ : n;
+    return n;
 }
 
-static inline SyntaxKind classify18(const char* s, const ParseOptions& opts)
-{
-    return IdentifierToken;
-}
+constexpr int spellingMinSize = minSize();
+constexpr int spellingMaxSize = maxSize();
 
-static inline SyntaxKind classify19(const char* s, const ParseOptions& opts)
-{
-    return IdentifierToken;
-}
+static_assert(spellingsCnt < 256, "slots store a spelling's index in a byte");
 
-SyntaxKind Lexer::classify(const char* s, int n, const ParseOptions& opts)
+/*
+ * The hash key of a spelling: its length and the bytes at its start, middle,
+ * and end; these suffice to tell every spelling apart.
+ */
+constexpr std::uint64_t hashKey(const char* s, int n)
 {
-    switch (n) {
-        case 2: return classify2(s, opts);
-        case 3: return classify3(s, opts);
-        case 4: return classify4(s, opts);
-        case 5: return classify5(s, opts);
-        case 6: return classify6(s, opts);
-        case 7: return classify7(s, opts);
-        case 8: return classify8(s, opts);
-        case 9: return classify9(s, opts);
-        case 10: return classify10(s, opts);
-        case 11: return classify11(s, opts);
-        case 12: return classify12(s, opts);
-        case 13: return classify13(s, opts);
-        case 14: return classify14(s, opts);
-        case 15: return classify15(s, opts);
-        case 16: return classify16(s, opts);
-        case 17: return classify17(s, opts);
-        case 18: return classify18(s, opts);
-        case 19: return classify19(s, opts);
-        default: return IdentifierToken;
-    }
+    return static_cast<std::uint64_t>(n)
+         | static_cast<std::uint64_t>(static_cast<unsigned char>(s[0])) << 8
+         | static_cast<std::uint64_t>(static_cast<unsigned char>(s[n / 2])) << 16
+         | static_cast<std::uint64_t>(static_cast<unsigned char>(s[n - 1])) << 24;
 }
 
-static inline SyntaxKind classifyOperator2(const char* s)
+constexpr bool hashKeysAreUnique()
 {
-    if (s[0] == 'o') {
-        if (s[1] == 'r') {
-            return OperatorName_ORToken;
+    for (std::size_t i = 0; i < spellingsCnt; ++i) {
+        for (std::size_t j = i + 1; j < spellingsCnt; ++j) {
+            if (hashKey(spellings[i].text_, spellings[i].size_)
+                    == hashKey(spellings[j].text_, spellings[j].size_))
+                return false;
         }
     }
-    return IdentifierToken;
+    return true;
 }
 
-static inline SyntaxKind classifyOperator3(const char* s)
+static_assert(hashKeysAreUnique(), "spellings must differ in the bytes of their hash key");
+
+constexpr int slotBits = 10;
+
+/*
+ * A multiplicative hash, over the hash key, that is perfect for the spellings:
+ * each slot holds the (1-based) index of the only spelling that maps to it.
+ */
+struct PerfectHash
 {
-    if (s[0] == 'a') {
-        if (s[1] == 'n') {
-            if (s[2] == 'd') {
-                return OperatorName_ANDToken;
-            }
-        }
-    }
-    else if (s[0] == 'n') {
-        if (s[1] == 'o') {
-            if (s[2] == 't') {
-                return OperatorName_NOTToken;
-            }
-        }
-    }
-    else if (s[0] == 'x') {
-        if (s[1] == 'o') {
-            if (s[2] == 'r') {
-                return OperatorName_XORToken;
-            }
-        }
+    std::uint64_t multiplier_;
+    std::uint8_t slots_[1 << slotBits];
+
+    constexpr std::size_t slot(std::uint64_t key) const
+    {
+        return (key * multiplier_) >> (64 - slotBits);
     }
-    return IdentifierToken;
-}
+};
 
-static inline SyntaxKind classifyOperator5(const char* s)
+constexpr PerfectHash computePerfectHash()
 {
-    if (s[0] == 'b') {
-        if (s[1] == 'i') {
-            if (s[2] == 't') {
-                if (s[3] == 'o') {
-                    if (s[4] == 'r') {
-                        return OperatorName_BITORToken;
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 'c') {
-        if (s[1] == 'o') {
-            if (s[2] == 'm') {
-                if (s[3] == 'p') {
-                    if (s[4] == 'l') {
-                        return OperatorName_COMPLToken;
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 'o') {
-        if (s[1] == 'r') {
-            if (s[2] == '_') {
-                if (s[3] == 'e') {
-                    if (s[4] == 'q') {
-                        return OperatorName_OREQToken;
-                    }
-                }
-            }
-        }
-    }
-    return IdentifierToken;
+    std::uint64_t seed = 0x9E3779B97F4A7C15u;
+    for (int attempt = 0; attempt < 10000; ++attempt) {
+        PerfectHash hash{ seed | 1, {} };
+        bool perfect = true;
+        for (std::size_t i = 0; i < spellingsCnt && perfect; ++i) {
+            auto& idx = hash.slots_[hash.slot(hashKey(spellings[i].text_, spellings[i].size_))];
+            if (idx)
+                perfect = false;
+            else
+                idx = static_cast<std::uint8_t>(i + 1);
+        }
+        if (perfect)
+            return hash;
+        seed = seed * 6364136223846793005u + 1442695040888963407u;
+    }
+    return PerfectHash{ 0, {} };
 }
 
-static inline SyntaxKind classifyOperator6(const char* s)
+constexpr PerfectHash perfectHash = computePerfectHash();
+
+static_assert(perfectHash.multiplier_ != 0, "no perfect hash found for the spellings");
+
+} // anonymous
+
+std::uint32_t Lexer::classificationMask(const ParseOptions& opts)
 {
-    if (s[0] == 'a') {
-        if (s[1] == 'n') {
-            if (s[2] == 'd') {
-                if (s[3] == '_') {
-                    if (s[4] == 'e') {
-                        if (s[5] == 'q') {
-                            return OperatorName_ANDEQToken;
-                        }
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 'b') {
-        if (s[1] == 'i') {
-            if (s[2] == 't') {
-                if (s[3] == 'a') {
-                    if (s[4] == 'n') {
-                        if (s[5] == 'd') {
-                            return OperatorName_BITANDToken;
-                        }
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 'n') {
-        if (s[1] == 'o') {
-            if (s[2] == 't') {
-                if (s[3] == '_') {
-                    if (s[4] == 'e') {
-                        if (s[5] == 'q') {
-                            return OperatorName_NOTEQToken;
-                        }
-                    }
-                }
-            }
-        }
-    }
-    else if (s[0] == 'x') {
-        if (s[1] == 'o') {
-            if (s[2] == 'r') {
-                if (s[3] == '_') {
-                    if (s[4] == 'e') {
-                        if (s[5] == 'q') {
-                            return OperatorName_XOREQToken;
-                        }
-                    }
-                }
-            }
-        }
-    }
-    return IdentifierToken;
+    std::uint32_t mask = 0;
+    if (opts.IsKeywordsIdentifiersClassified())
+        mask |= Req_Keywords;
+    if (opts.dialect().std() >= LanguageDialect::Std::C99)
+        mask |= Req_C99;
+    if (opts.dialect().std() >= LanguageDialect::Std::C11)
+        mask |= Req_C11;
+
+    const auto& exts = opts.extensions();
+    if (exts.isEnabled_Expand_operatorNames())
+        mask |= Req_OperatorNames;
+    if (exts.isEnabled_ExtGNU_AlternateKeywords())
+        mask |= Req_ExtGNU_AlternateKeywords;
+    if (exts.isEnabled_ExtPSY_Generics())
+        mask |= Req_ExtPSY_Generics;
+    if (exts.isEnabled_Expand_alignas_AsKeyword())
+        mask |= Req_Expand_alignas;
+    if (exts.isEnabled_Expand_alignof_AsKeyword())
+        mask |= Req_Expand_alignof;
+    if (exts.isEnabled_Expand_bool_AsKeyword())
+        mask |= Req_Expand_bool;
+    if (exts.isEnabled_Expand_thread_local_AsKeyword())
+        mask |= Req_Expand_thread_local;
+    if (exts.isEnabled_CPP_nullptr())
+        mask |= Req_CPP_nullptr;
+    if (exts.isEnabled_NativeBooleans())
+        mask |= Req_NativeBooleans;
+    if (exts.isEnabled_NULLAsBuiltin())
+        mask |= Req_NULLAsBuiltin;
+
+    return mask;
 }
 
-SyntaxKind Lexer::classifyOperator(const char* s, int n, const ParseOptions& opts)
+SyntaxKind Lexer::classify(const char* s, int n, std::uint32_t mask, bool& isOperatorName)
 {
-    if (!opts.extensions().isEnabled_Expand_operatorNames())
+    isOperatorName = false;
+
+    if (n < spellingMinSize || n > spellingMaxSize)
+        return IdentifierToken;
+
+    auto idx = perfectHash.slots_[perfectHash.slot(hashKey(s, n))];
+    if (!idx)
         return IdentifierToken;
 
-    switch (n) {
-        case 2: return classifyOperator2(s);
-        case 3: return classifyOperator3(s);
-        case 5: return classifyOperator5(s);
-        case 6: return classifyOperator6(s);
-        default: return IdentifierToken;
+    const Spelling& sp = spellings[idx - 1];
+    if (sp.size_ != n
+            || std::memcmp(sp.text_, s, n)
+            || (sp.reqs_ & ~mask)) {
+        return IdentifierToken;
     }
+
+    isOperatorName = sp.reqs_ & Req_OperatorNames;
+    return sp.kind_;
 }
 
 } // C
@@ -20,32 +20,148 @@
 
 #include "LexedTokens.h"
 
+#include "syntax/SyntaxLexeme.h"
+#include "syntax/SyntaxToken.h"
+
 using namespace psy;
 using namespace C;
 
-void LexedTokens::add(SyntaxToken tk)
+LexedTokens::Record::Record()
+{
+    setup();
+}
+
+void LexedTokens::Record::setup()
+{
+    rawSyntaxK_ = 0;
+    byteSize_ = 0;
+    charSize_ = 0;
+    byteOffset_ = 0;
+    charOffset_ = 0;
+    BF_all_ = 0;
+    lexeme_ = nullptr;
+}
+
+bool LexedTokens::Record::isComment() const
+{
+    return SyntaxToken::isComment(rawSyntaxK_);
+}
+
+const char* LexedTokens::Record::valueText_c_str() const
+{
+    return lexeme_ ? lexeme_->c_str() : "";
+}
+
+LexedTokens::LexedTokens(SyntaxTree* tree)
+    : tree_(tree)
+    , base_(0)
 {
-    v_.emplace_back(tk);
+    // Marker (invalid) token.
+    Record tk;
+    tk.BF_.missing_ = true;
+    add(tk);
 }
 
-SyntaxToken& LexedTokens::tokenAt(LexedTokens::IndexType tkIdx)
+void LexedTokens::add(const Record& tk)
 {
-    return v_[tkIdx];
+    kinds_.push_back(tk.rawSyntaxK_);
+    flags_.push_back(tk.BF_);
+    byteOffsets_.push_back(tk.byteOffset_);
+    charOffsets_.push_back(tk.charOffset_);
+    byteSizes_.push_back(tk.byteSize_);
+    charSizes_.push_back(tk.charSize_);
+    matchingBrackets_.push_back(0);
+    lexemes_.push_back(tk.lexeme_);
+}
+
+void LexedTokens::append(const LexedTokens& other,
+                         IndexType firstIdx,
+                         IndexType lastIdx,
+                         std::uint32_t byteDelta,
+                         std::uint32_t charDelta)
+{
+    const auto first = other.slot(firstIdx);
+    const auto last = other.slot(lastIdx);
+    const auto prevCnt = kinds_.size();
+
+    auto copy = [first, last] (auto& v, const auto& otherV) {
+        v.insert(v.end(), otherV.begin() + first, otherV.begin() + last);
+    };
+    copy(kinds_, other.kinds_);
+    copy(flags_, other.flags_);
+    copy(byteOffsets_, other.byteOffsets_);
+    copy(charOffsets_, other.charOffsets_);
+    copy(byteSizes_, other.byteSizes_);
+    copy(charSizes_, other.charSizes_);
+    copy(matchingBrackets_, other.matchingBrackets_);
+    copy(lexemes_, other.lexemes_);
+
+    if (byteDelta) {
+        for (auto i = prevCnt; i < byteOffsets_.size(); ++i)
+            byteOffsets_[i] += byteDelta;
+    }
+    if (charDelta) {
+        for (auto i = prevCnt; i < charOffsets_.size(); ++i)
+            charOffsets_[i] += charDelta;
+    }
+}
+
+LexedTokens::Record LexedTokens::recordAt(IndexType tkIdx) const
+{
+    Record tk;
+    tk.rawSyntaxK_ = kinds_[slot(tkIdx)];
+    tk.BF_ = flags_[slot(tkIdx)];
+    tk.byteOffset_ = byteOffsets_[slot(tkIdx)];
+    tk.charOffset_ = charOffsets_[slot(tkIdx)];
+    tk.byteSize_ = byteSizes_[slot(tkIdx)];
+    tk.charSize_ = charSizes_[slot(tkIdx)];
+    tk.lexeme_ = lexemes_[slot(tkIdx)];
+    return tk;
 }
 
 LexedTokens::IndexType LexedTokens::freeSlot() const
 {
-    return IndexType(v_.size() - 1);
+    return IndexType(base_ + kinds_.size() - 1);
 }
 
 LexedTokens::SizeType LexedTokens::count() const
 {
-    return v_.size();
+    return SizeType(base_ + kinds_.size());
 }
 
 void LexedTokens::clear()
 {
-    v_.clear();
+    kinds_.clear();
+    flags_.clear();
+    byteOffsets_.clear();
+    charOffsets_.clear();
+    byteSizes_.clear();
+    charSizes_.clear();
+    matchingBrackets_.clear();
+    lexemes_.clear();
+    base_ = 0;
+}
+
+void LexedTokens::releaseBefore(IndexType tkIdx)
+{
+    if (tkIdx <= base_ + 1)
+        return;
+
+    const std::size_t releaseCnt = tkIdx - base_ - 1;
+    if (releaseCnt < kinds_.size() - releaseCnt)
+        return;
+
+    // The marker token is kept (at slot 0).
+    auto release = [releaseCnt] (auto& v) { v.erase(v.begin() + 1, v.begin() + 1 + releaseCnt); };
+    release(kinds_);
+    release(flags_);
+    release(byteOffsets_);
+    release(charOffsets_);
+    release(byteSizes_);
+    release(charSizes_);
+    release(matchingBrackets_);
+    release(lexemes_);
+    base_ = tkIdx - 1;
 }
 
 LexedTokens::IndexType LexedTokens::invalidIndex()
@@ -22,9 +22,11 @@
 #define PSYCHE_C_LEXED_TOKENS_H__
 
 #include "API.h"
+#include "APIFwds.h"
 
-#include "syntax/SyntaxToken.h"
+#include "syntax/SyntaxKind.h"
 
+#include <cstdint>
 #include <vector>
 
 namespace psy {
@@ -34,23 +36,140 @@ namespace C {
  * \brief The LexedTokens class.
  *
  * The container of all tokens lexed by the Lexer.
+ *
+ * The data of the tokens is stored in parallel arrays (of kinds, of flags,
+ * of offsets, etc.), so that a pass over a single property of the tokens,
+ * e.g., the parser's lookahead over their kinds, reads dense memory. A
+ * SyntaxToken is a handle into a LexedTokens.
+ *
+ * When the tokens are streamed to the parser, the ones that precede a given
+ * index may be released; the indexes of the remaining tokens don't change,
+ * and neither does the (marker) token at the invalid index, which is kept.
  */
 class PSY_C_API LexedTokens
 {
 public:
-    using SizeType = std::vector<SyntaxToken>::size_type;
-    using IndexType = SizeType;
+    using IndexType = std::uint32_t;
+    using SizeType = IndexType;
+
+    LexedTokens(SyntaxTree* tree);
+
+    /*
+     * Watch for data layout (size) before changing members or their order.
+     */
+    struct BitFields
+    {
+        std::uint16_t atStartOfLine_ : 1;
+        std::uint16_t hasLeadingWS_  : 1;
+        std::uint16_t joined_        : 1;
+        std::uint16_t expanded_      : 1;
+        std::uint16_t generated_     : 1;
+        std::uint16_t missing_       : 1;
+    };
+
+    /**
+     * \brief The LexedTokens::Record struct.
+     *
+     * The data of a token, as the Lexer produces it, before it is added to
+     * (i.e., scattered over the arrays of) a LexedTokens.
+     */
+    struct PSY_C_API Record
+    {
+        Record();
+
+        void setup();
+
+        SyntaxKind kind() const { return SyntaxKind(rawSyntaxK_); }
+        bool isKind(SyntaxKind k) const { return kind() == k; }
+        bool isAtStartOfLine() const { return BF_.atStartOfLine_; }
+        bool isComment() const;
+        const char* valueText_c_str() const;
+
+        unsigned int byteStart() const { return byteOffset_; }
+        unsigned int byteEnd() const { return byteOffset_ + byteSize_; }
+
+        std::uint16_t rawSyntaxK_;  // Keep the same underlying type of SyntaxKind.
+        std::uint16_t byteSize_;
+        std::uint16_t charSize_;
+        std::uint32_t byteOffset_;
+        std::uint32_t charOffset_;  // UTF-16
+
+        union
+        {
+            std::uint16_t BF_all_;
+            BitFields BF_;
+        };
 
-    void add(SyntaxToken tk);
-    SyntaxToken& tokenAt(IndexType tkIdx);
+        union
+        {
+            SyntaxLexeme* lexeme_;
+            const Identifier* identifier_;
+            const IntegerConstant* integer_;
+            const FloatingConstant* floating_;
+            const CharacterConstant* character_;
+            const StringLiteral* string_;
+        };
+    };
+
+    void add(const Record& tk);
+
+    /**
+     * Append the tokens of \p other from \p firstIdx up to \p lastIdx (not
+     * included), with their offsets shifted by \p byteDelta and \p charDelta;
+     * the matching brackets are copied as they are, i.e., as indexes in \p other.
+     */
+    void append(const LexedTokens& other,
+                IndexType firstIdx,
+                IndexType lastIdx,
+                std::uint32_t byteDelta,
+                std::uint32_t charDelta);
+
+    Record recordAt(IndexType tkIdx) const;
     IndexType freeSlot() const;
     SizeType count() const;
     void clear();
 
+    /**
+     * Release the tokens before the one at \p tkIdx (handles to those tokens
+     * become dangling). The storage is compacted only when the released
+     * tokens outnumber the remaining ones, so that the cost is amortized.
+     */
+    void releaseBefore(IndexType tkIdx);
+    IndexType firstIndex() const { return base_ + 1; }
+
+    SyntaxTree* tree() const { return tree_; }
+
+    std::uint16_t rawKindAt(IndexType tkIdx) const { return kinds_[slot(tkIdx)]; }
+    const BitFields& flagsAt(IndexType tkIdx) const { return flags_[slot(tkIdx)]; }
+    BitFields& flagsAt(IndexType tkIdx) { return flags_[slot(tkIdx)]; }
+    std::uint32_t byteOffsetAt(IndexType tkIdx) const { return byteOffsets_[slot(tkIdx)]; }
+    std::uint32_t charOffsetAt(IndexType tkIdx) const { return charOffsets_[slot(tkIdx)]; }
+    std::uint16_t byteSizeAt(IndexType tkIdx) const { return byteSizes_[slot(tkIdx)]; }
+    std::uint16_t charSizeAt(IndexType tkIdx) const { return charSizes_[slot(tkIdx)]; }
+    SyntaxLexeme* lexemeAt(IndexType tkIdx) const { return lexemes_[slot(tkIdx)]; }
+    IndexType matchingBracketAt(IndexType tkIdx) const { return matchingBrackets_[slot(tkIdx)]; }
+    void setMatchingBracket(IndexType tkIdx, IndexType matchIdx) { matchingBrackets_[slot(tkIdx)] = matchIdx; }
+
     static IndexType invalidIndex();
 
 private:
-    std::vector<SyntaxToken> v_;
+    friend class TokenCache;
+
+    SyntaxTree* tree_;
+
+    // The tokens after the marker one (at slot 0) and before the one at
+    // index base_ + 1 are released.
+    IndexType base_;
+    std::size_t slot(IndexType tkIdx) const { return tkIdx > base_ ? tkIdx - base_ : 0; }
+
+    std::vector<std::uint16_t> kinds_;
+    std::vector<BitFields> flags_;
+    std::vector<std::uint32_t> byteOffsets_;
+    std::vector<std::uint32_t> charOffsets_;
+    std::vector<std::uint16_t> byteSizes_;
+    std::vector<std::uint16_t> charSizes_;
+    std::vector<IndexType> matchingBrackets_;
+    std::vector<SyntaxLexeme*> lexemes_;
 };
 
 } // C
@@ -0,0 +1,75 @@
+// Copyright (c) 2020/21 Leandro T. C. Melo <ltcmelo@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+// THE SOFTWARE.
+
+#include "LexemeInterner.h"
+
+#include "syntax/SyntaxLexemes.h"
+
+#include "../common/text/ConcurrentTextElementTable.h"
+
+using namespace psy;
+using namespace C;
+
+struct LexemeInterner::LexemeInternerImpl
+{
+    ConcurrentTextElementTable<Identifier> identifiers_;
+    ConcurrentTextElementTable<IntegerConstant> integers_;
+    ConcurrentTextElementTable<FloatingConstant> floatings_;
+    ConcurrentTextElementTable<CharacterConstant> characters_;
+    ConcurrentTextElementTable<StringLiteral> strings_;
+};
+
+LexemeInterner::LexemeInterner()
+    : P(new LexemeInternerImpl)
+{}
+
+LexemeInterner::~LexemeInterner()
+{}
+
+const Identifier* LexemeInterner::identifier(const char* s, unsigned int size)
+{
+    return P->identifiers_.findOrInsert(s, size);
+}
+
+const IntegerConstant* LexemeInterner::integerConstant(const char* s, unsigned int size)
+{
+    return P->integers_.findOrInsert(s, size);
+}
+
+const FloatingConstant* LexemeInterner::floatingConstant(const char* s, unsigned int size)
+{
+    return P->floatings_.findOrInsert(s, size);
+}
+
+const CharacterConstant* LexemeInterner::characterConstant(const char* s, unsigned int size)
+{
+    return P->characters_.findOrInsert(s, size);
+}
+
+const StringLiteral* LexemeInterner::stringLiteral(const char* s, unsigned int size)
+{
+    return P->strings_.findOrInsert(s, size);
+}
+
+unsigned int LexemeInterner::identifierCount() const
+{
+    return P->identifiers_.size();
+}
@@ -0,0 +1,73 @@
+// Copyright (c) 2020/21 Leandro T. C. Melo <ltcmelo@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+// THE SOFTWARE.
+
+#ifndef PSYCHE_C_LEXEME_INTERNER_H__
+#define PSYCHE_C_LEXEME_INTERNER_H__
+
+#include "API.h"
+#include "APIFwds.h"
+
+#include "../common/infra/Pimpl.h"
+
+#include <memory>
+
+namespace psy {
+namespace C {
+
+/**
+ * \brief The LexemeInterner class.
+ *
+ * A store of unique lexemes (identifiers, constants, and string literals)
+ * that may be shared by many syntax trees, which may be lexed concurrently.
+ * The lexemes of the trees that share an interner are unique across these
+ * trees, so they may be compared by address; and each one stays alive for
+ * as long as the interner does.
+ *
+ * \see ParseOptions::setLexemeInterner
+ * \see Compilation::lexemeInterner
+ */
+class PSY_C_API LexemeInterner
+{
+public:
+    LexemeInterner();
+    LexemeInterner(const LexemeInterner&) = delete;
+    LexemeInterner& operator=(const LexemeInterner&) = delete;
+    ~LexemeInterner();
+
+    const Identifier* identifier(const char* s, unsigned int size);
+    const IntegerConstant* integerConstant(const char* s, unsigned int size);
+    const FloatingConstant* floatingConstant(const char* s, unsigned int size);
+    const CharacterConstant* characterConstant(const char* s, unsigned int size);
+    const StringLiteral* stringLiteral(const char* s, unsigned int size);
+
+    /**
+     * The count of identifiers in \c this interner.
+     */
+    unsigned int identifierCount() const;
+
+private:
+    DECL_PIMPL(LexemeInterner);
+};
+
+} // C
+} // psy
+
+#endif
@@ -26,10 +26,17 @@
 
 #include "syntax/SyntaxLexemes.h"
 
-#include <cctype>
+#include "../common/text/CharacterClass.h"
+#include "../common/text/TextChange.h"
+#include "../common/text/TextScanner.h"
+
+#include <algorithm>
 #include <cstring>
 #include <iostream>
-#include <stack>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace psy;
 using namespace C;
@@ -44,21 +51,30 @@ const char* const kBegin = "begin";
 const char* const kEnd = "end";
 const char* const kExpansion = "expansion";
 
+// The minimum size of a chunk (of text) that is worth lexing in a thread.
+const std::size_t kMinChunkSize = 1 << 18;
+
 } // anonymous
 
 Lexer::Lexer(SyntaxTree* tree)
     : tree_(tree)
-    , text_(tree->text().rawText())
-    , c_strBeg_(text_.c_str())
-    , c_strEnd_(text_.c_str() + text_.size())
+    , c_strBeg_(tree->text().c_str())
+    , c_strEnd_(tree->text().c_str() + tree->text().size())
+    , classificationMask_(classificationMask(tree->options()))
+    , UTF16OffsetsTracked_(tree->options().IsUTF16OffsetsTracked())
     , yytext_(c_strBeg_ - 1)
     , yy_(yytext_)
     , yychar_('\n')
-    , yylineno_(1)
-    , yycolumn_(0)
     , offset_(~0)  // Start immediately "before" 0.
+    , firstTkOffset_(~0)
     , withinLogicalLine_(false)
     , rawSyntaxK_splitTk(0)
+    , expansionsMarked_(false)
+    , curExpansionIdx_(0)
+    , openBracketCnt_{ 0, 0, 0 }
+    , bracketScanTkIdx_(1)
+    , streamStarted_(false)
+    , streamEnded_(false)
     , diagnosticsReporter_(this)
 {}
 
@@ -73,6 +89,20 @@ bool isByteOfMultiByteCP(unsigned char byte)
     return byte & 0x80;
 }
 
+const char* skipDigits(const char* p)
+{
+    while (CharacterClass::isDigit(*p))
+        ++p;
+    return p;
+}
+
+const char* skipHexadecimalDigits(const char* p)
+{
+    while (CharacterClass::isHexDigit(*p))
+        ++p;
+    return p;
+}
+
 bool isRawStringLiteral(std::uint16_t rawSyntaxK)
 {
     switch (rawSyntaxK) {
@@ -100,32 +130,86 @@ bool isMultiLineToken(std::uint16_t rawSyntaxK)
 
 void Lexer::lex()
 {
-    // Marker (invalid) token.
-    tree_->addToken(SyntaxToken(nullptr));
+    auto threadCnt = tree_->options().lexingThreadCount();
+    if (threadCnt != 1) {
+        if (!threadCnt)
+            threadCnt = std::thread::hardware_concurrency();
+        auto chunkCnt = std::min<std::size_t>(threadCnt, (c_strEnd_ - c_strBeg_) / kMinChunkSize);
+        if (chunkCnt > 1 && lexInChunks(chunkCnt))
+            return;
+    }
 
     // Line and column...
-    tree_->relayLineDirective(0, 1, tree_->filePath());
-    tree_->relayLineStart(0);
-    std::vector<std::pair<unsigned int, unsigned int>> expansions;
-    unsigned int curExpansionIdx = 0;
+    tree_->relayLineDirective(0, 1, tree_->fileId());
+
+    lexTokens([] (const LexedTokens::Record&) { return false; },
+              [] () { return false; });
+    matchBrackets();
+}
+
+/**
+ * Lex (at least) \p tkCnt more tokens, or up to the EOF, into the tree, for a
+ * parser to which the tokens are streamed (as opposed to lexed altogether up
+ * front). Return whether the EOF is lexed.
+ */
+bool Lexer::lexStreamed(unsigned int tkCnt)
+{
+    if (streamEnded_)
+        return true;
+
+    if (!streamStarted_) {
+        streamStarted_ = true;
+
+        // Line and column...
+        tree_->relayLineDirective(0, 1, tree_->fileId());
+    }
 
-    // Open/close brace tracking.
-    std::stack<unsigned> braces;
+    const auto tkCntLimit = tree_->tokenCount() + tkCnt;
+    lexTokens([] (const LexedTokens::Record&) { return false; },
+              [this, tkCntLimit] () { return tree_->tokenCount() >= tkCntLimit; });
+    matchBrackets();
 
-    SyntaxToken tk(tree_);
+    streamEnded_ = tree_->tokens().rawKindAt(tree_->tokenCount() - 1) == EndOfFile;
+    return streamEnded_;
+}
+
+/**
+ * Lex streamed tokens until the bracket at \p openTkIdx is either matched or
+ * left unmatched for good, so that it's matched as if the entire text had
+ * been lexed up front.
+ */
+void Lexer::lexStreamedUntilClosed(LexedTokens::IndexType openTkIdx)
+{
+    while (!streamEnded_
+               && std::binary_search(openBrackets_.begin(), openBrackets_.end(), openTkIdx)) {
+        lexStreamed(kStreamedTkCnt);
+    }
+}
+
+/**
+ * Lex tokens, from the current character, into the tree: until the EOF, until
+ * a token for which \p resync is \c true (that token isn't added), or until
+ * \p stop is \c true after a token is added.
+ */
+template <class ResyncT, class StopT>
+void Lexer::lexTokens(ResyncT resync, StopT stop)
+{
+    LexedTokens::Record tk;
 
     do {
         yylex(&tk);
 
 LexEntry:
         if (tk.isKind(HashToken) && tk.isAtStartOfLine()) {
-            auto offset = tk.charOffset_;
+            auto offset = tk.byteOffset_;
             yylex(&tk);
 
             if (!tk.isAtStartOfLine()
                     && tk.isKind(IdentifierToken)
                     && !strcmp(tk.identifier_->c_str(), kExpansion)) {
                 // A (Qt Creator-specific) macro mark.
+                expansionsMarked_ = true;
+                tree_->setRelexable(false);
                 yylex(&tk);
 
                 if (!tk.isAtStartOfLine() && tk.isKind(IdentifierToken)) {
@@ -150,10 +234,10 @@ LexEntry:
                                 // Get the total number of generated tokens and specify "null"
                                 // information for them.
                                 auto all = strtoul(tk.valueText_c_str(), 0, 0);
-                                auto prevSize = expansions.size();
-                                expansions.resize(prevSize + all);
-                                std::fill(expansions.begin() + prevSize,
-                                          expansions.end(),
+                                auto prevSize = expansions_.size();
+                                expansions_.resize(prevSize + all);
+                                std::fill(expansions_.begin() + prevSize,
+                                          expansions_.end(),
                                           std::make_pair(0, 0));
 
                                 yylex(&tk);
@@ -166,14 +250,14 @@ LexEntry:
                                 yylex(&tk);
 
                                 // Store line and column for this non-generated token.
-                                expansions.push_back(std::make_pair(lineno, column));
+                                expansions_.push_back(std::make_pair(lineno, column));
                             }
                         }
                     }
                     else if (!strcmp(tk.identifier_->c_str(), kEnd)) {
                         // The end of an expansion section.
-                        expansions.clear();
-                        curExpansionIdx = 0;
+                        expansions_.clear();
+                        curExpansionIdx_ = 0;
                         yylex(&tk);
                     }
                 }
@@ -193,7 +277,7 @@ LexEntry:
                     if (!tk.isAtStartOfLine()
                             && tk.isKind(StringLiteralToken)) {
                         auto fileName = tree_->stringLiteral(tk.string_->c_str(), tk.string_->size());
-                        tree_->relayLineDirective(offset, lineno, fileName->c_str());
+                        tree_->relayLineDirective(offset, lineno, tree_->fileIdOf(fileName));
                         yylex(&tk);
                     }
                 }
@@ -202,14 +286,8 @@ LexEntry:
             }
             goto LexEntry;
         }
-        else if (tk.kind() == OpenBraceToken) {
-            braces.push(tree_->tokenCount());
-        }
-        else if (tk.kind() == CloseBraceToken && !braces.empty()) {
-            auto idx = braces.top();
-            braces.pop();
-            if (idx < tree_->tokenCount())
-                tree_->tokenAt(idx).matchingBracket_ = tree_->tokenCount();
+        else if (resync(tk)) {
+            return;
         }
         else if (tk.isComment()) {
             tree_->_comments.push_back(tk);
@@ -219,32 +297,580 @@ LexEntry:
 
         bool isExpanded = false;
         bool isGenerated = false;
-        if (!expansions.empty() && curExpansionIdx < expansions.size()) {
+        if (!expansions_.empty() && curExpansionIdx_ < expansions_.size()) {
             isExpanded = true;
-            const std::pair<unsigned int, unsigned int>& p = expansions[curExpansionIdx];
+            const std::pair<unsigned int, unsigned int>& p = expansions_[curExpansionIdx_];
             if (p.first)
-                tree_->relayExpansion(tk.charStart(), p);
+                tree_->relayExpansion(tk.byteStart(), p);
             else
                 isGenerated = true;
-            ++curExpansionIdx;
+            ++curExpansionIdx_;
         }
         tk.BF_.expanded_ = isExpanded;
         tk.BF_.generated_ = isGenerated;
 
         tree_->addToken(tk);
     }
-    while (tk.kind());
+    while (tk.kind() && !stop());
+}
+
+/**
+ * Match the brackets (parentheses, square brackets, and braces) of the lexed
+ * tokens, in both directions, so that a balanced region may be skipped over
+ * in constant time.
+ *
+ * A closing bracket is matched to the nearest unmatched opening one of the
+ * same kind, if any (otherwise, it's left unmatched); the opening brackets
+ * in between are left unmatched. Therefore, matched pairs never cross.
+ *
+ * Only the tokens lexed since the previous call are scanned: the brackets
+ * that are still open are kept across calls, for streamed tokens.
+ */
+void Lexer::matchBrackets()
+{
+    auto& tokens = tree_->tokens();
+
+    auto bracketOf = [] (std::uint16_t rawSyntaxK) {
+        switch (rawSyntaxK) {
+            case OpenParenToken:
+            case CloseParenToken:
+                return 0;
+            case OpenBracketToken:
+            case CloseBracketToken:
+                return 1;
+            default:
+                return 2;
+        }
+    };
+
+    const auto tkCnt = tokens.count();
+    for (auto tkIdx = bracketScanTkIdx_; tkIdx < tkCnt; ++tkIdx) {
+        switch (auto rawSyntaxK = tokens.rawKindAt(tkIdx)) {
+            case OpenParenToken:
+            case OpenBracketToken:
+            case OpenBraceToken: {
+                auto bracket = bracketOf(rawSyntaxK);
+                openBrackets_.push_back(tkIdx);
+                openBracketKinds_.push_back(bracket);
+                ++openBracketCnt_[bracket];
+                break;
+            }
+
+            case CloseParenToken:
+            case CloseBracketToken:
+            case CloseBraceToken: {
+                auto bracket = bracketOf(rawSyntaxK);
+                if (!openBracketCnt_[bracket])
+                    break;
+                while (true) {
+                    auto openIdx = openBrackets_.back();
+                    auto openBracket = openBracketKinds_.back();
+                    openBrackets_.pop_back();
+                    openBracketKinds_.pop_back();
+                    --openBracketCnt_[openBracket];
+                    if (openBracket == bracket) {
+                        // The opening bracket may have been released.
+                        if (openIdx >= tokens.firstIndex())
+                            tokens.setMatchingBracket(openIdx, tkIdx);
+                        tokens.setMatchingBracket(tkIdx, openIdx);
+                        break;
+                    }
+                }
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+    bracketScanTkIdx_ = tkCnt;
+}
+
+namespace {
+
+/*
+ * Whether the character at \p p continues a token (of an identifier or of a
+ * number) that starts before it.
+ */
+bool continuesToken(const char* beg, const char* p)
+{
+    return p > beg
+            && (CharacterClass::isIdentifierContinue(p[-1])
+                    || isByteOfMultiByteCP(p[-1]));
+}
+
+bool startsRawStringLiteral(const char* beg, const char* quote)
+{
+    if (quote == beg || quote[-1] != 'R')
+        return false;
+
+    const char* prefix = quote - 1;
+    if (prefix - beg >= 1
+            && (prefix[-1] == 'L' || prefix[-1] == 'u' || prefix[-1] == 'U')
+            && !continuesToken(beg, prefix - 1)) {
+        return true;
+    }
+    if (prefix - beg >= 2
+            && prefix[-1] == '8'
+            && prefix[-2] == 'u'
+            && !continuesToken(beg, prefix - 2)) {
+        return true;
+    }
+    return !continuesToken(beg, prefix);
+}
+
+const char* skipRawStringLiteral(const char* p, const char* end)
+{
+    const char* delim = p;
+    while (p < end && *p != '(') {
+        if (*p == ')' || *p == '\\' || CharacterClass::isSpace(*p))
+            return p;
+        ++p;
+    }
+    if (p == end)
+        return end;
+
+    std::string closing = ")" + std::string(delim, p) + "\"";
+    auto it = std::search(p + 1, end, closing.begin(), closing.end());
+    return it == end ? end : it + closing.size();
+}
+
+const char* skipQuoted(const char* p, const char* end, char quote)
+{
+    while (p < end) {
+        if (*p == quote)
+            return p + 1;
+        if (*p == '\n')
+            return p;
+        p += *p == '\\' ? 2 : 1;
+    }
+    return end;
+}
+
+const char* skipSingleLineComment(const char* p, const char* end)
+{
+    while (p < end && *p != '\n')
+        p += *p == '\\' ? 2 : 1;
+    return std::min(p, end);
+}
+
+const char* skipMultiLineComment(const char* p, const char* end)
+{
+    while ((p = static_cast<const char*>(std::memchr(p, '*', end - p)))) {
+        if (p[1] == '/')
+            return p + 2;
+        ++p;
+    }
+    return end;
+}
+
+bool endsInLineContinuation(const char* beg, const char* newline)
+{
+    const char* p = newline;
+    while (p > beg && p[-1] != '\n' && CharacterClass::isSpace(p[-1]))
+        --p;
+    return p > beg && p[-1] == '\\';
+}
+
+/*
+ * Split the text, from \p beg to \p end, into (at most) \p chunkCnt chunks of
+ * roughly the same size. A chunk boundary is a line start that, according to
+ * a pre-scan of the text, lies outside a comment, a string literal (raw or not),
+ * or a character constant, and that doesn't follow a line continuation.
+ */
+std::vector<const char*> findChunkBoundaries(const char* beg,
+                                             const char* end,
+                                             std::size_t chunkCnt)
+{
+    std::vector<const char*> bounds { beg };
+    const std::size_t chunkSize = (end - beg) / chunkCnt;
+    const char* target = beg + chunkSize;
+
+    const char* p = beg;
+    while (p < end && bounds.size() < chunkCnt) {
+        switch (*p) {
+            case '\n':
+                ++p;
+                if (p >= target
+                        && p < end
+                        && !endsInLineContinuation(beg, p - 1)) {
+                    bounds.push_back(p);
+                    target = p + chunkSize;
+                }
+                break;
+
+            case '/':
+                if (p[1] == '/')
+                    p = skipSingleLineComment(p + 2, end);
+                else if (p[1] == '*')
+                    p = skipMultiLineComment(p + 2, end);
+                else
+                    ++p;
+                break;
+
+            case '"':
+                if (startsRawStringLiteral(beg, p))
+                    p = skipRawStringLiteral(p + 1, end);
+                else
+                    p = skipQuoted(p + 1, end, '"');
+                break;
+
+            case '\'':
+                p = skipQuoted(p + 1, end, '\'');
+                break;
+
+            default:
+                ++p;
+                break;
+        }
+    }
+    bounds.push_back(end);
+
+    return bounds;
+}
+
+} // anonymous
+
+/**
+ * Lex the text in (at most) \p chunkCnt chunks, each one in a thread, and
+ * stitch the tokens of the chunks together. The chunks are lexed into trees
+ * of their own, from which the tokens are moved, with rebased offsets, into
+ * \c this lexer's tree; the lexemes of the chunks are merged into the tables
+ * of the tree (unless they come from a shared interner, and are the same).
+ *
+ * A chunk is a slice of the text (not a copy of it), so only the last one
+ * is followed by a null character; the others end at a line start, where
+ * the lexer stops upon reaching the end of the text.
+ *
+ * If a chunk isn't lexed independently from the one that precedes it (e.g.,
+ * the pre-scan was misled by a construct that ended up in its boundary, and
+ * the lexer ran past its end), or if it contains an expansion mark or a
+ * diagnostic, nothing is stitched and \c false is returned, so that the text
+ * is lexed sequentially.
+ */
+bool Lexer::lexInChunks(unsigned int chunkCnt)
+{
+    auto bounds = findChunkBoundaries(c_strBeg_, c_strEnd_, chunkCnt);
+    chunkCnt = bounds.size() - 1;
+    if (chunkCnt < 2)
+        return false;
+
+    ParseOptions options = tree_->options();
+    options.setLexingThreadCount(1);
+    const std::string filePath = tree_->filePath();
+
+    struct LexedChunk
+    {
+        std::unique_ptr<SyntaxTree> tree_;
+        unsigned int firstTkOffset_;
+        bool independent_;
+    };
+    std::vector<LexedChunk> chunks(chunkCnt);
+
+    auto lexChunk = [&] (unsigned int chunkIdx) {
+        auto& chunk = chunks[chunkIdx];
+        const auto chunkSize = bounds[chunkIdx + 1] - bounds[chunkIdx];
+        chunk.tree_.reset(new SyntaxTree(tree_->text().slice(bounds[chunkIdx] - c_strBeg_,
+                                                             chunkSize),
+                                         options,
+                                         filePath));
+        Lexer lexer(chunk.tree_.get());
+        lexer.lex();
+        const auto& chunkTokens = chunk.tree_->tokens();
+        chunk.independent_ = !lexer.rawSyntaxK_splitTk
+                && !lexer.expansionsMarked_
+                && !chunk.tree_->diagnosticCount()
+                && chunkTokens.byteOffsetAt(chunkTokens.count() - 1) == chunkSize;
+
+        // The first token lexed (stored or not) is the one that'd inherit
+        // whitespace pending from the preceding chunk.
+        chunk.firstTkOffset_ = lexer.firstTkOffset_;
+    };
+
+    std::vector<std::thread> workers;
+    for (auto chunkIdx = 1U; chunkIdx < chunkCnt; ++chunkIdx)
+        workers.emplace_back(lexChunk, chunkIdx);
+    lexChunk(0);
+    for (auto& worker : workers)
+        worker.join();
+
+    for (const auto& chunk : chunks) {
+        if (!chunk.independent_)
+            return false;
+    }
 
-    for (; !braces.empty(); braces.pop()) {
-        auto idx = braces.top();
-        tree_->tokenAt(idx).matchingBracket_ = tree_->tokenCount();
+    // Line and column...
+    tree_->relayLineDirective(0, 1, tree_->fileId());
+
+    unsigned int charBase = 0;
+    bool pendingLeadingWS = false;
+    for (auto chunkIdx = 0U; chunkIdx < chunkCnt; ++chunkIdx) {
+        const auto& chunk = chunks[chunkIdx];
+        SyntaxTree* chunkTree = chunk.tree_.get();
+        const unsigned int byteBase = bounds[chunkIdx] - c_strBeg_;
+
+        SyntaxTree::LexemeMap lexemes;
+        tree_->mergeLexemes(chunkTree, lexemes);
+
+        auto rebase = [&] (LexedTokens::Record tk) {
+            if (pendingLeadingWS && tk.byteOffset_ == chunk.firstTkOffset_)
+                tk.BF_.hasLeadingWS_ = true;
+            tk.byteOffset_ += byteBase;
+            tk.charOffset_ += charBase;
+            if (tk.lexeme_ && !options.lexemeInterner())
+                tk.lexeme_ = lexemes[tk.lexeme_];
+            return tk;
+        };
+
+        // Skip the marker token and, except in the last chunk, the EOF.
+        auto tkCnt = chunkTree->tokenCount();
+        if (chunkIdx != chunkCnt - 1)
+            --tkCnt;
+
+        for (auto tkIdx = 1U; tkIdx < tkCnt; ++tkIdx)
+            tree_->addToken(rebase(chunkTree->tokens().recordAt(tkIdx)));
+
+        for (const auto& tk : chunkTree->_comments)
+            tree_->_comments.push_back(rebase(tk));
+
+        // Skip the line directive of the chunk's start.
+        const auto& lineDirectives = chunkTree->lineDirectives();
+        for (auto it = lineDirectives.begin() + 1; it != lineDirectives.end(); ++it)
+            tree_->relayLineDirective(it->offset() + byteBase, it->lineno(), it->fileId());
+
+        // Whitespace that isn't followed by a token, within the chunk, is
+        // recorded in its EOF.
+        const auto eof = chunkTree->tokens().recordAt(chunkTree->tokenCount() - 1);
+        pendingLeadingWS = eof.BF_.hasLeadingWS_
+                || (pendingLeadingWS && chunk.firstTkOffset_ == eof.byteOffset_);
+        charBase += eof.charOffset_;
+    }
+
+    matchBrackets();
+
+    return true;
+}
+
+namespace {
+
+bool isBracket(std::uint16_t rawSyntaxK)
+{
+    switch (rawSyntaxK) {
+        case OpenParenToken:
+        case CloseParenToken:
+        case OpenBracketToken:
+        case CloseBracketToken:
+        case OpenBraceToken:
+        case CloseBraceToken:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // anonymous
+
+/**
+ * Relex the text of the tree, which is that of the \p baseTree as changed by
+ * the \p change, reusing the tokens of the \p baseTree that are unaffected by
+ * the \p change: those of the lines that precede it (lexing restarts at a line
+ * start, where the lexer is in its initial state), and those after the point
+ * where the relexed tokens resynchronize (i.e., become equal, up to a shift)
+ * with the ones of the \p baseTree.
+ *
+ * The reused tokens are copied in bulk, and so are their matching brackets,
+ * which are shifted past the change; only if the change alters the sequence
+ * of brackets are they matched anew.
+ *
+ * Expansion marks and lexer diagnostics aren't reproduced in this manner;
+ * when they are around, \c false is returned, so that the text is lexed anew.
+ */
+bool Lexer::relex(const SyntaxTree* baseTree, const TextChange& change)
+{
+    if (!baseTree->isRelexable())
+        return false;
+
+    const auto& baseTokens = baseTree->tokens();
+    const auto baseTkCnt = baseTree->tokenCount();
+
+    const auto& span = change.span();
+    const auto& newText = change.newText();
+    const unsigned int changeEnd = span.start() + newText.size();
+    const unsigned int byteDelta = newText.size() - (span.end() - span.start());
+    unsigned int charDelta = byteDelta;
+    if (UTF16OffsetsTracked_) {
+        unsigned int insertedUnits = 0;
+        TextScanner::findAnyOfCountingUTF16(newText.c_str(),
+                                            newText.c_str() + newText.size(),
+                                            '\0', '\0', '\0',
+                                            insertedUnits);
+        unsigned int removedUnits = 0;
+        TextScanner::findAnyOfCountingUTF16(baseTree->text().c_str() + span.start(),
+                                            baseTree->text().c_str() + span.end(),
+                                            '\0', '\0', '\0',
+                                            removedUnits);
+        charDelta = insertedUnits - removedUnits;
+    }
+
+    // The last token whose lookahead character (the one after it) precedes
+    // the change, if any, and that ends a line, is where lexing restarts.
+    LexedTokens::IndexType lo = 1;
+    LexedTokens::IndexType hi = baseTkCnt - 1;
+    while (lo < hi) {
+        auto mid = lo + (hi - lo) / 2;
+        if (baseTokens.byteOffsetAt(mid) + baseTokens.byteSizeAt(mid) < span.start())
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    auto restartTkIdx = lo - 1;
+    while (restartTkIdx && !baseTokens.flagsAt(restartTkIdx + 1).atStartOfLine_)
+        --restartTkIdx;
+
+    tree_->relayLineDirective(0, 1, tree_->fileId());
+
+    unsigned int restartOffset = 0;
+    if (restartTkIdx) {
+        tree_->tokens().append(baseTokens, 1, restartTkIdx + 1, 0, 0);
+
+        const auto restartTk = baseTokens.recordAt(restartTkIdx);
+        restartOffset = restartTk.byteEnd();
+        yytext_ = c_strBeg_ + restartOffset;
+        yychar_ = *yytext_;
+        offset_ = restartTk.charOffset_ + restartTk.charSize_;
+
+        // As after any token (that isn't split by the end of the text).
+        withinLogicalLine_ = false;
+        rawSyntaxK_splitTk = 0;
+    }
+
+    for (auto tk : baseTree->_comments) {
+        if (tk.byteOffset_ >= restartOffset)
+            break;
+        tree_->_comments.push_back(tk);
+    }
+
+    const auto& lineDirectives = baseTree->lineDirectives();
+    for (auto it = lineDirectives.begin() + 1; it != lineDirectives.end(); ++it) {
+        if (it->offset() >= restartOffset)
+            break;
+        tree_->relayLineDirective(it->offset(), it->lineno(), it->fileId());
+    }
+
+    auto baseTkIdx = restartTkIdx + 1;
+    bool resynced = false;
+    lexTokens([&] (const LexedTokens::Record& tk) {
+        if ((tk.isComment() && tk.kind() != Keyword_ExtPSY_omission)
+                || tk.byteOffset_ < changeEnd) {
+            return false;
+        }
+
+        const unsigned int baseOffset = tk.byteOffset_ - byteDelta;
+        while (baseTkIdx < baseTkCnt && baseTokens.byteOffsetAt(baseTkIdx) < baseOffset)
+            ++baseTkIdx;
+        if (baseTkIdx == baseTkCnt)
+            return false;
+
+        const auto baseTk = baseTokens.recordAt(baseTkIdx);
+        resynced = baseTk.byteOffset_ == baseOffset
+                && baseTk.charOffset_ + charDelta == tk.charOffset_
+                && baseTk.rawSyntaxK_ == tk.rawSyntaxK_
+                && baseTk.byteSize_ == tk.byteSize_
+                && baseTk.charSize_ == tk.charSize_
+                && baseTk.BF_all_ == tk.BF_all_;
+        return resynced;
+    },
+    [] () { return false; });
+
+    if (expansionsMarked_)
+        return false;
+
+    auto& tokens = tree_->tokens();
+    const auto relexedEndTkIdx = tokens.count();
+    const auto baseResyncTkIdx = resynced ? baseTkIdx : baseTkCnt;
+
+    if (resynced) {
+        const unsigned int resyncOffset = baseTokens.byteOffsetAt(baseTkIdx);
+
+        tokens.append(baseTokens, baseTkIdx, baseTkCnt, byteDelta, charDelta);
+
+        for (auto tk : baseTree->_comments) {
+            if (tk.byteOffset_ < resyncOffset)
+                continue;
+            tk.byteOffset_ += byteDelta;
+            tk.charOffset_ += charDelta;
+            tree_->_comments.push_back(tk);
+        }
+
+        for (auto it = lineDirectives.begin() + 1; it != lineDirectives.end(); ++it) {
+            if (it->offset() < resyncOffset)
+                continue;
+            tree_->relayLineDirective(it->offset() + byteDelta, it->lineno(), it->fileId());
+        }
+    }
+
+    // The brackets replaced by the change, and those that replace them.
+    std::vector<LexedTokens::IndexType> baseBrackets;
+    for (auto tkIdx = restartTkIdx + 1; tkIdx < baseResyncTkIdx; ++tkIdx) {
+        if (isBracket(baseTokens.rawKindAt(tkIdx)))
+            baseBrackets.push_back(tkIdx);
+    }
+    std::vector<LexedTokens::IndexType> brackets;
+    for (auto tkIdx = restartTkIdx + 1; tkIdx < relexedEndTkIdx; ++tkIdx) {
+        if (isBracket(tokens.rawKindAt(tkIdx)))
+            brackets.push_back(tkIdx);
+    }
+
+    const bool sameBrackets = baseBrackets.size() == brackets.size()
+            && std::equal(baseBrackets.begin(), baseBrackets.end(), brackets.begin(),
+                          [&] (auto baseIdx, auto idx) {
+                              return baseTokens.rawKindAt(baseIdx) == tokens.rawKindAt(idx);
+                          });
+    if (!sameBrackets) {
+        for (auto tkIdx = 1U; tkIdx < tokens.count(); ++tkIdx)
+            tokens.setMatchingBracket(tkIdx, LexedTokens::invalidIndex());
+        matchBrackets();
+        return true;
+    }
+
+    // The sequence of brackets is the same: so is the matching among them,
+    // which only has to be shifted (unless the brackets didn't move at all).
+    auto shift = [&] (LexedTokens::IndexType baseIdx) {
+        if (baseIdx <= restartTkIdx)
+            return baseIdx;
+        if (baseIdx >= baseResyncTkIdx)
+            return baseIdx - baseResyncTkIdx + relexedEndTkIdx;
+        auto it = std::lower_bound(baseBrackets.begin(), baseBrackets.end(), baseIdx);
+        return brackets[it - baseBrackets.begin()];
+    };
+    for (auto i = 0U; i < brackets.size(); ++i) {
+        auto matchIdx = baseTokens.matchingBracketAt(baseBrackets[i]);
+        if (matchIdx != LexedTokens::invalidIndex())
+            tokens.setMatchingBracket(brackets[i], shift(matchIdx));
+    }
+    bracketScanTkIdx_ = tokens.count();
+
+    if (relexedEndTkIdx == baseResyncTkIdx && baseBrackets == brackets)
+        return true;
+
+    for (auto tkIdx = 1U; tkIdx <= restartTkIdx; ++tkIdx) {
+        auto matchIdx = tokens.matchingBracketAt(tkIdx);
+        if (matchIdx > restartTkIdx)
+            tokens.setMatchingBracket(tkIdx, shift(matchIdx));
     }
+    for (auto tkIdx = relexedEndTkIdx; tkIdx < tokens.count(); ++tkIdx) {
+        auto matchIdx = tokens.matchingBracketAt(tkIdx);
+        if (matchIdx != LexedTokens::invalidIndex())
+            tokens.setMatchingBracket(tkIdx, shift(matchIdx));
+    }
+
+    return true;
 }
 
-void Lexer::yylex_core(SyntaxToken* tk)
+void Lexer::yylex_core(LexedTokens::Record* tk)
 {
 LexEntry:
-    while (yychar_ && std::isspace(yychar_)) {
+    while (yychar_ && CharacterClass::isSpace(yychar_)) {
         if (yychar_ == '\n') {
             tk->BF_.atStartOfLine_ = !withinLogicalLine_;
             tk->BF_.joined_ = withinLogicalLine_;
@@ -256,14 +882,19 @@ LexEntry:
         }
         else {
             tk->BF_.hasLeadingWS_ = true;
+            yyinputRun(TextScanner::skipHorizontalWhitespace(yytext_, c_strEnd_));
+            continue;
         }
         yyinput();
+
+        // The end of a slice of a text, which isn't null-terminated, is at
+        // a line start (see Lexer::lexInChunks).
+        if (yytext_ >= c_strEnd_)
+            yychar_ = 0;
     }
 
     yy_ = yytext_;
 
-    tk->lineno_ = yylineno_;
-    tk->column_ = yycolumn_ - 1;
     tk->byteOffset_ = yytext_ - c_strBeg_;
     tk->charOffset_ = offset_;
 
@@ -279,8 +910,10 @@ LexEntry:
             || rawSyntaxK_splitTk == Keyword_ExtPSY_omission) {
         auto tkRawKind = rawSyntaxK_splitTk;
         while (yychar_) {
-            if (yychar_ != '*')
+            if (yychar_ != '*') {
                 yyinput();
+                yyinputUntilAnyOf('*', '\n', '\n');
+            }
             else {
                 yyinput();
                 if (yychar_ == '/') {
@@ -405,7 +1038,7 @@ LexEntry:
                     tk->rawSyntaxK_ = Error;
                 }
             }
-            else if (std::isdigit(yychar_)) {
+            else if (CharacterClass::isDigit(yychar_)) {
                 tk->rawSyntaxK_ = FloatingConstantToken;
                 lexIntegerOrFloatingConstant(tk);
             }
@@ -510,7 +1143,7 @@ LexEntry:
                     if (yychar_ == '<')
                         yyinput();
 
-                    if (!yychar_ || std::isspace(yychar_))
+                    if (!yychar_ || CharacterClass::isSpace(yychar_))
                         syntaxK = MultiLineDocumentationCommentTrivia;
                 }
                 else if (yychar_ == '.') {
@@ -524,6 +1157,7 @@ LexEntry:
                 while (yychar_) {
                     if (yychar_ != '*') {
                         yyinput();
+                        yyinputUntilAnyOf('*', '\n', '\n');
                     }
                     else {
                         yyinput();
@@ -742,13 +1376,11 @@ LocalExit:
                     lexIdentifier(tk);
                 }
             }
-            else if (std::isalpha(ch)
-                         || ch == '_'
-                         || ch == '$'
+            else if (CharacterClass::isIdentifierStart(ch)
                          || isByteOfMultiByteCP(ch)) {
                 lexIdentifier(tk, yytext_ - yy_ - 1);
             }
-            else if (std::isdigit(ch)) {
+            else if (CharacterClass::isDigit(ch)) {
                 lexIntegerOrFloatingConstant(tk);
             }
             else {
@@ -759,7 +1391,7 @@ LocalExit:
     }
 }
 
-void Lexer::yylex(SyntaxToken* tk)
+void Lexer::yylex(LexedTokens::Record* tk)
 {
     tk->setup();
 
@@ -767,33 +1399,35 @@ void Lexer::yylex(SyntaxToken* tk)
 
     tk->byteSize_ = yytext_ - yy_;
     tk->charSize_ = offset_ - tk->charOffset_;
+
+    if (UNLIKELY(firstTkOffset_ == ~0U))
+        firstTkOffset_ = tk->byteOffset_;
 }
 
 /**
  * Process a single unicode code point in an UTF-8 encoded source.
  * Points \c yychar to the byte of the next code point and modifies \a yy
  * to the value pointed by the updated \c yychar; \c offset will be
- * incremented by the number of UTF-16 code units that were needed.
+ * incremented by the number of UTF-16 code units that were needed (or of
+ * bytes, if UTF-16 offsets aren't tracked).
  */
 void Lexer::yyinput_core(const char*& yy,
                          unsigned char& yychar,
-                         unsigned int& yycolumn,
                          unsigned int& offset)
 {
-    ++yycolumn;
     ++offset;
 
     if (UNLIKELY(isByteOfMultiByteCP(yychar))) {
-        // Process multi-byte UTF-8 code point.
-        unsigned int trailBytesCurCP = 1;
-        for (unsigned char c = yychar << 2; isByteOfMultiByteCP(c); c <<= 1)
-            ++trailBytesCurCP;
+        // Process multi-byte UTF-8 code point: the count of leading 1s of
+        // the first byte is that of bytes in the code point.
+        unsigned int trailBytesCurCP =
+                __builtin_clz(~(static_cast<unsigned int>(yychar) << 24)) - 1;
 
+        if (!UTF16OffsetsTracked_)
+            offset += trailBytesCurCP;
         // Code points >= 0x00010000 are represented by two UTF-16 code units.
-        if (trailBytesCurCP >= 3) {
-            ++yycolumn;
+        else if (trailBytesCurCP >= 3)
             ++offset;
-        }
 
         yychar = *(yy += trailBytesCurCP + 1);
     }
@@ -804,12 +1438,41 @@ void Lexer::yyinput_core(const char*& yy,
 
 void Lexer::yyinput()
 {
-    yyinput_core(yytext_, yychar_, yycolumn_, offset_);
+    yyinput_core(yytext_, yychar_, offset_);
+}
 
-    if (UNLIKELY(yychar_ == '\n')) {
-        ++yylineno_;
-        tree_->relayLineStart(offset_ + 1);
-    }
+/**
+ * Consume, at once, the characters from the current one up to (but not
+ * including) the one at \p runEnd; these characters must be ASCII, so the
+ * effect is the same of that of calling \c yyinput for each of them.
+ */
+void Lexer::yyinputRun(const char* runEnd)
+{
+    yyinputRun(runEnd, runEnd - yytext_);
+}
+
+/**
+ * Consume, at once, the characters from the current one up to (but not
+ * including) the one at \p runEnd, which take \p units UTF-16 code units.
+ * A run that reaches the end of the text ends it, even if the text is a
+ * slice that isn't null-terminated (see Lexer::lexInChunks).
+ */
+void Lexer::yyinputRun(const char* runEnd, unsigned int units)
+{
+    offset_ += units;
+    yytext_ = runEnd;
+    yychar_ = yytext_ < c_strEnd_ ? *yytext_ : 0;
+}
+
+/**
+ * Consume the characters, ASCII or not, from the current one up to (but not
+ * including) the first of \p c1, \p c2, or \p c3.
+ */
+void Lexer::yyinputUntilAnyOf(char c1, char c2, char c3)
+{
+    unsigned int units = 0;
+    const char* runEnd = TextScanner::findAnyOfCountingUTF16(yytext_, c_strEnd_, c1, c2, c3, units);
+    yyinputRun(runEnd, UTF16OffsetsTracked_ ? units : runEnd - yytext_);
 }
 
 /**
@@ -817,28 +1480,25 @@ void Lexer::yyinput()
  *
  * \remark 6.4.2.1
  */
-void Lexer::lexIdentifier(SyntaxToken* tk, int advanced)
+void Lexer::lexIdentifier(LexedTokens::Record* tk, int advanced)
 {
     const char* yytext = yytext_ - 1 - advanced;
 
-    while (std::isalnum(yychar_)
-            || yychar_ == '_'
-            || yychar_ == '$'
-            || isByteOfMultiByteCP(yychar_)) {
+    // Skip ASCII characters in bulk; only a multi-byte code point needs
+    // to go through the "regular" input.
+    while (true) {
+        yyinputRun(TextScanner::skipIdentifierCharacters(yytext_, c_strEnd_));
+        if (!isByteOfMultiByteCP(yychar_))
+            break;
         yyinput();
     }
 
     int yyleng = yytext_ - yytext;
 
-    if (tree_->options().IsKeywordsIdentifiersClassified())
-        tk->rawSyntaxK_ = classify(yytext, yyleng, tree_->options());
-    else
-        tk->rawSyntaxK_ = IdentifierToken;
-
-    if (tk->rawSyntaxK_ == IdentifierToken) {
-        tk->rawSyntaxK_ = classifyOperator(yytext, yyleng, tree_->options());
+    bool isOperatorName;
+    tk->rawSyntaxK_ = classify(yytext, yyleng, classificationMask_, isOperatorName);
+    if (tk->rawSyntaxK_ == IdentifierToken || isOperatorName)
         tk->identifier_ = tree_->identifier(yytext, yyleng);
-    }
 }
 
 /**
@@ -846,18 +1506,24 @@ void Lexer::lexIdentifier(SyntaxToken* tk, int advanced)
  *
  * \remark 6.4.4.1, and 6.4.4.2
  */
-void Lexer::lexIntegerOrFloatingConstant(SyntaxToken* tk)
+void Lexer::lexIntegerOrFloatingConstant(LexedTokens::Record* tk)
 {
     const char* yytext = yytext_ - 1;
 
+    if (*yytext == '.') {
+        lexDigitSequence();
+        lexExponentPart();
+        lexFloatingSuffix();
+        goto LexExit;
+    }
+
     if (*yytext == '0' && yychar_) {
         if (yychar_ == 'x'|| yychar_ == 'X') {
             yyinput();
             lexHexadecimalDigitSequence();
 
-            if (yychar_ == '.') {
+            if (yychar_ == '.' || yychar_ == 'p' || yychar_ == 'P') {
                 tk->rawSyntaxK_ = FloatingConstantToken;
-                yyinput();
 
                 if (tree_->options().dialect().std() < LanguageDialect::Std::C99) {
                     diagnosticsReporter_.IncompatibleLanguageDialect(
@@ -865,7 +1531,10 @@ void Lexer::lexIntegerOrFloatingConstant(SyntaxToken* tk)
                                 LanguageDialect::Std::C99);
                 }
 
-                lexHexadecimalDigitSequence();
+                if (yychar_ == '.') {
+                    yyinput();
+                    lexHexadecimalDigitSequence();
+                }
                 lexBinaryExponentPart();
                 lexFloatingSuffix();
             }
@@ -910,8 +1579,8 @@ void Lexer::lexIntegerOrFloatingConstant(SyntaxToken* tk)
             break;
         }
 
-        if (std::isdigit(yychar_)) {
-            yyinput();
+        if (CharacterClass::isDigit(yychar_)) {
+            yyinputRun(skipDigits(yytext_));
         }
         else {
             lexIntegerSuffix();
@@ -920,12 +1589,12 @@ void Lexer::lexIntegerOrFloatingConstant(SyntaxToken* tk)
     }
 
 LexExit:
-    if (std::isalnum(yychar_) || yychar_ == '_') {
+    if (CharacterClass::isIdentifierContinue(yychar_) && yychar_ != '$') {
         tk->rawSyntaxK_ = Error;
         do {
             yyinput();
         }
-        while (std::isalnum(yychar_) || yychar_ == '_');
+        while (CharacterClass::isIdentifierContinue(yychar_) && yychar_ != '$');
     }
     else {
         int yyleng = yytext_ - yytext;
@@ -993,12 +1662,7 @@ void Lexer::lexIntegerSuffix(int suffixCnt)
  */
 void Lexer::lexDigitSequence()
 {
-    if (!std::isdigit(yychar_))
-        return;
-
-    yyinput();
-    while (std::isdigit(yychar_))
-        yyinput();
+    yyinputRun(skipDigits(yytext_));
 }
 
 /**
@@ -1062,11 +1726,7 @@ void Lexer::lexFloatingSuffix()
  */
 void Lexer::lexHexadecimalDigitSequence()
 {
-    while (std::isdigit(yychar_)
-            || (yychar_ >= 'a' && yychar_ <= 'f')
-            || (yychar_ >= 'A' && yychar_ <= 'F')) {
-        yyinput();
-    }
+    yyinputRun(skipHexadecimalDigits(yytext_));
 }
 
 /**
@@ -1074,7 +1734,7 @@ void Lexer::lexHexadecimalDigitSequence()
  *
  * \remark 6.4.4.4
  */
-void Lexer::lexCharacterConstant(SyntaxToken* tk, unsigned char prefix)
+void Lexer::lexCharacterConstant(LexedTokens::Record* tk, unsigned char prefix)
 {
     unsigned int prefixSize = 1;
     if (prefix == 'L')
@@ -1096,7 +1756,7 @@ void Lexer::lexCharacterConstant(SyntaxToken* tk, unsigned char prefix)
  *
  * \remark 6.4.5
  */
-void Lexer::lexStringLiteral(SyntaxToken* tk, unsigned char prefix)
+void Lexer::lexStringLiteral(LexedTokens::Record* tk, unsigned char prefix)
 {
     unsigned int prefixSize = 1;
     if (prefix == 'L')
@@ -1115,7 +1775,7 @@ void Lexer::lexStringLiteral(SyntaxToken* tk, unsigned char prefix)
     lexUntilQuote(tk, '"', prefixSize);
 }
 
-void Lexer::lexRawStringLiteral(SyntaxToken* tk, unsigned char prefix)
+void Lexer::lexRawStringLiteral(LexedTokens::Record* tk, unsigned char prefix)
 {
     const char* yytext = yytext_;
     int delimLeng = -1;
@@ -1134,7 +1794,7 @@ void Lexer::lexRawStringLiteral(SyntaxToken* tk, unsigned char prefix)
         }
         else {
             if (delimLeng == -1) {
-                if (yychar_ == '\\' || std::isspace(yychar_))
+                if (yychar_ == '\\' || CharacterClass::isSpace(yychar_))
                     break;
                 yyinput();
             }
@@ -1206,12 +1866,12 @@ bool Lexer::lexContinuedRawStringLiteral()
 void Lexer::lexBackslash(std::uint16_t rawSyntaxK)
 {
     yyinput();
-    if (yychar_ && !std::isspace(yychar_)) {
+    if (yychar_ && !CharacterClass::isSpace(yychar_)) {
         yyinput();
         return;
     }
 
-    while (yychar_ != '\n' && std::isspace(yychar_))
+    while (yychar_ != '\n' && CharacterClass::isSpace(yychar_))
         yyinput();
 
     if (!yychar_) {
@@ -1222,7 +1882,7 @@ void Lexer::lexBackslash(std::uint16_t rawSyntaxK)
 
     if (yychar_ == '\n') {
         yyinput();
-        while (yychar_ != '\n' && std::isspace(yychar_))
+        while (yychar_ != '\n' && CharacterClass::isSpace(yychar_))
             yyinput();
 
         if (!yychar_)
@@ -1230,7 +1890,7 @@ void Lexer::lexBackslash(std::uint16_t rawSyntaxK)
     }
 }
 
-void Lexer::lexUntilQuote(SyntaxToken* tk, unsigned char quote, unsigned int prefixSize)
+void Lexer::lexUntilQuote(LexedTokens::Record* tk, unsigned char quote, unsigned int prefixSize)
 {
     const char* yytext = yytext_ - 1;
     yytext -= prefixSize;
@@ -1240,12 +1900,14 @@ void Lexer::lexUntilQuote(SyntaxToken* tk, unsigned char quote, unsigned int pre
                && yychar_ != '\n') {
         if (yychar_ == '\\')
             lexBackslash(tk->rawSyntaxK_);
-        else
+        else {
             yyinput();
+            yyinputUntilAnyOf(quote, '\\', '\n');
+        }
     }
 
+    // The prefix, if any, is already in the text.
     int yyleng = yytext_ - yytext + 1;
-    yyleng += prefixSize;
 
     if (yychar_ == quote)
         yyinput();
@@ -1261,7 +1923,9 @@ void Lexer::lexSingleLineComment(std::uint16_t rawSyntaxK)
     while (yychar_ && yychar_ != '\n') {
         if (yychar_ == '\\')
             lexBackslash(rawSyntaxK);
-        else if (yychar_)
+        else if (yychar_) {
             yyinput();
+            yyinputUntilAnyOf('\n', '\\', '\n');
+        }
     }
 }
@@ -29,8 +29,13 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace psy {
+
+class TextChange;
+
 namespace C {
 
 class ParseOptions;
@@ -47,24 +52,54 @@ public:
 
     void lex();
 
+    /**
+     * The mask, computed from the \p options, under which keywords and
+     * operator names are classified by \c Lexer::classify.
+     */
+    static std::uint32_t classificationMask(const ParseOptions& options);
+
+    /**
+     * Classify the identifier \p ident, of length \p size, as a keyword or
+     * an operator name, if it's one under the given \p mask; \p isOperatorName
+     * tells which case it is.
+     */
+    static SyntaxKind classify(const char* ident,
+                               int size,
+                               std::uint32_t mask,
+                               bool& isOperatorName);
+
 private:
     Lexer(SyntaxTree* tree);
 
     friend class SyntaxTree;
+    friend class Parser;
+    friend class TestSyntaxTree;
+
+    bool lexInChunks(unsigned int chunkCnt);
+    bool relex(const SyntaxTree* baseTree, const TextChange& change);
+    template <class ResyncT, class StopT> void lexTokens(ResyncT resync, StopT stop);
+    void matchBrackets();
+
+    /* Streamed tokens */
+    static constexpr unsigned int kStreamedTkCnt = 256;
+    bool lexStreamed(unsigned int tkCnt);
+    void lexStreamedUntilClosed(LexedTokens::IndexType openTkIdx);
 
-    void yylex(SyntaxToken* tk);
-    void yylex_core(SyntaxToken* tk);
+    void yylex(LexedTokens::Record* tk);
+    void yylex_core(LexedTokens::Record* tk);
     void yyinput();
     void yyinput_core(const char*& yy,
                       unsigned char& yychar,
-                      unsigned int& yycolumn,
                       unsigned int& offset);
+    void yyinputRun(const char* runEnd);
+    void yyinputRun(const char* runEnd, unsigned int units);
+    void yyinputUntilAnyOf(char c1, char c2, char c3);
 
     /* 6.4.2 Identifiers */
-    void lexIdentifier(SyntaxToken* tk, int advanced = 0);
+    void lexIdentifier(LexedTokens::Record* tk, int advanced = 0);
 
     /* 6.4.4 Constants */
-    void lexIntegerOrFloatingConstant(SyntaxToken* tk);
+    void lexIntegerOrFloatingConstant(LexedTokens::Record* tk);
     void lexIntegerSuffix(int suffixCnt = 2);
     void lexDigitSequence();
     void lexHexadecimalDigitSequence();
@@ -72,49 +107,56 @@ private:
     void lexBinaryExponentPart();
     void lexSign();
     void lexFloatingSuffix();
-    void lexCharacterConstant(SyntaxToken* tk, unsigned char prefix = 0);
+    void lexCharacterConstant(LexedTokens::Record* tk, unsigned char prefix = 0);
 
     /* 6.4.5 String literals */
-    void lexStringLiteral(SyntaxToken* tk, unsigned char prefix = 0);
-    void lexRawStringLiteral(SyntaxToken* tk, unsigned char hint = 0);
+    void lexStringLiteral(LexedTokens::Record* tk, unsigned char prefix = 0);
+    void lexRawStringLiteral(LexedTokens::Record* tk, unsigned char hint = 0);
     bool lexContinuedRawStringLiteral();
 
-    void lexUntilQuote(SyntaxToken* tk, unsigned char quote, unsigned int prefixSize);
+    void lexUntilQuote(LexedTokens::Record* tk, unsigned char quote, unsigned int prefixSize);
     void lexBackslash(std::uint16_t rawSyntaxK);
     void lexSingleLineComment(std::uint16_t rawSyntaxK);
 
-    static SyntaxKind classify(const char* ident,
-                               int size,
-                               const ParseOptions& options);
-    static SyntaxKind classifyOperator(const char* indent,
-                                       int size,
-                                       const ParseOptions& options);
-
     SyntaxTree* tree_;
-    std::string text_;
     const char* c_strBeg_;
     const char* c_strEnd_;
+    std::uint32_t classificationMask_;
+    bool UTF16OffsetsTracked_;
 
     const char* yytext_;
     const char* yy_;
     unsigned char yychar_;
-    unsigned int yylineno_;
-    unsigned int yycolumn_;
 
     unsigned int offset_;
     unsigned int offsetMarker_;
 
+    // The byte offset of the first token lexed (stored or not).
+    unsigned int firstTkOffset_;
+
     // Line breaks and continuations aren't strictly correct... (see quirks
     // at https://gcc.gnu.org/onlinedocs/cppinternals/Lexer.html).
     bool withinLogicalLine_;
     std::uint16_t rawSyntaxK_splitTk;
 
+    bool expansionsMarked_;
+    std::vector<std::pair<unsigned int, unsigned int>> expansions_;
+    unsigned int curExpansionIdx_;
+
+    std::vector<LexedTokens::IndexType> openBrackets_;
+    std::vector<std::uint8_t> openBracketKinds_;
+    unsigned int openBracketCnt_[3];
+    LexedTokens::IndexType bracketScanTkIdx_;
+
+    bool streamStarted_;
+    bool streamEnded_;
+
     struct DiagnosticsReporter
     {
         DiagnosticsReporter(Lexer* lexer) : lexer_(lexer) {}
         Lexer* lexer_;
 
-        void IncompatibleLanguageDialect(const std::string& feature, LanguageDialect::Std expectedStd);
+        void IncompatibleLanguageDialect(const char* feature, LanguageDialect::Std expectedStd);
 
         static const std::string ID_of_IncompatibleLanguageDialect;
     };
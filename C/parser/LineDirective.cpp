@@ -25,16 +25,21 @@ using namespace psy;
 using namespace C;
 
 LineDirective::LineDirective(unsigned int lineno,
-                             const std::string& fileName,
+                             FileId fileId,
                              unsigned int offset)
     : lineno_(lineno)
-    , fileName_(fileName)
+    , fileId_(fileId)
     , offset_(offset)
 {}
 
-std::string LineDirective::fileName() const
+FileId LineDirective::fileId() const
 {
-    return fileName_;
+    return fileId_;
+}
+
+const std::string& LineDirective::fileName() const
+{
+    return fileId_.path();
 }
 
 unsigned int LineDirective::lineno() const
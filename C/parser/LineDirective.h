@@ -24,6 +24,7 @@
 
 #include "API.h"
 
+#include "../common/location/FileId.h"
 #include "../common/location/LinePosition.h"
 
 #include <string>
@@ -38,13 +39,18 @@ class PSY_C_API LineDirective
 {
 public:
     LineDirective(unsigned int lineno,
-                  const std::string& fileName,
+                  FileId fileId,
                   unsigned int offset);
 
+    /**
+     * The identity of the file.
+     */
+    FileId fileId() const;
+
     /**
      * The file name.
      */
-    std::string fileName() const;
+    const std::string& fileName() const;
 
     /**
      * The line number.
@@ -58,7 +64,7 @@ public:
 
 private:
     unsigned int lineno_;
-    std::string fileName_;
+    FileId fileId_;
     unsigned int offset_;
 };
 
@@ -21,28 +21,41 @@
 
 #include "ParseOptions.h"
 
+#include "LexemeInterner.h"
+
+#include <algorithm>
+
 using namespace psy;
 using namespace C;
 
 ParseOptions::ParseOptions()
-    : bits_(0)
+    : lexingThreadCount_(1)
+    , parsingThreadCount_(1)
+    , bits_(0)
 {
     BF_.keywordIdentifiersClassified_ = true;
+    BF_.UTF16OffsetsTracked_ = true;
 }
 
 ParseOptions::ParseOptions(LanguageDialect dialect)
     : dialect_(std::move(dialect))
+    , lexingThreadCount_(1)
+    , parsingThreadCount_(1)
     , bits_(0)
 {
     BF_.keywordIdentifiersClassified_ = true;
+    BF_.UTF16OffsetsTracked_ = true;
 }
 
 ParseOptions::ParseOptions(LanguageDialect dialect, LanguageExtensions extensions)
     : dialect_(std::move(dialect))
     , extensions_(std::move(extensions))
+    , lexingThreadCount_(1)
+    , parsingThreadCount_(1)
     , bits_(0)
 {
     BF_.keywordIdentifiersClassified_ = true;
+    BF_.UTF16OffsetsTracked_ = true;
 }
 
 ParseOptions::ParseOptions(LanguageDialect dialect,
@@ -51,16 +64,22 @@ ParseOptions::ParseOptions(LanguageDialect dialect,
     : ppOptions_(std::move(ppOptions))
     , dialect_(std::move(dialect))
     , extensions_(std::move(extensions))
+    , lexingThreadCount_(1)
+    , parsingThreadCount_(1)
     , bits_(0)
 {
     BF_.keywordIdentifiersClassified_ = true;
+    BF_.UTF16OffsetsTracked_ = true;
 }
 
 ParseOptions::ParseOptions(PreprocessorOptions ppOptions)
     : ppOptions_(std::move(ppOptions))
+    , lexingThreadCount_(1)
+    , parsingThreadCount_(1)
     , bits_(0)
 {
     BF_.keywordIdentifiersClassified_ = true;
+    BF_.UTF16OffsetsTracked_ = true;
 }
 
 const LanguageDialect& ParseOptions::dialect() const
@@ -89,3 +108,70 @@ ParseOptions& ParseOptions::classifyKeywordIdentifiers(bool yes)
     BF_.keywordIdentifiersClassified_ = yes;
     return *this;
 }
+
+ParseOptions& ParseOptions::trackUTF16Offsets(bool yes)
+{
+    BF_.UTF16OffsetsTracked_ = yes;
+    return *this;
+}
+
+ParseOptions& ParseOptions::deferFunctionBodies(bool yes)
+{
+    BF_.functionBodyParseDeferred_ = yes;
+    return *this;
+}
+
+ParseOptions& ParseOptions::trackTypedefNames(bool yes)
+{
+    BF_.typedefNamesTracked_ = yes;
+    return *this;
+}
+
+ParseOptions& ParseOptions::setLexingThreadCount(unsigned int count)
+{
+    lexingThreadCount_ = count;
+    return *this;
+}
+
+ParseOptions& ParseOptions::setParsingThreadCount(unsigned int count)
+{
+    parsingThreadCount_ = count;
+    return *this;
+}
+
+ParseOptions& ParseOptions::setLexemeInterner(std::shared_ptr<LexemeInterner> interner)
+{
+    lexemeInterner_ = std::move(interner);
+    return *this;
+}
+
+ParseOptions& ParseOptions::setTokenCacheDirectory(const std::string& dirPath)
+{
+    tokenCacheDir_ = dirPath;
+    return *this;
+}
+
+ParseOptions& ParseOptions::setDiagnosticSeverityThreshold(DiagnosticSeverity severity)
+{
+    BF_.diagnosticSeverityThreshold_ = static_cast<int>(severity);
+    return *this;
+}
+
+ParseOptions& ParseOptions::suppressDiagnostic(const std::string& id)
+{
+    if (std::find(suppressedDiagnostics_.begin(), suppressedDiagnostics_.end(), id)
+            == suppressedDiagnostics_.end()) {
+        suppressedDiagnostics_.push_back(id);
+    }
+    return *this;
+}
+
+bool ParseOptions::isDiagnosticReported(std::string_view id, DiagnosticSeverity severity) const
+{
+    if (static_cast<int>(severity) < BF_.diagnosticSeverityThreshold_)
+        return false;
+
+    return suppressedDiagnostics_.empty()
+            || std::find(suppressedDiagnostics_.begin(), suppressedDiagnostics_.end(), id)
+                    == suppressedDiagnostics_.end();
+}
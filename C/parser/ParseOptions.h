@@ -28,11 +28,19 @@
 #include "LanguageExtensions.h"
 #include "PreprocessorOptions.h"
 
+#include "../common/diagnostics/DiagnosticSeverity.h"
+
 #include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace psy {
 namespace C {
 
+class LexemeInterner;
+
 /**
  * \brief The ParseOptions class.
  *
@@ -73,6 +81,114 @@ public:
     bool IsKeywordsIdentifiersClassified() const { return BF_.keywordIdentifiersClassified_; }
     //!@}
 
+    //!@{
+    /**
+     * Whether to track offsets (of tokens and of lines) in UTF-16 code units.
+     * If not, only byte offsets are tracked: the character offset and size of
+     * a token are those in bytes, and so are columns in positions.
+     */
+    ParseOptions& trackUTF16Offsets(bool yes);
+    bool IsUTF16OffsetsTracked() const { return BF_.UTF16OffsetsTracked_; }
+    //!@}
+
+    //!@{
+    /**
+     * Whether to defer the parse of function bodies: the tokens of a body
+     * are skipped, by means of its matching braces, and the body is parsed
+     * only when it's requested (see FunctionDefinitionSyntax::body), which
+     * a traversal (e.g., by a SyntaxVisitor or an Unparser) does.
+     */
+    ParseOptions& deferFunctionBodies(bool yes);
+    bool IsFunctionBodyParseDeferred() const { return BF_.functionBodyParseDeferred_; }
+    //!@}
+
+    //!@{
+    /**
+     * Whether to track, during the parse, the names declared in each scope,
+     * and whether they are typedef-names. When the role of an identifier is
+     * known, the parser doesn't have to guess it (through lookahead, or by
+     * backtracking), and no ambiguity node is created for it. The external
+     * declarations are, then, parsed sequentially (see
+     * setParsingThreadCount). A deferred function body (see
+     * deferFunctionBodies) knows only the names declared before it.
+     */
+    ParseOptions& trackTypedefNames(bool yes);
+    bool IsTypedefNamesTracked() const { return BF_.typedefNamesTracked_; }
+    //!@}
+
+    //!@{
+    /**
+     * The count of threads with which to lex a (large) text: the text is split
+     * into chunks, at line starts, that are lexed concurrently and then stitched
+     * together. The default, 1, means that the text is lexed sequentially; and 0,
+     * that one thread is used per hardware thread.
+     */
+    ParseOptions& setLexingThreadCount(unsigned int count);
+    unsigned int lexingThreadCount() const { return lexingThreadCount_; }
+    //!@}
+
+    //!@{
+    /**
+     * The count of threads with which to parse the external declarations of a
+     * translation unit: the tokens are split into regions, at declaration
+     * boundaries, that are parsed concurrently and then linked together. The
+     * default, 1, means that the declarations are parsed sequentially; and 0,
+     * that one thread is used per hardware thread.
+     */
+    ParseOptions& setParsingThreadCount(unsigned int count);
+    unsigned int parsingThreadCount() const { return parsingThreadCount_; }
+    //!@}
+
+    //!@{
+    /**
+     * The interner of the lexemes of a tree. By default, there's none, and a
+     * tree has lexemes of its own; otherwise, the lexemes are shared by all
+     * trees parsed with the same interner (e.g., those of a Compilation).
+     */
+    ParseOptions& setLexemeInterner(std::shared_ptr<LexemeInterner> interner);
+    LexemeInterner* lexemeInterner() const { return lexemeInterner_.get(); }
+    //!@}
+
+    //!@{
+    /**
+     * The (existing) directory of the token cache. By default, it's empty,
+     * and no cache is used; otherwise, the lexing results of a text are
+     * stored into, and subsequently loaded from, a file in this directory.
+     *
+     * \see TokenCache
+     */
+    ParseOptions& setTokenCacheDirectory(const std::string& dirPath);
+    const std::string& tokenCacheDirectory() const { return tokenCacheDir_; }
+    //!@}
+
+    //!@{
+    /**
+     * The minimum severity of a reported diagnostic. By default, it's
+     * DiagnosticSeverity::Info, and every diagnostic is reported.
+     */
+    ParseOptions& setDiagnosticSeverityThreshold(DiagnosticSeverity severity);
+    DiagnosticSeverity diagnosticSeverityThreshold() const
+        { return static_cast<DiagnosticSeverity>(BF_.diagnosticSeverityThreshold_); }
+    //!@}
+
+    //!@{
+    /**
+     * The IDs of the diagnostics that are suppressed (never reported).
+     */
+    ParseOptions& suppressDiagnostic(const std::string& id);
+    const std::vector<std::string>& suppressedDiagnostics() const { return suppressedDiagnostics_; }
+    //!@}
+
+    /**
+     * Whether a diagnostic of the given \p id and \p severity is reported,
+     * according to the severity threshold and the suppressed diagnostics.
+     *
+     * \remark
+     * This is checked before a diagnostic is created, so that those which
+     * are not reported cost (almost) nothing.
+     */
+    bool isDiagnosticReported(std::string_view id, DiagnosticSeverity severity) const;
+
     /**
      * The CommentMode enumeration contains alternatives for treating
      * comments during parse.
@@ -96,11 +212,20 @@ private:
     PreprocessorOptions ppOptions_;
     LanguageDialect dialect_;
     LanguageExtensions extensions_;
+    unsigned int lexingThreadCount_;
+    unsigned int parsingThreadCount_;
+    std::shared_ptr<LexemeInterner> lexemeInterner_;
+    std::string tokenCacheDir_;
+    std::vector<std::string> suppressedDiagnostics_;
 
     struct BitFields
     {
         std::uint16_t commentMode_ : 2;
         std::uint16_t keywordIdentifiersClassified_ : 1;
+        std::uint16_t UTF16OffsetsTracked_ : 1;
+        std::uint16_t diagnosticSeverityThreshold_ : 2;
+        std::uint16_t functionBodyParseDeferred_ : 1;
+        std::uint16_t typedefNamesTracked_ : 1;
     };
     union
     {
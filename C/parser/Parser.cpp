@@ -31,10 +31,13 @@ int depth_ = 0;
 Parser::Backtracker::Backtracker(Parser* parser, LexedTokens::IndexType tkIdx)
     : parser_(parser)
     , refTkIdx_(tkIdx == 0 ? parser->curTkIdx_ : tkIdx)
+    , refSuppressedDiagnosticCnt_(parser->suppressedDiagnosticCnt_)
+    , refBlockNameCnt_(parser->blockNames_.size())
+    , refMemoCnt_(parser->recordedMemoCnt_)
+    , refPoolMark_(parser->pool_->mark())
     , done_(false)
+    , chained_(parser->backtracker_)
 {
-    if (parser_->backtracker_)
-        chained_.push(parser_->backtracker_);
     parser_->backtracker_ = this;
 }
 
@@ -49,17 +52,21 @@ void Parser::Backtracker::discard()
     if (done_)
         return;
 
-    if (!chained_.empty()) {
-        parser_->backtracker_ = chained_.top();
-        chained_.pop();
-    }
-    else
-        parser_->backtracker_ = nullptr;
+    parser_->backtracker_ = chained_;
     done_ = true;
 }
 
 void Parser::Backtracker::backtrack()
 {
+    // The diagnostics of the parse undone wouldn't be reported anyway.
+    parser_->suppressedDiagnosticCnt_ = refSuppressedDiagnosticCnt_;
+
+    // Nor are its names and nodes needed (the latter, unless memoized).
+    if (parser_->blockNames_.size() > refBlockNameCnt_)
+        parser_->blockNames_.resize(refBlockNameCnt_);
+    if (parser_->recordedMemoCnt_ == refMemoCnt_)
+        parser_->pool_->rollback(refPoolMark_);
+
     if (parser_->curTkIdx_ == refTkIdx_) {
         discard();
         return;
@@ -86,6 +93,41 @@ void Parser::Backtracker::backtrack()
     discard();
 }
 
+/* Memoizer */
+
+Parser::Memoizer::Memoizer(Parser* parser, MemoizedRule rule, std::uint8_t ruleArg)
+    : parser_(parser)
+    , key_((std::uint64_t(parser->curTkIdx_) << 16)
+                | (std::uint64_t(rule) << 8)
+                | ruleArg)
+    , suppressedDiagnosticCnt_(parser->suppressedDiagnosticCnt_)
+{}
+
+void Parser::Memoizer::record(SyntaxNode* node)
+{
+    if (parser_->inBactrackingMode()
+            && parser_->suppressedDiagnosticCnt_ == suppressedDiagnosticCnt_) {
+        parser_->memos_[key_] = Memo{ node, parser_->curTkIdx_, parser_->blockNamesId() };
+        ++parser_->recordedMemoCnt_;
+    }
+}
+
+/* BlockScope */
+
+Parser::BlockScope::BlockScope(Parser* parser)
+    : parser_(parser)
+    , refBlockNameCnt_(parser->blockNames_.size())
+{
+    ++parser_->blockScopeDepth_;
+}
+
+Parser::BlockScope::~BlockScope()
+{
+    --parser_->blockScopeDepth_;
+    if (parser_->blockNames_.size() > refBlockNameCnt_)
+        parser_->blockNames_.resize(refBlockNameCnt_);
+}
+
 /* DepthControl */
 
 Parser::DepthControl::DepthControl(int& depth)
@@ -106,9 +148,17 @@ Parser::DepthControl::~DepthControl()
 Parser::Parser(SyntaxTree* tree)
     : pool_(tree->unitPool())
     , tree_(tree)
+    , tokens_(&tree->tokens())
+    , streamLexer_(nullptr)
     , backtracker_(nullptr)
+    , recordedMemoCnt_(0)
+    , suppressedDiagnosticCnt_(0)
+    , blockNameCnt_(0)
+    , blockScopeDepth_(0)
+    , fileScopeEndTkIdx_(~LexedTokens::IndexType(0))
     , diagnosticsReporter_(this)
     , curTkIdx_(1)
+    , heldDiagnostics_(nullptr)
     , depthOfExprs_(0)
     , depthOfStmts_(0)
 {
@@ -118,14 +168,27 @@ Parser::Parser(SyntaxTree* tree)
 Parser::~Parser()
 {}
 
-const SyntaxToken& Parser::peek(unsigned int LA) const
+LexedTokens::IndexType Parser::consume()
 {
-    return tree_->tokenAt(curTkIdx_ + LA - 1);
+    // Keep the usual lookahead (of 2) lexed, when the tokens are streamed; a
+    // further one is lexed on demand, by peek.
+    if (streamLexer_ && curTkIdx_ + 2 >= tokens_->count())
+        lexStreamedUpTo(curTkIdx_ + 2);
+    return curTkIdx_++;
 }
 
-LexedTokens::IndexType Parser::consume()
+/**
+ * Lex streamed tokens until the one at \p tkIdx is lexed (or the EOF is).
+ *
+ * \remark The tokens are the parser's input, not its state; so this is
+ * available to a lookahead, even if that is \c const.
+ */
+void Parser::lexStreamedUpTo(LexedTokens::IndexType tkIdx) const
 {
-    return curTkIdx_++;
+    while (tkIdx >= tokens_->count()) {
+        if (streamLexer_->lexStreamed(Lexer::kStreamedTkCnt))
+            break;
+    }
 }
 
 /**
@@ -161,7 +224,8 @@ bool Parser::matchOrSkipTo(SyntaxKind expectedTkK, LexedTokens::IndexType* tkIdx
 }
 
 /**
- * Skip until a token of the given kind is found.
+ * Skip until a token of the given kind is found; balanced regions
+ * within brackets are skipped over as a whole.
  */
 void Parser::skipTo(SyntaxKind tkK)
 {
@@ -169,11 +233,48 @@ void Parser::skipTo(SyntaxKind tkK)
     while (curTkK != tkK) {
         if (curTkK == EndOfFile)
             return;
-        consume();
+        consumeBalanced();
         curTkK = peek().kind();
     }
 }
 
+/**
+ * Consume the current token; if it's an opening bracket with a match,
+ * consume every token up to (and including) the matching bracket.
+ *
+ * \return whether a balanced region was consumed.
+ */
+bool Parser::consumeBalanced()
+{
+    if (streamLexer_)
+        streamLexer_->lexStreamedUntilClosed(curTkIdx_);
+
+    auto matchTkIdx = tokens_->matchingBracketAt(curTkIdx_);
+    if (matchTkIdx <= curTkIdx_) {
+        consume();
+        return false;
+    }
+    curTkIdx_ = matchTkIdx + 1;
+    if (streamLexer_)
+        lexStreamedUpTo(curTkIdx_ + 1);
+    return true;
+}
+
+/**
+ * Peek at the token past the bracket that matches the current (opening) one;
+ * if there's no match, at the current token.
+ */
+SyntaxToken Parser::peekPastBalanced() const
+{
+    if (streamLexer_)
+        streamLexer_->lexStreamedUntilClosed(curTkIdx_);
+
+    auto matchTkIdx = tokens_->matchingBracketAt(curTkIdx_);
+    if (matchTkIdx <= curTkIdx_)
+        return peek();
+    return peek(matchTkIdx - curTkIdx_ + 2);
+}
+
 /**
  * Whether the parser is in backtracking mode.
  */
@@ -246,6 +347,12 @@ bool Parser::ignoreDeclarationOrDefinition()
                 consume();
                 return false;
 
+            // Skip (a body, as a whole) and return.
+            case OpenBraceToken:
+                if (consumeBalanced())
+                    return false;
+                break;
+
             // Skip.
             default:
                 consume();
@@ -316,7 +423,13 @@ bool Parser::ignoreStatement()
                 consume();
                 return false;
 
-                // Skip.
+            // Skip (a block, as a whole) and return.
+            case OpenBraceToken:
+                if (consumeBalanced())
+                    return false;
+                break;
+
+            // Skip.
             default:
                 consume();
         }
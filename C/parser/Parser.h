@@ -24,6 +24,7 @@
 
 #include "API.h"
 #include "APIFwds.h"
+#include "DiagnosticRecord.h"
 #include "LexedTokens.h"
 #include "MemoryPool.h"
 #include "SyntaxTree.h"
@@ -32,7 +33,8 @@
 
 #include <cstdint>
 #include <functional>
-#include <stack>
+#include <initializer_list>
+#include <unordered_map>
 #include <vector>
 
 namespace psy {
@@ -61,12 +63,21 @@ private:
 
     MemoryPool* pool_;
     SyntaxTree* tree_;
+    const LexedTokens* tokens_;
+
+    // The lexer from which the tokens are streamed, if they aren't lexed
+    // altogether up front.
+    Lexer* streamLexer_;
+    void lexStreamedUpTo(LexedTokens::IndexType tkIdx) const;
 
     // While the parser is in backtracking mode, diagnostics are disabled.
     // To avoid unintended omission of syntax errors, the backtracker
     // should be discarded immediately after use, either explicitly or
     // implicitly; the latter happens either upon the object destruction
-    // or after a single backtracking operation.
+    // or after a single backtracking operation. Upon backtracking, the
+    // nodes made since the backtracker's creation are released (unless
+    // they might be recalled by a memoizer); so, none of them should be
+    // referred to by a node made earlier.
     struct Backtracker
     {
         Backtracker(Parser* parser, LexedTokens::IndexType tkIdx = 0);
@@ -76,30 +87,92 @@ private:
 
         Parser* parser_;
         LexedTokens::IndexType refTkIdx_;
+        unsigned int refSuppressedDiagnosticCnt_;
+        std::size_t refBlockNameCnt_;
+        std::size_t refMemoCnt_;
+        MemoryPool::Mark refPoolMark_;
         bool done_;
-        std::stack<const Backtracker*> chained_;
+        const Backtracker* chained_;
     };
     friend struct Backtracker;
     const Backtracker* backtracker_;
     bool inBactrackingMode() const;
 
+    // A parse that's done in backtracking mode may be undone and then done
+    // again, for the same tokens, by another alternative (e.g., through a
+    // declaration-or-expression statement with a GNU statement-expression).
+    // A memoizer records the successful parse of a rule, at a token, so that
+    // its repetition takes no time. Because diagnostics are disabled in
+    // backtracking mode, a parse that'd diagnose something isn't recorded.
+    enum class MemoizedRule : std::uint8_t
+    {
+        CompoundStatement
+    };
+    struct Memoizer
+    {
+        Memoizer(Parser* parser, MemoizedRule rule, std::uint8_t ruleArg);
+        template <class NodeT> bool recall(NodeT*& node) const;
+        void record(SyntaxNode* node);
+
+        Parser* parser_;
+        std::uint64_t key_;
+        unsigned int suppressedDiagnosticCnt_;
+    };
+    friend struct Memoizer;
+    struct Memo
+    {
+        SyntaxNode* node_;
+        LexedTokens::IndexType endTkIdx_;
+        unsigned int blockNamesId_;
+    };
+    std::unordered_map<std::uint64_t, Memo> memos_;
+    std::size_t recordedMemoCnt_;
+    unsigned int suppressedDiagnosticCnt_;
+
+    // The names declared in the block scopes entered so far, and whether each
+    // one is a typedef-name, when typedef-names are tracked (the names of the
+    // file scope are kept by the tree). Names are only appended to, or, upon
+    // leaving a scope or backtracking, truncated from the list; every name
+    // gets an ID, so that the list's state is identified by its last name's.
+    struct BlockName
+    {
+        const SyntaxLexeme* name_;
+        bool isTypedefName_;
+        unsigned int id_;
+    };
+    std::vector<BlockName> blockNames_;
+    unsigned int blockNameCnt_;
+    int blockScopeDepth_;
+    unsigned int blockNamesId() const { return blockNames_.empty() ? 0 : blockNames_.back().id_; }
+
+    // The names of the file scope are visible only if they're declared
+    // before this token, e.g., the open brace of a deferred function body.
+    LexedTokens::IndexType fileScopeEndTkIdx_;
+
+    struct BlockScope
+    {
+        BlockScope(Parser* parser);
+        ~BlockScope();
+        Parser* parser_;
+        std::size_t refBlockNameCnt_;
+    };
+    friend struct BlockScope;
+
     struct DiagnosticsReporter
     {
         DiagnosticsReporter(Parser* parser) : parser_(parser) {}
         Parser* parser_;
 
-        static std::string joinTokenNames(const std::vector<SyntaxKind>& validTkKinds);
-        void diagnose(DiagnosticDescriptor&& desc);
+        void diagnose(const DiagnosticSpec& spec, DiagnosticArguments args = DiagnosticArguments());
 
         /* General */
-        void ExpectedFeature(const std::string& name);
+        void ExpectedFeature(const char* name);
 
         static const std::string ID_of_ExpectedFeature;
 
         /* Terminal */
         void ExpectedToken(SyntaxKind syntaxK);
-        void ExpectedTokenWithin(const std::vector<SyntaxKind>& validTokens);
-        void ExpectedTokenOfCategory(SyntaxToken::Category category, const std::string& id);
+        void ExpectedTokenWithin(std::initializer_list<SyntaxKind> validTkKinds);
         void ExpectedTokenOfCategoryIdentifier();
         void ExpectedTokenOfCategoryConstant();
         void ExpectedTokenOfCategoryStringLiteral();
@@ -111,7 +184,6 @@ private:
         static const std::string ID_of_ExpectedTokenOfCategoryStringLiteral;
 
         /* Non-terminal */
-        void ExpectedFIRSTof(const std::string& rule, const std::string& id);
         void ExpectedFIRSTofExpression();
         void ExpectedFIRSTofEnumerationConstant();
         void ExpectedFIRSTofDirectDeclarator();
@@ -163,14 +235,32 @@ private:
     };
     friend struct DiagnosticsReporter;
 
-    const SyntaxToken& peek(unsigned int LA = 1) const;
+    SyntaxToken peek(unsigned int LA = 1) const
+    {
+        if (streamLexer_ && curTkIdx_ + LA - 1 >= tokens_->count())
+            lexStreamedUpTo(curTkIdx_ + LA - 1);
+        return SyntaxToken(tokens_, curTkIdx_ + LA - 1);
+    }
     LexedTokens::IndexType consume();
     bool match(SyntaxKind expectedTkK, LexedTokens::IndexType* tkIdx);
     bool matchOrSkipTo(SyntaxKind expectedTkK, LexedTokens::IndexType* tkIdx);
     void skipTo(SyntaxKind tkK);
+    bool consumeBalanced();
+    SyntaxToken peekPastBalanced() const;
 
     DiagnosticsReporter diagnosticsReporter_;
-    unsigned int curTkIdx_;
+    LexedTokens::IndexType curTkIdx_;
+
+    // A parser of a region of the tokens, that works in parallel with others,
+    // holds its diagnostics back: they're reported only if the declarations
+    // of the region make it into the tree.
+    struct HeldDiagnostic
+    {
+        const DiagnosticSpec* spec_;
+        DiagnosticArguments args_;
+        LexedTokens::IndexType tkIdx_;
+    };
+    std::vector<HeldDiagnostic>* heldDiagnostics_;
 
     int depthOfExprs_;
     int depthOfStmts_;
@@ -223,6 +313,10 @@ private:
     // Declarations //
     //--------------//
     void parseTranslationUnit(TranslationUnitSyntax*& unit);
+    void parseTranslationUnit_Streamed(Lexer* lexer, const SyntaxTree::DeclarationHandler& handler);
+    void parseTranslationUnit_Parallel(DeclarationListSyntax**& declList_cur, unsigned int threadCnt);
+    void parseExternalDeclarations(DeclarationListSyntax**& declList_cur, LexedTokens::IndexType endTkIdx);
+    StatementSyntax* parseDeferredFunctionBody(const FunctionDefinitionSyntax* funcDef);
     bool parseExternalDeclaration(DeclarationSyntax*& decl);
     void parseIncompleteDeclaration_AtFirst(DeclarationSyntax*& decl,
                                             const SpecifierListSyntax* specList = nullptr);
@@ -282,6 +376,10 @@ private:
     bool parseExtPSY_QuantifiedTypeSpecifier_AtFirst(SpecifierSyntax*& spec);
 
     IdentifierRole determineIdentifierRole(bool seenType) const;
+    bool lookUpIdentifierRole(IdentifierRole& identRole, unsigned int LA = 1) const;
+    void declareName(LexedTokens::IndexType identTkIdx, bool isTypedefName);
+    void declareName(const DeclaratorSyntax* decltor, const SpecifierListSyntax* specList);
+    void declareParameters(const DeclaratorSyntax* decltor);
 
     /* Declarators */
     bool parseAbstractDeclarator(DeclaratorSyntax*& decltor);
@@ -56,18 +56,29 @@ bool Parser::parseParenthesizedTypeNameOrExpression(TypeReferenceSyntax*& tyRef)
 {
     switch (peek().kind()) {
         case OpenParenToken: {
-            Backtracker BT(this);
-            ExpressionSyntax* expr = nullptr;
-            if (parseExpressionWithPrecedenceUnary(expr)) {
-                auto exprAsTyRef = makeNode<ExpressionAsTypeReferenceSyntax>();
-                tyRef = exprAsTyRef;
-                exprAsTyRef->expr_ = expr;
-                if (expr->kind() == ParenthesizedExpression)
-                    maybeAmbiguateTypeReference(tyRef);
-                return true;
+            IdentifierRole identRole;
+            auto roleKnown = peek(2).kind() == IdentifierToken
+                    && lookUpIdentifierRole(identRole, 2);
+
+            // A parenthesized typedef-name is a type-name, unless it's that of
+            // a compound literal (an expression); only otherwise is the
+            // expression tried first.
+            if (!roleKnown
+                    || identRole == IdentifierRole::AsDeclarator
+                    || peekPastBalanced().kind() == OpenBraceToken) {
+                Backtracker BT(this);
+                ExpressionSyntax* expr = nullptr;
+                if (parseExpressionWithPrecedenceUnary(expr)) {
+                    auto exprAsTyRef = makeNode<ExpressionAsTypeReferenceSyntax>();
+                    tyRef = exprAsTyRef;
+                    exprAsTyRef->expr_ = expr;
+                    if (expr->kind() == ParenthesizedExpression && !roleKnown)
+                        maybeAmbiguateTypeReference(tyRef);
+                    return true;
+                }
+                BT.backtrack();
             }
 
-            BT.backtrack();
             auto openParenTkIdx = consume();
             TypeNameSyntax* typeName = nullptr;
             if (!parseTypeName(typeName))
@@ -20,6 +20,11 @@
 
 #include "Parser__IMPL__.inc"
 
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <thread>
+
 using namespace psy;
 using namespace C;
 
@@ -36,7 +41,28 @@ void Parser::parseTranslationUnit(TranslationUnitSyntax*& unit)
 
     DeclarationListSyntax** declList_cur = &unit->decls_;
 
-    while (true) {
+    auto threadCnt = tree_->options().parsingThreadCount();
+    if (threadCnt != 1 && !tree_->options().IsTypedefNamesTracked()) {
+        if (!threadCnt)
+            threadCnt = std::thread::hardware_concurrency();
+        if (threadCnt > 1)
+            parseTranslationUnit_Parallel(declList_cur, threadCnt);
+    }
+
+    parseExternalDeclarations(declList_cur, std::numeric_limits<LexedTokens::IndexType>::max());
+}
+
+/**
+ * Parse the external declarations (until the EOF or the token at \p endTkIdx,
+ * whichever comes first) and append them to the list at \p declList_cur.
+ */
+void Parser::parseExternalDeclarations(DeclarationListSyntax**& declList_cur,
+                                       LexedTokens::IndexType endTkIdx)
+{
+    while (curTkIdx_ < endTkIdx) {
+        if (!memos_.empty())
+            memos_.clear();
+
         DeclarationSyntax* decl = nullptr;
         switch (peek().kind()) {
             case EndOfFile:
@@ -63,6 +89,203 @@ void Parser::parseTranslationUnit(TranslationUnitSyntax*& unit)
     }
 }
 
+namespace {
+
+const LexedTokens::SizeType kMinRegionTkCnt = 1 << 12;
+
+/**
+ * Find the boundaries of (at most) \p regionCnt regions of the tokens, with
+ * roughly the same size, from the one at \p tkIdx up to the EOF. A boundary is
+ * placed after a \c ; or after the \c } of what looks like a function body,
+ * in both cases outside of any brackets; this is a guess, for the parser may
+ * (in the presence of syntax errors or K&R-style definitions) not see a new
+ * declaration starting in that place.
+ */
+std::vector<LexedTokens::IndexType> findRegionBoundaries(const LexedTokens* tokens,
+                                                         LexedTokens::IndexType tkIdx,
+                                                         LexedTokens::SizeType tkCnt,
+                                                         unsigned int regionCnt)
+{
+    const auto eofTkIdx = tkCnt - 1;
+    const auto regionTkCnt = (eofTkIdx - tkIdx) / regionCnt;
+
+    std::vector<LexedTokens::IndexType> bounds { tkIdx };
+    while (tkIdx < eofTkIdx) {
+        bool atBoundary = false;
+        switch (tokens->rawKindAt(tkIdx)) {
+            case SemicolonToken:
+                atBoundary = true;
+                ++tkIdx;
+                break;
+
+            case OpenBraceToken:
+            case OpenParenToken:
+            case OpenBracketToken: {
+                auto matchTkIdx = tokens->matchingBracketAt(tkIdx);
+                if (matchTkIdx <= tkIdx) {
+                    // Unbalanced: the rest goes into the last region.
+                    tkIdx = eofTkIdx;
+                    break;
+                }
+                atBoundary = tokens->rawKindAt(tkIdx) == OpenBraceToken
+                        && tokens->rawKindAt(tkIdx - 1) == CloseParenToken;
+                tkIdx = matchTkIdx + 1;
+                break;
+            }
+
+            default:
+                ++tkIdx;
+                break;
+        }
+
+        if (atBoundary
+                && tkIdx - bounds.back() >= regionTkCnt
+                && eofTkIdx - tkIdx >= regionTkCnt / 2) {
+            bounds.push_back(tkIdx);
+        }
+    }
+    bounds.push_back(eofTkIdx);
+
+    return bounds;
+}
+
+} // anonymous
+
+/**
+ * Parse the external declarations in regions of the tokens, each one in a
+ * thread (out of \p threadCnt), with a parser (and a MemoryPool) of its own,
+ * and link the declarations of the regions together, at \p declList_cur, in
+ * source order.
+ *
+ * The declarations of a region (and its diagnostics) are taken only if the
+ * region starts where \c this parser sees a new declaration and the region's
+ * parser ends exactly at the end of the region; in such case, they're the
+ * same that'd be parsed sequentially, since the parse of an external
+ * declaration doesn't depend on the ones that precede it. Otherwise, \c this
+ * parser parses the region's tokens sequentially.
+ */
+void Parser::parseTranslationUnit_Parallel(DeclarationListSyntax**& declList_cur,
+                                           unsigned int threadCnt)
+{
+    const auto tkCnt = tree_->tokenCount();
+    if (tkCnt - curTkIdx_ < 2 * kMinRegionTkCnt)
+        return;
+
+    auto regionCnt = std::min<LexedTokens::SizeType>(4 * threadCnt, (tkCnt - curTkIdx_) / kMinRegionTkCnt);
+    auto bounds = findRegionBoundaries(tokens_, curTkIdx_, tkCnt, regionCnt);
+    regionCnt = bounds.size() - 1;
+    if (regionCnt < 2)
+        return;
+
+    struct ParsedRegion
+    {
+        DeclarationListSyntax* declList_;
+        DeclarationListSyntax** declList_cur_;
+        std::vector<HeldDiagnostic> diagnostics_;
+        bool complete_;
+    };
+    std::vector<ParsedRegion> regions(regionCnt);
+
+    // The parsers are created here (not in the threads), for a Parser's
+    // construction isn't thread-safe.
+    threadCnt = std::min(threadCnt, regionCnt);
+    std::vector<std::unique_ptr<Parser>> parsers;
+    for (auto i = 0U; i < threadCnt; ++i) {
+        parsers.emplace_back(new Parser(tree_));
+        parsers.back()->pool_ = tree_->addUnitPool();
+    }
+
+    std::atomic<unsigned int> nextRegionIdx(0);
+    auto parseRegions = [&] (Parser* parser) {
+        unsigned int regionIdx;
+        while ((regionIdx = nextRegionIdx++) < regionCnt) {
+            auto& region = regions[regionIdx];
+            region.declList_ = nullptr;
+            region.declList_cur_ = &region.declList_;
+            region.complete_ = false;
+            parser->curTkIdx_ = bounds[regionIdx];
+            parser->heldDiagnostics_ = &region.diagnostics_;
+            try {
+                parser->parseExternalDeclarations(region.declList_cur_, bounds[regionIdx + 1]);
+                region.complete_ = parser->curTkIdx_ == bounds[regionIdx + 1];
+            }
+            catch (...) {
+                // The region is parsed sequentially (and the error raised again).
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (auto i = 1U; i < threadCnt; ++i)
+        workers.emplace_back(parseRegions, parsers[i].get());
+    parseRegions(parsers[0].get());
+    for (auto& worker : workers)
+        worker.join();
+
+    for (auto regionIdx = 0U; regionIdx < regionCnt; ++regionIdx) {
+        auto& region = regions[regionIdx];
+        if (curTkIdx_ == bounds[regionIdx] && region.complete_) {
+            if (region.declList_) {
+                *declList_cur = region.declList_;
+                declList_cur = region.declList_cur_;
+            }
+            for (auto& diagnostic : region.diagnostics_)
+                tree_->newDiagnostic(*diagnostic.spec_, diagnostic.args_, diagnostic.tkIdx_);
+            curTkIdx_ = bounds[regionIdx + 1];
+            continue;
+        }
+        parseExternalDeclarations(declList_cur, bounds[regionIdx + 1]);
+    }
+}
+
+/**
+ * Parse a translation unit whose tokens are streamed from the \p lexer: as
+ * each external declaration is parsed, it's passed to the \p handler, and
+ * then released, along with its tokens. Since a Backtracker never outlives
+ * the parse of an external declaration, no checkpoint refers to a released
+ * token.
+ */
+void Parser::parseTranslationUnit_Streamed(Lexer* lexer, const SyntaxTree::DeclarationHandler& handler)
+{
+    DEBUG_THIS_RULE();
+
+    streamLexer_ = lexer;
+    lexStreamedUpTo(curTkIdx_ + 1);
+
+    while (true) {
+        DeclarationSyntax* decl = nullptr;
+        switch (peek().kind()) {
+            case EndOfFile:
+                streamLexer_ = nullptr;
+                return;
+
+            case Keyword_ExtGNU___extension__: {
+                auto extKwTkIdx = consume();
+                if (!parseExternalDeclaration(decl))
+                    break;
+                PSYCHE_ASSERT(decl, break, "invalid declaration");
+                decl->extKwTkIdx_ = extKwTkIdx;
+                break;
+            }
+
+            default:
+                if (parseExternalDeclaration(decl))
+                    break;
+                ignoreDeclarationOrDefinition();
+                decl = nullptr;
+                break;
+        }
+
+        if (decl)
+            handler(decl);
+
+        PSYCHE_ASSERT(!backtracker_, return, "unexpected backtracker");
+        memos_.clear();
+        pool_->reset();
+        tree_->releaseTokensBefore(curTkIdx_);
+    }
+}
+
 /**
  * Parse an \a external-declaration.
  *
@@ -260,6 +483,7 @@ bool Parser::parseDeclarationOrFunctionDefinition_AtFollowOfSpecifiers(
         if (!parseDeclarator(decltor, DeclarationScope::File))
             return false;
 
+        declareName(decltor, specList);
         *decltorList_cur = makeNode<DeclaratorListSyntax>(decltor);
 
         InitializerSyntax** init = nullptr;
@@ -345,6 +569,16 @@ bool Parser::parseDeclarationOrFunctionDefinition_AtFollowOfSpecifiers(
                         decl = funcDef;
                         funcDef->specs_ = const_cast<SpecifierListSyntax*>(specList);
                         funcDef->decltor_ = decltor;
+                        if (tree_->options().IsFunctionBodyParseDeferred()) {
+                            auto openBraceTkIdx = curTkIdx_;
+                            if (consumeBalanced()) {
+                                funcDef->deferredBodyTkIdx_ = openBraceTkIdx;
+                                return true;
+                            }
+                            curTkIdx_ = openBraceTkIdx;
+                        }
+                        BlockScope scope(this);
+                        declareParameters(decltor);
                         parseCompoundStatement_AtFirst(funcDef->body_, StatementContext::None);
                         return true;
                     }
@@ -363,8 +597,28 @@ bool Parser::parseDeclarationOrFunctionDefinition_AtFollowOfSpecifiers(
     }
 }
 
+/**
+ * Parse the (deferred) body of the function definition \p funcDef.
+ */
+StatementSyntax* Parser::parseDeferredFunctionBody(const FunctionDefinitionSyntax* funcDef)
+{
+    DEBUG_THIS_RULE();
+
+    curTkIdx_ = funcDef->deferredBodyTkIdx_;
+    fileScopeEndTkIdx_ = funcDef->deferredBodyTkIdx_;
+    BlockScope scope(this);
+    declareParameters(funcDef->decltor_);
+    StatementSyntax* body = nullptr;
+    parseCompoundStatement_AtFirst(body, StatementContext::None);
+    return body;
+}
+
 Parser::IdentifierRole Parser::determineIdentifierRole(bool seenType) const
 {
+    IdentifierRole identRole;
+    if (lookUpIdentifierRole(identRole))
+        return identRole;
+
     /*
      Upon an identifier, when parsing a declaration, we can't
      tell whether the identifier is <typedef-name> or a
@@ -488,6 +742,122 @@ Parser::IdentifierRole Parser::determineIdentifierRole(bool seenType) const
     }
 }
 
+/**
+ * Look up the identifier at LA(\p LA) among the names declared so far, if
+ * typedef-names are tracked; if it's found, its role, \p identRole, is known
+ * (an ordinary identifier is taken as a declarator).
+ */
+bool Parser::lookUpIdentifierRole(IdentifierRole& identRole, unsigned int LA) const
+{
+    if (!tree_->options().IsTypedefNamesTracked())
+        return false;
+
+    auto name = peek(LA).valueLexeme();
+    for (auto it = blockNames_.rbegin(); it != blockNames_.rend(); ++it) {
+        if (it->name_ == name) {
+            identRole = it->isTypedefName_
+                    ? IdentifierRole::AsTypedefName
+                    : IdentifierRole::AsDeclarator;
+            return true;
+        }
+    }
+
+    const auto& fileNames = tree_->fileScopeNames();
+    auto it = fileNames.find(name);
+    if (it == fileNames.end() || it->second.tkIdx_ >= fileScopeEndTkIdx_)
+        return false;
+    identRole = it->second.isTypedefName_
+            ? IdentifierRole::AsTypedefName
+            : IdentifierRole::AsDeclarator;
+    return true;
+}
+
+/**
+ * Declare the identifier at \p identTkIdx, in the current scope, as a
+ * typedef-name or not, if typedef-names are tracked. A name of the file
+ * scope isn't declared in backtracking mode, because it can't be undone;
+ * and it's redeclared only if its role changes, so that it's known from
+ * where it was first declared in that role.
+ */
+void Parser::declareName(LexedTokens::IndexType identTkIdx, bool isTypedefName)
+{
+    if (!tree_->options().IsTypedefNamesTracked())
+        return;
+
+    auto name = SyntaxToken(tokens_, identTkIdx).valueLexeme();
+    if (blockScopeDepth_) {
+        blockNames_.push_back({ name, isTypedefName, ++blockNameCnt_ });
+        return;
+    }
+    if (inBactrackingMode())
+        return;
+
+    auto& fileNames = tree_->fileScopeNames();
+    auto it = fileNames.find(name);
+    if (it == fileNames.end() || it->second.isTypedefName_ != isTypedefName)
+        fileNames[name] = { isTypedefName, identTkIdx };
+}
+
+/**
+ * Declare the name of the declarator \p decltor, whose specifiers are those
+ * in \p specList, if typedef-names are tracked.
+ */
+void Parser::declareName(const DeclaratorSyntax* decltor, const SpecifierListSyntax* specList)
+{
+    if (!tree_->options().IsTypedefNamesTracked())
+        return;
+
+    while (decltor) {
+        decltor = SyntaxUtilities::strippedDeclarator(decltor);
+        auto innerDecltor = SyntaxUtilities::innerDeclarator(decltor);
+        if (innerDecltor == decltor)
+            break;
+        decltor = innerDecltor;
+    }
+    if (!(decltor && decltor->kind() == IdentifierDeclarator))
+        return;
+
+    bool isTypedefName = false;
+    for (auto iter = specList; iter; iter = iter->next) {
+        if (iter->value && iter->value->kind() == TypedefStorageClass) {
+            isTypedefName = true;
+            break;
+        }
+    }
+    declareName(decltor->asIdentifierDeclarator()->identTkIdx_, isTypedefName);
+}
+
+/**
+ * Declare the names of the parameters of the function definition whose
+ * declarator is \p decltor, if typedef-names are tracked.
+ */
+void Parser::declareParameters(const DeclaratorSyntax* decltor)
+{
+    if (!tree_->options().IsTypedefNamesTracked())
+        return;
+
+    const DeclaratorSyntax* funcDecltor = nullptr;
+    while (decltor) {
+        decltor = SyntaxUtilities::strippedDeclarator(decltor);
+        auto innerDecltor = SyntaxUtilities::innerDeclarator(decltor);
+        if (innerDecltor == decltor)
+            break;
+        funcDecltor = decltor;
+        decltor = innerDecltor;
+    }
+    if (!(funcDecltor && funcDecltor->kind() == FunctionDeclarator))
+        return;
+
+    auto sfx = funcDecltor->asArrayOrFunctionDeclarator()->suffix();
+    if (!(sfx && sfx->asParameterSuffix()))
+        return;
+
+    for (auto iter = sfx->asParameterSuffix()->parameters(); iter; iter = iter->next) {
+        if (iter->value)
+            declareName(iter->value->declarator(), nullptr);
+    }
+}
+
 bool Parser::parseStructDeclaration_AtFollowOfSpecifierQualifierList(
         DeclarationSyntax*& decl,
         const SpecifierListSyntax* specList)
@@ -588,6 +958,7 @@ bool Parser::parseEnumerator(DeclarationSyntax*& decl)
             enumMembDecl = makeNode<EnumMemberDeclarationSyntax>();
             decl = enumMembDecl;
             enumMembDecl->identTkIdx_ = consume();
+            declareName(enumMembDecl->identTkIdx_, false);
             break;
         }
 
@@ -740,6 +1111,7 @@ bool Parser::parseParameterDeclaration(ParameterDeclarationSyntax*& paramDecl)
     Backtracker BT(this);
     if (!parseDeclarator(paramDecl->decltor_, DeclarationScope::FunctionPrototype)) {
         BT.backtrack();
+        paramDecl->decltor_ = nullptr;
         return parseAbstractDeclarator(paramDecl->decltor_);
     }
     return true;
@@ -1466,7 +1838,8 @@ bool Parser::parseExtGNU_Attribute(ExtGNU_AttributeSyntax*& attr)
 
     attr->openParenTkIdx_ = consume();
 
-    auto ident = tree_->tokenAt(attr->kwOrIdentTkIdx_).identifier_;
+    auto lexeme = tree_->tokenAt(attr->kwOrIdentTkIdx_).valueLexeme();
+    auto ident = lexeme ? lexeme->asIdentifier() : nullptr;
     bool (Parser::*parseAttrArg)(ExpressionListSyntax*&);
     if (ident && !strcmp(ident->c_str(), "availability"))
         parseAttrArg = &Parser::parseExtGNU_AttributeArgumentsLLVM;
@@ -2149,7 +2522,8 @@ bool Parser::parseBraceEnclosedInitializer_AtFirst(InitializerSyntax*& init)
 
     if (!parseInitializerList(braceInit->initList_)) {
         skipTo(CloseBraceToken);
-        consume();
+        if (peek().kind() == CloseBraceToken)
+            consume();
         return false;
     }
 
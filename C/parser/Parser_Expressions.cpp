@@ -475,6 +475,11 @@ bool Parser::parseExpressionWithPrecedencePostfix(ExpressionSyntax*& expr)
             // postfix-expression -> `(' type-name ->* type-specifier -> typedef-name ->
             // postfix-expression -> unary-expression ->* `(' expression ->
             case IdentifierToken: {
+                IdentifierRole identRole;
+                if (lookUpIdentifierRole(identRole, 2)
+                        && identRole == IdentifierRole::AsDeclarator)
+                    break;
+
                 Backtracker BT(this);
                 auto openParenTkIdx = consume();
                 TypeNameSyntax* typeName = nullptr;
@@ -953,6 +958,13 @@ bool Parser::parseExpressionWithPrecedenceCast(ExpressionSyntax*& expr)
                 // cast-expression -> `(' type-name ->* type-specifier -> typedef-name ->
                 // cast-expression -> unary-expression ->* `(' expression ->
                 case IdentifierToken: {
+                    IdentifierRole identRole;
+                    if (lookUpIdentifierRole(identRole, 2)) {
+                        if (identRole == IdentifierRole::AsTypedefName)
+                            return parseCompoundLiteralOrCastExpression_AtFirst(expr);
+                        return parseExpressionWithPrecedenceUnary(expr);
+                    }
+
                     Backtracker BT(this);
                     if (parseCompoundLiteralOrCastExpression_AtFirst(expr)) {
                         if (expr->kind() == CastExpression)
@@ -960,6 +972,7 @@ bool Parser::parseExpressionWithPrecedenceCast(ExpressionSyntax*& expr)
                         return true;
                     }
                     BT.backtrack();
+                    expr = nullptr;
                     return parseExpressionWithPrecedenceUnary(expr);
                 }
 
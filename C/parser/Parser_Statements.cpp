@@ -89,6 +89,16 @@ bool Parser::parseStatement(StatementSyntax*& stmt, StatementContext stmtCtx)
             if (peek(2).kind() == ColonToken)
                 return parseLabeledStatement_AtFirst(stmt, stmtCtx);
 
+            IdentifierRole identRole;
+            if (lookUpIdentifierRole(identRole)) {
+                if (identRole == IdentifierRole::AsTypedefName) {
+                    return parseDeclarationStatement(
+                                stmt,
+                                &Parser::parseDeclarationOrFunctionDefinition);
+                }
+                return parseExpressionStatement(stmt);
+            }
+
             Backtracker BT(this);
             if (!parseExpressionStatement(stmt)) {
                 BT.backtrack();
@@ -293,6 +303,11 @@ bool Parser::parseCompoundStatement_AtFirst(StatementSyntax*& stmt,
 
     DepthControl _(depthOfStmts_);
 
+    Memoizer M(this, MemoizedRule::CompoundStatement, std::uint8_t(stmtCtx));
+    if (M.recall(stmt))
+        return true;
+
+    BlockScope scope(this);
     auto block = makeNode<CompoundStatementSyntax>();
     stmt = block;
     block->openBraceTkIdx_ = consume();
@@ -308,6 +323,7 @@ bool Parser::parseCompoundStatement_AtFirst(StatementSyntax*& stmt,
 
             case CloseBraceToken:
                 block->closeBraceTkIdx_ = consume();
+                M.record(block);
                 return true;
 
             default: {
@@ -537,6 +553,7 @@ bool Parser::parseForStatement_AtFirst(StatementSyntax*& stmt,
     stmt = forStmt;
     forStmt->forKwTkIdx_ = consume();
 
+    BlockScope scope(this);
     if (!match(OpenParenToken, &forStmt->openParenTkIdx_)) {
         skipTo(CloseParenToken);
         return false;
@@ -592,6 +609,20 @@ bool Parser::parseForStatement_AtFirst(StatementSyntax*& stmt,
             break;
 
         case IdentifierToken: {
+            IdentifierRole identRole;
+            if (lookUpIdentifierRole(identRole)) {
+                bool parsed = identRole == IdentifierRole::AsTypedefName
+                        ? parseDeclarationStatement(
+                                forStmt->initStmt_,
+                                &Parser::parseDeclarationOrFunctionDefinition)
+                        : parseExpressionStatement(forStmt->initStmt_);
+                if (!parsed) {
+                    skipTo(CloseParenToken);
+                    return false;
+                }
+                break;
+            }
+
             Backtracker BT(this);
             if (!parseExpressionStatement(forStmt->initStmt_)) {
                 BT.backtrack();
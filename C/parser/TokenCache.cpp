@@ -0,0 +1,630 @@
+// Copyright (c) 2020/21 Leandro T. C. Melo <ltcmelo@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+// THE SOFTWARE.
+
+#include "TokenCache.h"
+
+#include "LexedTokens.h"
+#include "Lexer.h"
+#include "ParseOptions.h"
+
+#include "SyntaxTree.h"
+#include "syntax/SyntaxLexemes.h"
+
+#include "../common/text/SourceText.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <unordered_map>
+
+using namespace psy;
+using namespace C;
+
+namespace {
+
+// The last byte is the version of the format.
+const char kMagic[8] = { 'P', 'S', 'Y', 'T', 'O', 'K', 'S', 2 };
+
+struct Header
+{
+    char magic_[8];
+    std::uint64_t key_;
+    std::uint64_t textDigest_;
+    std::uint64_t textSize_;
+    std::uint32_t lexemeCnt_;
+    std::uint32_t tokenCnt_;
+    std::uint32_t commentCnt_;
+    std::uint32_t lineDirectiveCnt_;
+    std::uint32_t expansionCnt_;
+    std::uint32_t lineStartCnt_;
+};
+
+std::uint64_t hash64(std::uint64_t h, const char* chars, std::size_t size)
+{
+    // As in TextElement::hashCode, but keeping all 64 bits.
+    constexpr std::uint64_t kMul = 0x9e3779b97f4a7c15ULL;
+
+    h = (h ^ size) * kMul;
+    while (size >= 8) {
+        std::uint64_t w;
+        std::memcpy(&w, chars, 8);
+        h = (h ^ w) * kMul;
+        h ^= h >> 32;
+        chars += 8;
+        size -= 8;
+    }
+    if (size) {
+        std::uint64_t w = 0;
+        std::memcpy(&w, chars, size);
+        h = (h ^ w) * kMul;
+        h ^= h >> 32;
+    }
+
+    h ^= h >> 29;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 32;
+    return h;
+}
+
+/*
+ * A second hash of the text, independent from that of the key (it mixes the
+ * words in differently), which the text of a cache file must also match.
+ */
+std::uint64_t digest64(const char* chars, std::size_t size)
+{
+    constexpr std::uint64_t kMul = 0xff51afd7ed558ccdULL;
+
+    auto mix = [] (std::uint64_t h, std::uint64_t w) {
+        h ^= w + 0x6a09e667f3bcc909ULL + (h << 6) + (h >> 2);
+        return ((h << 27) | (h >> 37)) * kMul;
+    };
+
+    std::uint64_t h = size;
+    while (size >= 8) {
+        std::uint64_t w;
+        std::memcpy(&w, chars, 8);
+        h = mix(h, w);
+        chars += 8;
+        size -= 8;
+    }
+    if (size) {
+        std::uint64_t w = 0;
+        std::memcpy(&w, chars, size);
+        h = mix(h, w);
+    }
+
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/*
+ * Whether a token of the given kind must have a lexeme of the given kind (or,
+ * if \c false is returned, whether it may have only an identifier, as an
+ * operator name does).
+ */
+bool requiresLexeme(std::uint16_t rawSyntaxK, SyntaxLexeme::Kind& lexemeK)
+{
+    switch (rawSyntaxK) {
+        case IdentifierToken:
+            lexemeK = SyntaxLexeme::Kind::Identifier;
+            return true;
+
+        case IntegerConstantToken:
+            lexemeK = SyntaxLexeme::Kind::IntegerConstant;
+            return true;
+
+        case FloatingConstantToken:
+            lexemeK = SyntaxLexeme::Kind::FloatingConstant;
+            return true;
+
+        case CharacterConstantToken:
+        case CharacterConstant_L_Token:
+        case CharacterConstant_u_Token:
+        case CharacterConstant_U_Token:
+            lexemeK = SyntaxLexeme::Kind::CharacterConstant;
+            return true;
+
+        case StringLiteralToken:
+        case StringLiteral_L_Token:
+        case StringLiteral_u8_Token:
+        case StringLiteral_u_Token:
+        case StringLiteral_U_Token:
+        case StringLiteral_R_Token:
+        case StringLiteral_LR_Token:
+        case StringLiteral_u8R_Token:
+        case StringLiteral_uR_Token:
+        case StringLiteral_UR_Token:
+            lexemeK = SyntaxLexeme::Kind::StringLiteral;
+            return true;
+
+        default:
+            lexemeK = SyntaxLexeme::Kind::Identifier;
+            return false;
+    }
+}
+
+bool isOpeningBracket(std::uint16_t rawSyntaxK)
+{
+    return rawSyntaxK == OpenParenToken
+            || rawSyntaxK == OpenBracketToken
+            || rawSyntaxK == OpenBraceToken;
+}
+
+bool bracketsMatch(std::uint16_t openRawSyntaxK, std::uint16_t closeRawSyntaxK)
+{
+    return (openRawSyntaxK == OpenParenToken && closeRawSyntaxK == CloseParenToken)
+            || (openRawSyntaxK == OpenBracketToken && closeRawSyntaxK == CloseBracketToken)
+            || (openRawSyntaxK == OpenBraceToken && closeRawSyntaxK == CloseBraceToken);
+}
+
+/*
+ * Whether the \p cnt offsets are sorted and within a text of size \p textSize.
+ */
+bool isValidOffsetSequence(const std::uint32_t* offsets,
+                           std::size_t cnt,
+                           std::size_t stride,
+                           std::uint64_t textSize)
+{
+    std::uint32_t prev = 0;
+    for (std::size_t i = 0; i < cnt; ++i) {
+        auto offset = offsets[i * stride];
+        if (offset < prev || offset > textSize)
+            return false;
+        prev = offset;
+    }
+    return true;
+}
+
+} // anonymous
+
+/*
+ * The sections of the file are written back to back, each one padded to a
+ * multiple of 8 bytes, so that the arrays in them are aligned when the file
+ * is mapped into memory.
+ */
+class TokenCache::Writer
+{
+public:
+    template <class T>
+    void put(const T* data, std::size_t cnt)
+    {
+        buf_.append(reinterpret_cast<const char*>(data), cnt * sizeof(T));
+        buf_.append((8 - buf_.size() % 8) % 8, '\0');
+    }
+
+    template <class T>
+    void put(const std::vector<T>& v) { put(v.data(), v.size()); }
+
+    std::string buf_;
+};
+
+class TokenCache::Reader
+{
+public:
+    Reader(const char* beg, const char* end)
+        : cur_(beg)
+        , end_(end)
+    {}
+
+    template <class T>
+    const T* get(std::size_t cnt)
+    {
+        if (!cur_ || cnt > static_cast<std::size_t>(end_ - cur_) / sizeof(T)) {
+            cur_ = nullptr;
+            return nullptr;
+        }
+        const std::size_t size = cnt * sizeof(T);
+        const std::size_t paddedSize = (size + 7) & ~std::size_t(7);
+        auto data = reinterpret_cast<const T*>(cur_);
+        cur_ = static_cast<std::size_t>(end_ - cur_) < paddedSize ? end_ : cur_ + paddedSize;
+        return data;
+    }
+
+    bool failed() const { return !cur_; }
+
+private:
+    const char* cur_;
+    const char* end_;
+};
+
+TokenCache::TokenCache(SyntaxTree* tree)
+    : tree_(tree)
+{}
+
+bool TokenCache::enabled() const
+{
+    return !tree_->options().tokenCacheDirectory().empty();
+}
+
+/**
+ * The key of the cache file: a hash of the tree's text and of the options
+ * that affect the lexer's output.
+ */
+std::uint64_t TokenCache::computeKey() const
+{
+    const auto& options = tree_->options();
+    const std::uint32_t config[] = {
+        Lexer::classificationMask(options),
+        static_cast<std::uint32_t>(options.dialect().std()),
+        static_cast<std::uint32_t>(options.commentMode()),
+        options.IsUTF16OffsetsTracked(),
+        static_cast<std::uint32_t>(options.diagnosticSeverityThreshold()),
+    };
+    auto h = hash64(0, reinterpret_cast<const char*>(config), sizeof(config));
+
+    // A text is cached only if it has no diagnostics, which depend on those reported.
+    for (const auto& id : options.suppressedDiagnostics())
+        h = hash64(h, id.c_str(), id.size() + 1);
+    return hash64(h, tree_->text().c_str(), tree_->text().size());
+}
+
+std::string TokenCache::filePath(std::uint64_t key) const
+{
+    char name[24];
+    std::snprintf(name, sizeof(name), "%016llx.psytk", static_cast<unsigned long long>(key));
+    return tree_->options().tokenCacheDirectory() + "/" + name;
+}
+
+void TokenCache::putTokens(Writer& w,
+                           const LexedTokens& tokens,
+                           std::unordered_map<const SyntaxLexeme*, std::uint32_t>& lexemeIdxs)
+{
+    w.put(tokens.kinds_);
+    w.put(tokens.flags_);
+    w.put(tokens.byteOffsets_);
+    w.put(tokens.charOffsets_);
+    w.put(tokens.byteSizes_);
+    w.put(tokens.charSizes_);
+    w.put(tokens.matchingBrackets_);
+
+    // A lexeme is referred to by its index plus 1; no lexeme, by 0.
+    std::vector<std::uint32_t> lexemeRefs;
+    lexemeRefs.reserve(tokens.lexemes_.size());
+    for (auto lexeme : tokens.lexemes_)
+        lexemeRefs.push_back(lexeme ? lexemeIdxs.at(lexeme) + 1 : 0);
+    w.put(lexemeRefs);
+}
+
+bool TokenCache::getTokens(Reader& r,
+                           std::uint32_t tkCnt,
+                           std::uint64_t textSize,
+                           const SyntaxLexeme::Kind* lexemeKinds,
+                           std::uint32_t lexemeCnt,
+                           LexedTokens& tokens,
+                           std::vector<const std::uint32_t*>& lexemeRefs)
+{
+    auto kinds = r.get<std::uint16_t>(tkCnt);
+    auto flags = r.get<LexedTokens::BitFields>(tkCnt);
+    auto byteOffsets = r.get<std::uint32_t>(tkCnt);
+    auto charOffsets = r.get<std::uint32_t>(tkCnt);
+    auto byteSizes = r.get<std::uint16_t>(tkCnt);
+    auto charSizes = r.get<std::uint16_t>(tkCnt);
+    auto matchingBrackets = r.get<LexedTokens::IndexType>(tkCnt);
+    auto refs = r.get<std::uint32_t>(tkCnt);
+    if (r.failed())
+        return false;
+
+    // Nothing in the file is trusted: every token must be within the text,
+    // in order, of a token kind, with a lexeme of its kind, and the matching
+    // brackets must be mutual. (A UTF-16 offset isn't greater than a byte one.)
+    std::uint64_t prevByteOffset = 0;
+    for (auto i = 0U; i < tkCnt; ++i) {
+        if (kinds[i] > Keyword_ExtPSY_omission
+                || byteOffsets[i] < prevByteOffset
+                || std::uint64_t(byteOffsets[i]) + byteSizes[i] > textSize
+                || std::uint64_t(charOffsets[i]) + charSizes[i] > textSize
+                || refs[i] > lexemeCnt) {
+            return false;
+        }
+        prevByteOffset = byteOffsets[i];
+
+        SyntaxLexeme::Kind lexemeK;
+        if (requiresLexeme(kinds[i], lexemeK)) {
+            if (!refs[i] || lexemeKinds[refs[i] - 1] != lexemeK)
+                return false;
+        }
+        else if (refs[i] && lexemeKinds[refs[i] - 1] != lexemeK) {
+            return false;
+        }
+
+        auto matchIdx = matchingBrackets[i];
+        if (!matchIdx)
+            continue;
+        if (matchIdx >= tkCnt
+                || matchingBrackets[matchIdx] != i
+                || (isOpeningBracket(kinds[i])
+                        ? matchIdx < i || !bracketsMatch(kinds[i], kinds[matchIdx])
+                        : matchIdx > i || !bracketsMatch(kinds[matchIdx], kinds[i]))) {
+            return false;
+        }
+    }
+
+    tokens.kinds_.assign(kinds, kinds + tkCnt);
+    tokens.flags_.assign(flags, flags + tkCnt);
+    tokens.byteOffsets_.assign(byteOffsets, byteOffsets + tkCnt);
+    tokens.charOffsets_.assign(charOffsets, charOffsets + tkCnt);
+    tokens.byteSizes_.assign(byteSizes, byteSizes + tkCnt);
+    tokens.charSizes_.assign(charSizes, charSizes + tkCnt);
+    tokens.matchingBrackets_.assign(matchingBrackets, matchingBrackets + tkCnt);
+    lexemeRefs.push_back(refs);
+    return true;
+}
+
+void TokenCache::resolveLexemes(LexedTokens& tokens,
+                                const std::uint32_t* lexemeRefs,
+                                const std::vector<SyntaxLexeme*>& lexemes)
+{
+    tokens.lexemes_.resize(tokens.kinds_.size());
+    for (auto i = 0U; i < tokens.lexemes_.size(); ++i)
+        tokens.lexemes_[i] = lexemeRefs[i] ? lexemes[lexemeRefs[i] - 1] : nullptr;
+}
+
+bool TokenCache::load()
+{
+    if (!enabled())
+        return false;
+
+    const auto key = computeKey();
+
+    // A SourceText is used only for mapping the (binary) file into memory.
+    auto [exit, data] = SourceText::mapFile(filePath(key));
+    if (exit != 0)
+        return false;
+
+    Reader r(data.c_str(), data.c_str() + data.size());
+    const auto textSize = tree_->text().size();
+    auto header = r.get<Header>(1);
+    if (!header
+            || std::memcmp(header->magic_, kMagic, sizeof(kMagic))
+            || header->key_ != key
+            || header->textSize_ != textSize
+            || header->textDigest_ != digest64(tree_->text().c_str(), textSize)
+            || !header->tokenCnt_
+            || !header->lineStartCnt_) {
+        return false;
+    }
+
+    // The counts must fit in the file, before any array is read.
+    const std::uint64_t tkSize = sizeof(std::uint16_t) * 3
+            + sizeof(LexedTokens::BitFields)
+            + sizeof(std::uint32_t) * 3
+            + sizeof(LexedTokens::IndexType);
+    const std::uint64_t minSize = sizeof(Header)
+            + std::uint64_t(header->lexemeCnt_) * (sizeof(SyntaxLexeme::Kind) + sizeof(std::uint32_t))
+            + (std::uint64_t(header->tokenCnt_) + header->commentCnt_) * tkSize
+            + std::uint64_t(header->lineDirectiveCnt_) * sizeof(std::uint32_t) * 3
+            + std::uint64_t(header->expansionCnt_) * sizeof(std::uint32_t) * 3
+            + std::uint64_t(header->lineStartCnt_) * sizeof(std::uint32_t);
+    if (minSize > data.size())
+        return false;
+
+    auto lexemeKinds = r.get<SyntaxLexeme::Kind>(header->lexemeCnt_);
+    auto lexemeSizes = r.get<std::uint32_t>(header->lexemeCnt_);
+    if (r.failed())
+        return false;
+    std::size_t lexemeChars = 0;
+    for (auto i = 0U; i < header->lexemeCnt_; ++i) {
+        if (lexemeKinds[i] > SyntaxLexeme::Kind::StringLiteral)
+            return false;
+        lexemeChars += lexemeSizes[i];
+    }
+    auto lexemeText = r.get<char>(lexemeChars);
+
+    LexedTokens tokens(tree_);
+    LexedTokens comments(nullptr);
+    std::vector<const std::uint32_t*> lexemeRefs;
+    if (!getTokens(r, header->tokenCnt_, textSize, lexemeKinds, header->lexemeCnt_, tokens, lexemeRefs)
+            || !getTokens(r, header->commentCnt_, textSize, lexemeKinds, header->lexemeCnt_, comments, lexemeRefs)) {
+        return false;
+    }
+
+    auto lineDirOffsets = r.get<std::uint32_t>(header->lineDirectiveCnt_);
+    auto lineDirLinenos = r.get<std::uint32_t>(header->lineDirectiveCnt_);
+    auto lineDirNameSizes = r.get<std::uint32_t>(header->lineDirectiveCnt_);
+    if (r.failed())
+        return false;
+    std::size_t lineDirNameChars = 0;
+    for (auto i = 0U; i < header->lineDirectiveCnt_; ++i)
+        lineDirNameChars += lineDirNameSizes[i];
+    auto lineDirNames = r.get<char>(lineDirNameChars);
+
+    auto expansions = r.get<std::uint32_t>(std::size_t(header->expansionCnt_) * 3);
+    auto lineStarts = r.get<std::uint32_t>(header->lineStartCnt_);
+    if (r.failed())
+        return false;
+
+    if (!isValidOffsetSequence(lineDirOffsets, header->lineDirectiveCnt_, 1, textSize)
+            || !isValidOffsetSequence(expansions, header->expansionCnt_, 3, textSize)
+            || !isValidOffsetSequence(lineStarts, header->lineStartCnt_, 1, textSize)
+            || lineStarts[0]) {
+        return false;
+    }
+    for (auto i = 1U; i < header->lineStartCnt_; ++i) {
+        if (lineStarts[i] == lineStarts[i - 1] || tree_->text().c_str()[lineStarts[i] - 1] != '\n')
+            return false;
+    }
+
+    // Everything is in place; only now is the tree touched.
+    std::vector<SyntaxLexeme*> lexemes;
+    lexemes.reserve(header->lexemeCnt_);
+    for (auto i = 0U; i < header->lexemeCnt_; ++i) {
+        const SyntaxLexeme* lexeme = nullptr;
+        switch (lexemeKinds[i]) {
+            case SyntaxLexeme::Kind::Identifier:
+                lexeme = tree_->identifier(lexemeText, lexemeSizes[i]);
+                break;
+            case SyntaxLexeme::Kind::IntegerConstant:
+                lexeme = tree_->integerConstant(lexemeText, lexemeSizes[i]);
+                break;
+            case SyntaxLexeme::Kind::FloatingConstant:
+                lexeme = tree_->floatingConstant(lexemeText, lexemeSizes[i]);
+                break;
+            case SyntaxLexeme::Kind::CharacterConstant:
+                lexeme = tree_->characterConstant(lexemeText, lexemeSizes[i]);
+                break;
+            default:
+                lexeme = tree_->stringLiteral(lexemeText, lexemeSizes[i]);
+                break;
+        }
+        lexemes.push_back(const_cast<SyntaxLexeme*>(lexeme));
+        lexemeText += lexemeSizes[i];
+    }
+
+    resolveLexemes(tokens, lexemeRefs[0], lexemes);
+    resolveLexemes(comments, lexemeRefs[1], lexemes);
+    for (auto i = 1U; i < header->tokenCnt_; ++i) {
+        if (tokens.flagsAt(i).expanded_) {
+            tree_->setRelexable(false);
+            break;
+        }
+    }
+    tree_->tokens() = std::move(tokens);
+    for (auto i = 0U; i < header->commentCnt_; ++i)
+        tree_->_comments.push_back(comments.recordAt(i));
+
+    // The directive of the text's start isn't stored: it has the tree's path.
+    tree_->relayLineDirective(0, 1, tree_->fileId());
+    std::string fileName;
+    FileId fileId;
+    for (auto i = 0U; i < header->lineDirectiveCnt_; ++i) {
+        if (fileName.compare(0, std::string::npos, lineDirNames, lineDirNameSizes[i])) {
+            fileName.assign(lineDirNames, lineDirNameSizes[i]);
+            fileId = FileId::of(fileName);
+        }
+        tree_->relayLineDirective(lineDirOffsets[i], lineDirLinenos[i], fileId);
+        lineDirNames += lineDirNameSizes[i];
+    }
+
+    for (auto i = 0U; i < header->expansionCnt_; ++i) {
+        tree_->relayExpansion(expansions[3 * i],
+                              std::make_pair(expansions[3 * i + 1], expansions[3 * i + 2]));
+    }
+
+    tree_->text().seedLineStarts(std::vector<unsigned int>(lineStarts,
+                                                           lineStarts + header->lineStartCnt_));
+
+    return true;
+}
+
+void TokenCache::store() const
+{
+    if (!enabled() || tree_->diagnosticCount())
+        return;
+
+    const auto& tokens = tree_->tokens();
+    LexedTokens comments(nullptr);
+    comments.clear();
+    for (const auto& tk : tree_->_comments)
+        comments.add(tk);
+
+    // The lexemes, in order of (first) appearance.
+    std::unordered_map<const SyntaxLexeme*, std::uint32_t> lexemeIdxs;
+    lexemeIdxs.reserve(tokens.count() / 4);
+    std::vector<SyntaxLexeme::Kind> lexemeKinds;
+    std::vector<std::uint32_t> lexemeSizes;
+    std::string lexemeText;
+    auto collect = [&] (const LexedTokens& tks) {
+        for (auto lexeme : tks.lexemes_) {
+            if (!lexeme || !lexemeIdxs.emplace(lexeme, lexemeKinds.size()).second)
+                continue;
+            lexemeKinds.push_back(lexeme->kind());
+            lexemeSizes.push_back(lexeme->size());
+            lexemeText.append(lexeme->c_str(), lexeme->size());
+        }
+    };
+    collect(tokens);
+    collect(comments);
+
+    const auto& lineDirs = tree_->lineDirectives();
+    std::vector<std::uint32_t> lineDirOffsets;
+    std::vector<std::uint32_t> lineDirLinenos;
+    std::vector<std::uint32_t> lineDirNameSizes;
+    std::string lineDirNames;
+    for (auto it = lineDirs.begin() + 1; it != lineDirs.end(); ++it) {
+        const auto& name = it->fileName();
+        lineDirOffsets.push_back(it->offset());
+        lineDirLinenos.push_back(it->lineno());
+        lineDirNameSizes.push_back(name.size());
+        lineDirNames.append(name);
+    }
+
+    std::vector<std::uint32_t> expansions;
+    for (const auto& expansion : tree_->expansions()) {
+        expansions.push_back(expansion.first);
+        expansions.push_back(expansion.second.first);
+        expansions.push_back(expansion.second.second);
+    }
+
+    const auto& lineStarts = tree_->text().lineStarts();
+
+    const auto key = computeKey();
+
+    Header header;
+    std::memcpy(header.magic_, kMagic, sizeof(kMagic));
+    header.key_ = key;
+    header.textDigest_ = digest64(tree_->text().c_str(), tree_->text().size());
+    header.textSize_ = tree_->text().size();
+    header.lexemeCnt_ = lexemeKinds.size();
+    header.tokenCnt_ = tokens.count();
+    header.commentCnt_ = comments.count();
+    header.lineDirectiveCnt_ = lineDirOffsets.size();
+    header.expansionCnt_ = expansions.size() / 3;
+    header.lineStartCnt_ = lineStarts.size();
+
+    Writer w;
+    w.put(&header, 1);
+    w.put(lexemeKinds);
+    w.put(lexemeSizes);
+    w.put(lexemeText.data(), lexemeText.size());
+    putTokens(w, tokens, lexemeIdxs);
+    putTokens(w, comments, lexemeIdxs);
+    w.put(lineDirOffsets);
+    w.put(lineDirLinenos);
+    w.put(lineDirNameSizes);
+    w.put(lineDirNames.data(), lineDirNames.size());
+    w.put(expansions);
+    w.put(lineStarts);
+
+    // Write to a temporary file that is then renamed, so that a concurrent
+    // load never sees a partially written file.
+    const auto path = filePath(key);
+    const auto tmpPath = path + "."
+            + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()))
+            + "." + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    {
+        std::ofstream ofs(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!ofs)
+            return;
+        ofs.write(w.buf_.data(), w.buf_.size());
+        if (!ofs) {
+            ofs.close();
+            std::remove(tmpPath.c_str());
+            return;
+        }
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()))
+        std::remove(tmpPath.c_str());
+}
@@ -0,0 +1,103 @@
+// Copyright (c) 2020/21 Leandro T. C. Melo <ltcmelo@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+// THE SOFTWARE.
+
+#ifndef PSYCHE_C_TOKEN_CACHE_H__
+#define PSYCHE_C_TOKEN_CACHE_H__
+
+#include "API.h"
+#include "APIFwds.h"
+
+#include "LexedTokens.h"
+
+#include "syntax/SyntaxLexeme.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace psy {
+namespace C {
+
+/**
+ * \brief The TokenCache class.
+ *
+ * An on-disk cache of the lexing results of a tree: its tokens, comments,
+ * lexemes, line directives, expansions, and line starts. The cache file of
+ * a tree is named after a hash of the tree's text and of the options that
+ * affect lexing; it lives in the directory given by
+ * ParseOptions::tokenCacheDirectory, and is only used if that is set.
+ *
+ * A cache file is used only if the size of its text, and a second (64-bit)
+ * hash of it, match those of the tree's text; and if its contents are valid,
+ * i.e., consistent with the text (a corrupted file is ignored). Neither hash
+ * is cryptographic: a collision is unlikely, but not impossible, and could be
+ * crafted; so the cache directory must not be writable by untrusted parties.
+ *
+ * \see ParseOptions::setTokenCacheDirectory
+ */
+class PSY_C_API TokenCache
+{
+public:
+    TokenCache(SyntaxTree* tree);
+
+    /**
+     * Load the lexing results of the tree from its cache file, if one exists
+     * (and is valid). Return whether they were loaded; if not, the tree is
+     * left as it was.
+     */
+    bool load();
+
+    /**
+     * Store the lexing results of the tree into its cache file, unless there
+     * are (lexer) diagnostics in the tree.
+     */
+    void store() const;
+
+private:
+    class Reader;
+    class Writer;
+
+    bool enabled() const;
+    std::uint64_t computeKey() const;
+    std::string filePath(std::uint64_t key) const;
+
+    static void putTokens(Writer& w,
+                          const LexedTokens& tokens,
+                          std::unordered_map<const SyntaxLexeme*, std::uint32_t>& lexemeIdxs);
+    static bool getTokens(Reader& r,
+                          std::uint32_t tkCnt,
+                          std::uint64_t textSize,
+                          const SyntaxLexeme::Kind* lexemeKinds,
+                          std::uint32_t lexemeCnt,
+                          LexedTokens& tokens,
+                          std::vector<const std::uint32_t*>& lexemeRefs);
+    static void resolveLexemes(LexedTokens& tokens,
+                               const std::uint32_t* lexemeRefs,
+                               const std::vector<SyntaxLexeme*>& lexemes);
+
+    SyntaxTree* tree_;
+};
+
+} // C
+} // psy
+
+#endif
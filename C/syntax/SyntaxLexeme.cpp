@@ -21,11 +21,15 @@
 
 #include "SyntaxLexeme.h"
 
+#include "SyntaxLexemes.h"
+
+#include "../common/infra/PsycheAssert.h"
+
 using namespace psy;
 using namespace C;
 
-SyntaxLexeme::SyntaxLexeme(const char* chars, unsigned int size, Kind kind)
-    : TextElement(chars, size)
+SyntaxLexeme::SyntaxLexeme(const char* chars, unsigned int size, unsigned int hash, Kind kind)
+    : TextElement(chars, size, hash)
     , BF_all_(0)
 {
     BF_.kind_ = static_cast<std::uint16_t>(kind);
@@ -98,80 +102,105 @@ std::string SyntaxLexeme::valueText() const
     return c_str();
 }
 
+template <class ValueT>
+ValueT SyntaxLexeme::castValue() const
+{
+    auto constant = static_cast<const Constant*>(this);
+    switch (kind()) {
+        case Kind::IntegerConstant:
+            return static_cast<ValueT>(constant->V_.integer_);
+
+        case Kind::FloatingConstant:
+            switch (static_cast<const FloatingConstant*>(this)->variant()) {
+                case FloatingConstant::Variant::Float:
+                    return static_cast<ValueT>(constant->V_.float_);
+                case FloatingConstant::Variant::Double:
+                    return static_cast<ValueT>(constant->V_.double_);
+                case FloatingConstant::Variant::LongDouble:
+                    return static_cast<ValueT>(constant->V_.longDouble_);
+            }
+            break;
+
+        case Kind::CharacterConstant:
+            return static_cast<ValueT>(constant->V_.character_);
+
+        default:
+            break;
+    }
+
+    PSYCHE_ASSERT(false, return ValueT(), "lexeme isn't a constant");
+}
+
 template <>
 int SyntaxLexeme::value<int>() const
 {
-    return std::stoi(valueText());
+    return castValue<int>();
 }
 
 template <>
 long SyntaxLexeme::value<long>() const
 {
-    return std::stol(valueText());
+    return castValue<long>();
 }
 
 template <>
 long long SyntaxLexeme::value<long long>() const
 {
-    return std::stoll(valueText());
+    return castValue<long long>();
 }
 
 template <>
 unsigned long SyntaxLexeme::value<unsigned long>() const
 {
-    return std::stoul(valueText());
+    return castValue<unsigned long>();
 }
 
 template <>
 unsigned long long SyntaxLexeme::value<unsigned long long>() const
 {
-    return std::stoull(valueText());
+    return castValue<unsigned long long>();
 }
 
 template <>
 float SyntaxLexeme::value<float>() const
 {
-    return std::stof(valueText());
+    return castValue<float>();
 }
 
 template <>
 double SyntaxLexeme::value<double>() const
 {
-    return std::stod(valueText());
+    return castValue<double>();
 }
 
 template <>
 long double SyntaxLexeme::value<long double>() const
 {
-    return std::stold(valueText());
+    return castValue<long double>();
 }
 
 template <>
 unsigned char SyntaxLexeme::value<unsigned char>() const
 {
-    // Lexeme is: 'c'
-    return c_str()[1];
+    return castValue<unsigned char>();
 }
 
 template <>
 wchar_t SyntaxLexeme::value<wchar_t>() const
 {
-    // Lexeme is: L'c'
-    return c_str()[2];
+    return castValue<wchar_t>();
 }
 
 template <>
 char16_t SyntaxLexeme::value<char16_t>() const
 {
-    // Lexeme is: u'c'
-    return c_str()[2];
+    return castValue<char16_t>();
 }
 
 template <>
 char32_t SyntaxLexeme::value<char32_t>() const
 {
-    // Lexeme is: U'c'
-    return c_str()[2];
+    return castValue<char32_t>();
 }
 
 template <>
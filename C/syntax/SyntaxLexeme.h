@@ -96,6 +96,9 @@ public:
      * }
      * \endcode
      *
+     * The value is decoded once, when \c this SyntaxLexeme is created, and
+     * cached; querying it doesn't parse the text again.
+     *
      * \remark 6.2.5
      * \remark 6.4
      */
@@ -104,11 +107,14 @@ public:
 protected:
     SyntaxLexeme(const char* chars,
                  unsigned int size,
+                 unsigned int hash,
                  Kind kind);
 
     void checkHexPrefix();
     void checkVariousPrefixesAndSuffixes();
 
+    template <class ValueT> ValueT castValue() const;
+
     struct BitFields
     {
         std::uint16_t kind_   : 3;
@@ -21,16 +21,109 @@
 
 #include "SyntaxLexemes.h"
 
+#include "../common/text/CharacterClass.h"
+
+#include <charconv>
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
+
 using namespace psy;
 using namespace C;
 
+namespace {
+
+template <class FloatT>
+FloatT decodeFloating(const char* first, const char* last, std::chars_format fmt, const char* c_str)
+{
+    FloatT v = 0;
+    auto res = std::from_chars(first, last, v, fmt);
+    if (res.ec == std::errc::result_out_of_range) {
+        // Rely on C's (locale-dependent) conversion only for the overflow
+        // and underflow values: the suffix, if any, stops it.
+        if constexpr (std::is_same<FloatT, float>::value)
+            v = std::strtof(c_str, nullptr);
+        else if constexpr (std::is_same<FloatT, double>::value)
+            v = std::strtod(c_str, nullptr);
+        else
+            v = std::strtold(c_str, nullptr);
+    }
+    return v;
+}
+
+unsigned int hexDigitValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return c - 'A' + 10;
+}
+
+/*
+ * Decode the character (escape sequence, or UTF-8 sequence, if \p utf8)
+ * at \p p, advancing it.
+ *
+ * \remark 6.4.4.4
+ */
+char32_t decodeCharacter(const char*& p, const char* last, bool utf8)
+{
+    unsigned char c = *p++;
+    if (c == '\\' && p != last) {
+        c = *p++;
+        switch (c) {
+            case 'a': return '\a';
+            case 'b': return '\b';
+            case 'f': return '\f';
+            case 'n': return '\n';
+            case 'r': return '\r';
+            case 't': return '\t';
+            case 'v': return '\v';
+            case 'e': return 0x1B; // GNU
+            case 'x': {
+                char32_t v = 0;
+                while (p != last && CharacterClass::isHexDigit(*p))
+                    v = (v << 4) | hexDigitValue(*p++);
+                return v;
+            }
+            case 'u':
+            case 'U': {
+                char32_t v = 0;
+                for (int n = c == 'u' ? 4 : 8; n && p != last && CharacterClass::isHexDigit(*p); --n)
+                    v = (v << 4) | hexDigitValue(*p++);
+                return v;
+            }
+            default:
+                if (c >= '0' && c <= '7') {
+                    char32_t v = c - '0';
+                    for (int n = 2; n && p != last && *p >= '0' && *p <= '7'; --n)
+                        v = (v << 3) | (*p++ - '0');
+                    return v;
+                }
+                return c; // \' \" \? \\ (or an unknown escape)
+        }
+    }
+
+    if (!utf8 || c < 0x80)
+        return c;
+
+    int contCnt = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : 1;
+    char32_t v = c & (0x3F >> contCnt);
+    for (; contCnt && p != last; --contCnt)
+        v = (v << 6) | (*p++ & 0x3F);
+    return v;
+}
+
+} // anonymous
+
 //---------------------//
 // Identifier/keywords //
 //---------------------//
 
-Identifier::Identifier(const char* chars, unsigned int size)
+Identifier::Identifier(const char* chars, unsigned int size, unsigned int hash)
     : SyntaxLexeme(chars,
                    size,
+                   hash,
                    Kind::Identifier)
 {}
 
@@ -38,18 +131,47 @@ Identifier::Identifier(const char* chars, unsigned int size)
 // Constants //
 //-----------//
 
-Constant::Constant(const char* chars, unsigned int size, Kind kind)
-    : SyntaxLexeme(chars, size, kind)
+Constant::Constant(const char* chars, unsigned int size, unsigned int hash, Kind kind)
+    : SyntaxLexeme(chars, size, hash, kind)
 {
     checkHexPrefix();
     checkVariousPrefixesAndSuffixes();
 }
 
-IntegerConstant::IntegerConstant(const char* chars, unsigned int size)
+IntegerConstant::IntegerConstant(const char* chars, unsigned int size, unsigned int hash)
     : Constant(chars,
                size,
+               hash,
                Kind::IntegerConstant)
-{}
+{
+    const char* first = begin();
+    const char* last = end();
+    while (last != first
+               && (last[-1] == 'u' || last[-1] == 'U' || last[-1] == 'l' || last[-1] == 'L')) {
+        --last;
+    }
+
+    int base = 10;
+    if (BF_.hex_) {
+        first += 2;
+        base = 16;
+    }
+    else if (last - first > 1 && *first == '0') {
+        if (first[1] == 'b' || first[1] == 'B') {
+            first += 2;
+            base = 2;
+        }
+        else {
+            ++first;
+            base = 8;
+        }
+    }
+
+    V_.integer_ = 0;
+    auto res = std::from_chars(first, last, V_.integer_, base);
+    if (res.ec == std::errc::result_out_of_range)
+        V_.integer_ = std::numeric_limits<std::uint64_t>::max();
+}
 
 IntegerConstant::Signedness IntegerConstant::signedness() const
 {
@@ -67,11 +189,39 @@ IntegerConstant::Variant IntegerConstant::variant() const
     return Variant::Int;
 }
 
-FloatingConstant::FloatingConstant(const char* chars, unsigned int size)
+FloatingConstant::FloatingConstant(const char* chars, unsigned int size, unsigned int hash)
     : Constant(chars,
                size,
+               hash,
                Kind::FloatingConstant)
-{}
+{
+    const char* first = begin();
+    const char* last = end();
+    if (last != first
+            && (last[-1] == 'f' || last[-1] == 'F' || last[-1] == 'l' || last[-1] == 'L')) {
+        --last;
+    }
+
+    auto fmt = std::chars_format::general;
+    if (BF_.hex_) {
+        first += 2;
+        fmt = std::chars_format::hex;
+    }
+
+    switch (variant()) {
+        case Variant::Float:
+            V_.float_ = decodeFloating<float>(first, last, fmt, c_str());
+            break;
+
+        case Variant::Double:
+            V_.double_ = decodeFloating<double>(first, last, fmt, c_str());
+            break;
+
+        case Variant::LongDouble:
+            V_.longDouble_ = decodeFloating<long double>(first, last, fmt, c_str());
+            break;
+    }
+}
 
 FloatingConstant::Variant FloatingConstant::variant() const
 {
@@ -84,11 +234,30 @@ FloatingConstant::Variant FloatingConstant::variant() const
     return Variant::Double;
 }
 
-CharacterConstant::CharacterConstant(const char* chars, unsigned int size)
+CharacterConstant::CharacterConstant(const char* chars, unsigned int size, unsigned int hash)
     : Constant(chars,
                size,
+               hash,
                Kind::CharacterConstant)
-{}
+{
+    const char* first = begin();
+    const char* last = end();
+    while (first != last && *first != '\'')
+        ++first;
+    if (first != last)
+        ++first;
+    if (last != first && last[-1] == '\'')
+        --last;
+
+    // A plain multi-character constant has its characters packed (as in GCC);
+    // for the others, the value is that of the last character.
+    const bool plain = *begin() == '\'';
+    V_.character_ = 0;
+    while (first != last) {
+        auto c = decodeCharacter(first, last, !plain);
+        V_.character_ = plain ? (V_.character_ << 8) | (c & 0xFF) : c;
+    }
+}
 
 CharacterConstant::Variant CharacterConstant::variant() const
 {
@@ -108,9 +277,10 @@ CharacterConstant::Variant CharacterConstant::variant() const
 // String literal //
 //----------------//
 
-StringLiteral::StringLiteral(const char *chars, unsigned int size)
+StringLiteral::StringLiteral(const char *chars, unsigned int size, unsigned int hash)
     : SyntaxLexeme(chars,
                    size,
+                   hash,
                    Kind::StringLiteral)
 {
     checkVariousPrefixesAndSuffixes();
@@ -40,7 +40,7 @@ namespace C {
 class PSY_C_API Identifier final : public SyntaxLexeme
 {
 public:
-    Identifier(const char* chars, unsigned int size);
+    Identifier(const char* chars, unsigned int size, unsigned int hash);
 
     virtual Identifier* asIdentifier() override { return this; }
 };
@@ -59,7 +59,23 @@ class PSY_C_API Constant : public SyntaxLexeme
 protected:
     Constant(const char* chars,
              unsigned int size,
+             unsigned int hash,
              Kind kind);
+
+    friend class SyntaxLexeme;
+
+    /*
+     * The value of the constant, decoded upon construction; the member
+     * in use depends on the kind and on the variant of the constant.
+     */
+    union
+    {
+        std::uint64_t integer_;
+        float float_;
+        double double_;
+        long double longDouble_;
+        char32_t character_;
+    } V_;
 };
 
 /**
@@ -68,7 +84,7 @@ protected:
 class PSY_C_API IntegerConstant final : public Constant
 {
 public:
-    IntegerConstant(const char* chars, unsigned int size);
+    IntegerConstant(const char* chars, unsigned int size, unsigned int hash);
 
     virtual IntegerConstant* asIntegerConstant() override { return this; }
 
@@ -108,7 +124,7 @@ public:
 class PSY_C_API FloatingConstant final : public Constant
 {
 public:
-    FloatingConstant(const char* chars, unsigned int size);
+    FloatingConstant(const char* chars, unsigned int size, unsigned int hash);
 
     virtual FloatingConstant* asFloatingConstant()  override { return this; }
 
@@ -135,7 +151,7 @@ public:
 class PSY_C_API CharacterConstant final : public Constant
 {
 public:
-    CharacterConstant(const char* chars, unsigned int size);
+    CharacterConstant(const char* chars, unsigned int size, unsigned int hash);
 
     virtual CharacterConstant* asCharacterConstant()  override { return this; }
 
@@ -166,7 +182,7 @@ public:
 class PSY_C_API StringLiteral final : public SyntaxLexeme
 {
 public:
-    StringLiteral(const char* chars, unsigned int size);
+    StringLiteral(const char* chars, unsigned int size, unsigned int hash);
 
     virtual StringLiteral* asStringLiteralExpression() { return nullptr; }
 
@@ -68,7 +68,7 @@ void SyntaxNamePrinter::print(const SyntaxNode* node, Style mode, std::ostream&
 
     nonterminal(node);
 
-    auto source = node->syntaxTree()->text().rawText();
+    const auto& source = node->syntaxTree()->text();
 
     os << std::endl;
     for (auto i = 0U; i < dump_.size(); ++i) {
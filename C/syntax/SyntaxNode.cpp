@@ -24,6 +24,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <mutex>
 
 using namespace psy;
 using namespace C;
@@ -84,7 +85,7 @@ SyntaxToken SyntaxNode::findValidToken(const std::vector<SyntaxHolder>& syntaxHo
                 break;
         }
     }
-    return 0;
+    return SyntaxToken::invalid();
 }
 
 SyntaxToken SyntaxNode::tokenAtIndex(LexedTokens::IndexType tkIdx) const
@@ -476,5 +477,25 @@ std::string PSY_C_API to_string(SyntaxKind kind)
     }
 }
 
+const StatementSyntax* FunctionDefinitionSyntax::body() const
+{
+    if (!isBodyDeferred())
+        return body_;
+
+    std::lock_guard<std::mutex> lock(tree_->deferredBodiesMutex());
+    if (!bodyExpanded_.load(std::memory_order_relaxed)) {
+        body_ = tree_->parseDeferredFunctionBody(this);
+        bodyExpanded_.store(true, std::memory_order_release);
+    }
+    return body_;
+}
+
+std::vector<SyntaxHolder> FunctionDefinitionSyntax::childNodesAndTokens() const
+{
+    body();
+    auto self = { SyntaxHolder(specs_), SyntaxHolder(decltor_), SyntaxHolder(body_) };
+    return merge(BaseSyntax::childNodesAndTokens(), self);
+}
+
 } // C
 } // psy
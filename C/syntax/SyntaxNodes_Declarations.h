@@ -28,6 +28,8 @@
 
 #include "parser/LexedTokens.h"
 
+#include <atomic>
+
 namespace psy {
 namespace C {
 
@@ -382,13 +384,40 @@ class PSY_C_API FunctionDefinitionSyntax final : public DeclarationSyntax
 public:
     const SpecifierListSyntax* specifiers() const { return specs_; }
     const DeclaratorSyntax* declarator() const { return decltor_; }
-    const StatementSyntax* body() const { return body_; }
+
+    /**
+     * The body of \c this FunctionDefinitionSyntax. If its parse was deferred
+     * (see ParseOptions::deferFunctionBodies), it's parsed (into the pool of
+     * the tree) upon the first call; diagnostics are reported then.
+     *
+     * \remark
+     * A deferred body is parsed once, even if that parse yields no body.
+     * Concurrent calls, for any function definitions of a same tree, are
+     * safe: the parses of deferred bodies of a tree are serialized, and a
+     * call that finds the body already parsed doesn't block. Yet, while a
+     * deferred body is parsed, the diagnostics of the tree grow and its pool
+     * allocates; other than through the diagnostics snapshot, don't inspect
+     * these concurrently with a call.
+     */
+    const StatementSyntax* body() const;
+
+    /**
+     * Whether the body of \c this FunctionDefinitionSyntax is deferred and
+     * yet to be parsed; a traversal (of the children) parses it.
+     */
+    bool isBodyDeferred() const
+    {
+        return deferredBodyTkIdx_ && !bodyExpanded_.load(std::memory_order_acquire);
+    }
+
+    virtual std::vector<SyntaxHolder> childNodesAndTokens() const override;
 
 private:
     SpecifierListSyntax* specs_ = nullptr;
     DeclaratorSyntax* decltor_ = nullptr;
-    StatementSyntax* body_ = nullptr;
-    AST_CHILD_LST3(specs_, decltor_, body_);
+    mutable StatementSyntax* body_ = nullptr;
+    LexedTokens::IndexType deferredBodyTkIdx_ = 0;
+    mutable std::atomic<bool> bodyExpanded_ { false };
 
     mutable FunctionSymbol* sym_;
 };
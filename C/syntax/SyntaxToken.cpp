@@ -204,59 +204,41 @@ const char* tokenNames[] =
 using namespace psy;
 using namespace C;
 
-SyntaxToken::SyntaxToken(SyntaxTree* tree)
-    : tree_(tree)
-    , rawSyntaxK_(0)
-    , byteSize_(0)
-    , charSize_(0)
-    , byteOffset_(0)
-    , charOffset_(0)
-    , matchingBracket_(0)
-    , BF_all_(0)
-    , lineno_(0)
-    , column_(0)
-    , lexeme_(nullptr)
-{
-    if (!tree_)
-        BF_.missing_ = true;
-}
+SyntaxToken::SyntaxToken(const LexedTokens* tokens, LexedTokens::IndexType tkIdx)
+    : tokens_(tokens)
+    , tkIdx_(tkIdx)
+{}
 
 SyntaxToken::~SyntaxToken()
 {}
 
-void SyntaxToken::setup()
+bool SyntaxToken::isComment() const
 {
-    rawSyntaxK_ = 0;
-    byteSize_ = 0;
-    charSize_ = 0;
-    byteOffset_ = 0;
-    charOffset_ = 0;
-    matchingBracket_ = 0;
-    BF_all_ = 0;
-    lexeme_ = nullptr;
+    return isComment(rawKind());
 }
 
-bool SyntaxToken::isComment() const
+bool SyntaxToken::isComment(unsigned int rawKind)
 {
-    return rawSyntaxK_ == MultiLineCommentTrivia
-            || rawSyntaxK_ == MultiLineDocumentationCommentTrivia
-            || rawSyntaxK_ == SingleLineCommentTrivia
-            || rawSyntaxK_ == SingleLineDocumentationCommentTrivia
-            || rawSyntaxK_ == Keyword_ExtPSY_omission;
+    return rawKind == MultiLineCommentTrivia
+            || rawKind == MultiLineDocumentationCommentTrivia
+            || rawKind == SingleLineCommentTrivia
+            || rawKind == SingleLineDocumentationCommentTrivia
+            || rawKind == Keyword_ExtPSY_omission;
 }
 
 Location SyntaxToken::location() const
 {
-    LinePosition lineStart(lineno_, column_);
-    LinePosition lineEnd(lineno_, column_ + byteSize_ - 1); // TODO: Account for joined tokens.
-    FileLinePositionSpan fileLineSpan(tree_->filePath(), lineStart, lineEnd);
+    auto tree = tokens_->tree();
+    LinePosition lineStart = tree->computeTextPosition(byteStart());
+    LinePosition lineEnd(lineStart.line(), lineStart.character() + tokens_->byteSizeAt(tkIdx_) - 1); // TODO: Account for joined tokens.
+    FileLinePositionSpan fileLineSpan(tree->fileId(), lineStart, lineEnd);
 
     return Location::create(fileLineSpan);
 }
 
 SyntaxToken::Category SyntaxToken::category() const
 {
-    return category(SyntaxKind(rawSyntaxK_));
+    return category(kind());
 }
 
 SyntaxToken::Category SyntaxToken::category(SyntaxKind k)
@@ -355,7 +337,7 @@ SyntaxToken::Category SyntaxToken::category(SyntaxKind k)
 
 SyntaxLexeme* SyntaxToken::valueLexeme() const
 {
-    return lexeme_;
+    return tokens_->lexemeAt(tkIdx_);
 }
 
 std::string SyntaxToken::valueText() const
@@ -365,7 +347,8 @@ std::string SyntaxToken::valueText() const
 
 const char* SyntaxToken::valueText_c_str() const
 {
-    switch (rawSyntaxK_) {
+    auto rawKind = tokens_->rawKindAt(tkIdx_);
+    switch (rawKind) {
         case IdentifierToken:
         case IntegerConstantToken:
         case FloatingConstantToken:
@@ -383,16 +366,16 @@ const char* SyntaxToken::valueText_c_str() const
         case StringLiteral_u8R_Token:
         case StringLiteral_uR_Token:
         case StringLiteral_UR_Token:
-            return lexeme_->c_str();
+            return tokens_->lexemeAt(tkIdx_)->c_str();
 
         default:
-            return tokenNames[rawSyntaxK_];
+            return tokenNames[rawKind];
     }
 }
 
 bool SyntaxToken::isValid() const
 {
-    return tree_ != nullptr;
+    return tkIdx_ != LexedTokens::invalidIndex();
 }
 
 TextSpan SyntaxToken::span() const
@@ -402,7 +385,9 @@ TextSpan SyntaxToken::span() const
 
 SyntaxToken SyntaxToken::invalid()
 {
-    return SyntaxToken(nullptr);
+    // A container with just the marker (invalid) token.
+    static const LexedTokens tokens(nullptr);
+    return SyntaxToken(&tokens, LexedTokens::invalidIndex());
 }
 
 namespace psy {
@@ -410,10 +395,9 @@ namespace C {
 
 bool operator==(const SyntaxToken& a, const SyntaxToken& b)
 {
-    return a.tree_ == b.tree_
-            && a.rawSyntaxK_ == b.rawSyntaxK_
-            && a.byteOffset_ == b.byteOffset_
-            && a.byteSize_ == b.byteSize_;
+    if (!a.isValid() || !b.isValid())
+        return a.isValid() == b.isValid();
+    return a.tokens_ == b.tokens_ && a.tkIdx_ == b.tkIdx_;
 }
 
 bool operator!=(const SyntaxToken& a, const SyntaxToken& b)
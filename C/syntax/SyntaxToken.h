@@ -27,6 +27,8 @@
 #include "LanguageDialect.h"
 #include "SyntaxKind.h"
 
+#include "parser/LexedTokens.h"
+
 #include "../common/location/Location.h"
 #include "../common/text/TextSpan.h"
 
@@ -46,6 +48,10 @@ namespace C {
  * \note
  * Influence by the API of Clang/LLVM is present as well; specifically:
  * \c clang::Token and \c clang::Preprocessor.
+ *
+ * \note
+ * A SyntaxToken is a lightweight handle: the data of the token is stored in
+ * the LexedTokens of its SyntaxTree.
  */
 class PSY_C_API SyntaxToken
 {
@@ -55,22 +61,22 @@ public:
     /**
      * The SyntaxKind of \c this SyntaxToken.
      */
-    SyntaxKind kind() const { return SyntaxKind(rawSyntaxK_); }
+    SyntaxKind kind() const { return SyntaxKind(tokens_->rawKindAt(tkIdx_)); }
 
     /**
      * Whether \c this SyntaxToken is of SyntaxKind \p k.
      */
-    bool isKind(SyntaxKind k) { return kind() == k; }
+    bool isKind(SyntaxKind k) const { return kind() == k; }
 
     /**
      * The raw kind of \c this SyntaxToken.
      */
-    unsigned int rawKind() const { return rawSyntaxK_; }
+    unsigned int rawKind() const { return tokens_->rawKindAt(tkIdx_); }
 
     /**
      * Whether \c this SyntaxToken is of the given \p rawKind.
      */
-    bool isRawKind(unsigned int rawKind) const { return rawSyntaxK_ == rawKind; }
+    bool isRawKind(unsigned int rawKind) const { return tokens_->rawKindAt(tkIdx_) == rawKind; }
 
     /**
      * \brief The existing SyntaxToken categories.
@@ -121,24 +127,24 @@ public:
     /**
      * Whether \c this SyntaxToken is at the start of a line.
      */
-    bool isAtStartOfLine() const { return BF_.atStartOfLine_; }
+    bool isAtStartOfLine() const { return BF().atStartOfLine_; }
 
     /**
      * Whether \c this SyntaxToken has any leading trivia (e.g., a whitespace).
      */
-    bool hasLeadingTrivia() const { return BF_.hasLeadingWS_; }
+    bool hasLeadingTrivia() const { return BF().hasLeadingWS_; }
 
     /**
      * Whether \c this SyntaxToken is joined with the previous one.
      */
-    bool isJoined() const { return BF_.joined_; }
+    bool isJoined() const { return BF().joined_; }
 
     /**
      * Whether \c this SyntaxToken is the result of a preprocessor expansion.
      *
      * \see SyntaxToken::isPPGenerated
      */
-    bool isPPExpanded() const { return BF_.expanded_; }
+    bool isPPExpanded() const { return BF().expanded_; }
 
     /**
      * Whether \c this SyntaxToken is the result of a preprocessor expansion
@@ -160,7 +166,7 @@ public:
      *
      * \see SyntaxToken::isPPExpanded
      */
-    bool isPPGenerated() const { return BF_.generated_; }
+    bool isPPGenerated() const { return BF().generated_; }
 
     /**
      * Whether \c this SyntaxToken is a comment.
@@ -170,7 +176,7 @@ public:
     /**
      * Whether \c this SyntaxToken is missing from the source.
      */
-    bool isMissing() const { return BF_.missing_; }
+    bool isMissing() const { return BF().missing_; }
 
     /**
      * Whether \c this SyntaxToken is valid.
@@ -195,61 +201,27 @@ public:
     static SyntaxToken invalid();
 
 private:
-    SyntaxToken(SyntaxTree* tree);
-    void setup();
+    SyntaxToken(const LexedTokens* tokens, LexedTokens::IndexType tkIdx);
 
     friend class SyntaxTree;
     friend class SyntaxNode;
+    friend class LexedTokens;
     friend class Lexer;
     friend class Parser;
     friend class Binder;
 
-    unsigned int byteStart() const { return byteOffset_; }
-    unsigned int byteEnd() const { return byteOffset_ + byteSize_; }
+    static bool isComment(unsigned int rawKind);
 
-    unsigned int charStart() const { return charOffset_; }
-    unsigned int charEnd() const { return charOffset_ + charSize_; }
+    const LexedTokens::BitFields& BF() const { return tokens_->flagsAt(tkIdx_); }
 
-    SyntaxTree* tree_;
+    unsigned int byteStart() const { return tokens_->byteOffsetAt(tkIdx_); }
+    unsigned int byteEnd() const { return byteStart() + tokens_->byteSizeAt(tkIdx_); }
 
-    /*
-     * Watch for data layout (size) before changing members or their order.
-     */
+    unsigned int charStart() const { return tokens_->charOffsetAt(tkIdx_); }
+    unsigned int charEnd() const { return charStart() + tokens_->charSizeAt(tkIdx_); }
 
-    std::uint16_t rawSyntaxK_;  // Keep the same underlying type of SyntaxKind.
-    std::uint16_t byteSize_;
-    std::uint16_t charSize_;
-    std::uint32_t byteOffset_;
-    std::uint32_t charOffset_;  // UTF-16
-    std::size_t matchingBracket_;
-
-    struct BitsFields
-    {
-        std::uint16_t atStartOfLine_ : 1;
-        std::uint16_t hasLeadingWS_  : 1;
-        std::uint16_t joined_        : 1;
-        std::uint16_t expanded_      : 1;
-        std::uint16_t generated_     : 1;
-        std::uint16_t missing_       : 1;
-    };
-    union
-    {
-        std::uint16_t BF_all_;
-        BitsFields BF_;
-    };
-
-    unsigned int lineno_;
-    unsigned int column_;
-
-    union
-    {
-        SyntaxLexeme* lexeme_;
-        const Identifier* identifier_;
-        const IntegerConstant* integer_;
-        const FloatingConstant* floating_;
-        const CharacterConstant* character_;
-        const StringLiteral* string_;
-    };
+    const LexedTokens* tokens_;
+    LexedTokens::IndexType tkIdx_;
 
     friend bool operator==(const SyntaxToken& a, const SyntaxToken& b);
 };
@@ -133,7 +133,7 @@ void TestFrontend::parse(std::string source,
 
 #ifdef DEBUG_DIAGNOSTICS
     if (!tree_->diagnostics().empty()) {
-        for (auto& diagnostic : tree_->diagnostics()) {
+        for (auto diagnostic : tree_->diagnostics()) {
             diagnostic.outputIndent_ = 2;
             std::cout << std::endl << diagnostic << std::endl;
         }
@@ -0,0 +1,1672 @@
+// Copyright (c) 2020/21 Leandro T. C. Melo <ltcmelo@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "TestSyntaxTree.h"
+
+#include "Compilation.h"
+#include "MemoryPool.h"
+#include "Unparser.h"
+
+#include "parser/LexedTokens.h"
+#include "parser/LexemeInterner.h"
+#include "parser/Lexer.h"
+#include "parser/TokenCache.h"
+#include "syntax/SyntaxLexemes.h"
+#include "syntax/SyntaxNamePrinter.h"
+#include "syntax/SyntaxVisitor.h"
+
+#include "../common/text/ConcurrentTextElementTable.h"
+#include "../common/text/TextScanner.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace psy;
+using namespace C;
+
+void TestSyntaxTree::testAll()
+{
+    std::cout << "    tree" << std::endl;
+    run<TestSyntaxTree>(tests_);
+    std::cout << std::endl;
+}
+
+void TestSyntaxTree::setUp()
+{
+}
+
+void TestSyntaxTree::tearDown()
+{
+}
+
+void TestSyntaxTree::expectSameTokens(const SyntaxTree* tree, const SyntaxTree* refTree)
+{
+    const auto& tokens = tree->tokens();
+    const auto& refTokens = refTree->tokens();
+    PSYCHE_EXPECT_INT_EQ(refTokens.count(), tokens.count());
+
+    for (auto tkIdx = 1U; tkIdx < refTokens.count(); ++tkIdx) {
+        PSYCHE_EXPECT_INT_EQ(refTokens.rawKindAt(tkIdx), tokens.rawKindAt(tkIdx));
+        PSYCHE_EXPECT_INT_EQ(refTokens.byteOffsetAt(tkIdx), tokens.byteOffsetAt(tkIdx));
+        PSYCHE_EXPECT_INT_EQ(refTokens.charOffsetAt(tkIdx), tokens.charOffsetAt(tkIdx));
+        PSYCHE_EXPECT_INT_EQ(refTokens.byteSizeAt(tkIdx), tokens.byteSizeAt(tkIdx));
+        PSYCHE_EXPECT_INT_EQ(refTokens.charSizeAt(tkIdx), tokens.charSizeAt(tkIdx));
+        PSYCHE_EXPECT_INT_EQ(refTokens.flagsAt(tkIdx).atStartOfLine_, tokens.flagsAt(tkIdx).atStartOfLine_);
+        PSYCHE_EXPECT_INT_EQ(refTokens.flagsAt(tkIdx).hasLeadingWS_, tokens.flagsAt(tkIdx).hasLeadingWS_);
+        PSYCHE_EXPECT_INT_EQ(refTokens.flagsAt(tkIdx).joined_, tokens.flagsAt(tkIdx).joined_);
+        PSYCHE_EXPECT_INT_EQ(refTokens.matchingBracketAt(tkIdx), tokens.matchingBracketAt(tkIdx));
+
+        auto refLexeme = refTokens.lexemeAt(tkIdx);
+        auto lexeme = tokens.lexemeAt(tkIdx);
+        PSYCHE_EXPECT_TRUE(!refLexeme == !lexeme);
+        if (refLexeme)
+            PSYCHE_EXPECT_STR_EQ(std::string(refLexeme->c_str()), std::string(lexeme->c_str()));
+    }
+
+    PSYCHE_EXPECT_INT_EQ(refTree->_comments.size(), tree->_comments.size());
+    for (auto i = 0U; i < refTree->_comments.size(); ++i) {
+        PSYCHE_EXPECT_INT_EQ(refTree->_comments[i].byteOffset_, tree->_comments[i].byteOffset_);
+        PSYCHE_EXPECT_INT_EQ(refTree->_comments[i].charOffset_, tree->_comments[i].charOffset_);
+    }
+
+    const auto& lineDirs = tree->lineDirectives();
+    const auto& refLineDirs = refTree->lineDirectives();
+    PSYCHE_EXPECT_INT_EQ(refLineDirs.size(), lineDirs.size());
+    for (auto i = 0U; i < refLineDirs.size(); ++i) {
+        PSYCHE_EXPECT_INT_EQ(refLineDirs[i].offset(), lineDirs[i].offset());
+        PSYCHE_EXPECT_INT_EQ(refLineDirs[i].lineno(), lineDirs[i].lineno());
+    }
+}
+
+void TestSyntaxTree::expectSameText(const SyntaxTree* tree, const SyntaxTree* refTree)
+{
+    std::ostringstream oss;
+    Unparser(const_cast<SyntaxTree*>(tree)).unparse(tree->root(), oss);
+    std::ostringstream refOss;
+    Unparser(const_cast<SyntaxTree*>(refTree)).unparse(refTree->root(), refOss);
+    PSYCHE_EXPECT_STR_EQ(refOss.str(), oss.str());
+}
+
+void TestSyntaxTree::relexAndCompare(const std::string& text,
+                                     unsigned int spanStart,
+                                     unsigned int spanEnd,
+                                     const std::string& newText,
+                                     ParseOptions options)
+{
+    auto baseTree = SyntaxTree::parseText(text, options);
+    TextChange change(TextSpan(spanStart, spanEnd), newText);
+    auto tree = baseTree->withChangedText(change);
+
+    auto changedText = text;
+    changedText.replace(spanStart, spanEnd - spanStart, newText);
+    auto refTree = SyntaxTree::parseText(changedText, options);
+
+    PSYCHE_EXPECT_STR_EQ(changedText, std::string(tree->text().rawText()));
+    expectSameTokens(tree.get(), refTree.get());
+    expectSameText(tree.get(), refTree.get());
+    PSYCHE_EXPECT_INT_EQ(refTree->diagnosticCount(), tree->diagnosticCount());
+}
+
+/*
+ * The sequence of brackets is unchanged, and so is the count of tokens.
+ */
+void TestSyntaxTree::case0001()
+{
+    std::string s = "int x;\n"
+                    "void f(int a) {\n"
+                    "    if (a) { x = a; }\n"
+                    "}\n"
+                    "int y[2];\n";
+    auto pos = s.find("x = a");
+    relexAndCompare(s, pos, pos + 1, "yy");
+}
+
+/*
+ * The sequence of brackets is unchanged, but the count of tokens changes.
+ */
+void TestSyntaxTree::case0002()
+{
+    std::string s = "int x;\n"
+                    "void f(int a) {\n"
+                    "    if (a) { x = a; }\n"
+                    "}\n"
+                    "int y[2];\n";
+    auto pos = s.find("x = a");
+    relexAndCompare(s, pos, pos + 5, "x = a + 1; a = x - 1");
+}
+
+/*
+ * A bracket is inserted: the brackets are matched anew.
+ */
+void TestSyntaxTree::case0003()
+{
+    std::string s = "void f(int a) {\n"
+                    "    if (a) { a = 1; }\n"
+                    "}\n"
+                    "int y[2];\n";
+    auto pos = s.find("a = 1;");
+    relexAndCompare(s, pos, pos, "{ ");
+}
+
+/*
+ * A bracket is removed from within a pair that spans the change.
+ */
+void TestSyntaxTree::case0004()
+{
+    std::string s = "void f(int a) {\n"
+                    "    int b[(1)];\n"
+                    "    g((a), b);\n"
+                    "}\n";
+    auto pos = s.find("(a)");
+    relexAndCompare(s, pos, pos + 3, "a");
+}
+
+/*
+ * The change is in a line continued from the previous one.
+ */
+void TestSyntaxTree::case0005()
+{
+    std::string s = "int x = \\\n"
+                    "    1 + 2;\n"
+                    "int y;\n";
+    auto pos = s.find("2");
+    relexAndCompare(s, pos, pos + 1, "(3)");
+}
+
+/*
+ * The change is in a comment, and the text has non-ASCII characters.
+ */
+void TestSyntaxTree::case0006()
+{
+    std::string s = "int x; /* \xc3\xa1 */\n"
+                    "int y = x; // \xc3\xa9\n"
+                    "int z;\n";
+    auto pos = s.find("/*");
+    ParseOptions options;
+    options.setCommentMode(ParseOptions::CommentMode::KeepAll);
+    relexAndCompare(s, pos + 2, pos + 3, " \xc3\xa1\xc3\xa1 ", options);
+}
+
+/*
+ * The change is at the start of the text, and has a line directive after it.
+ */
+void TestSyntaxTree::case0007()
+{
+    std::string s = "int x;\n"
+                    "# 10 \"a.h\"\n"
+                    "int y;\n";
+    relexAndCompare(s, 0, 3, "long");
+}
+
+/*
+ * The change removes the end of the text.
+ */
+void TestSyntaxTree::case0008()
+{
+    std::string s = "int x;\n"
+                    "void f() { }\n";
+    auto pos = s.find("void");
+    relexAndCompare(s, pos, s.size(), "");
+}
+
+/*
+ * Across a long sequence of changes, each with a new identifier, the lexemes
+ * shared by the trees are bounded.
+ */
+void TestSyntaxTree::case0009()
+{
+    std::string s = "int x;\n"
+                    "int y;\n";
+    auto tree = SyntaxTree::parseText(s);
+    for (auto i = 0U; i < 10000; ++i) {
+        std::string ident = "v" + std::to_string(i);
+        tree = tree->withChangedText(TextChange(TextSpan(4, tree->text().rawText().find(';')), ident));
+        PSYCHE_EXPECT_TRUE(tree->lexemeCount() <= (1 << 12) + 1);
+    }
+
+    auto refTree = SyntaxTree::parseText(std::string(tree->text().rawText()));
+    expectSameTokens(tree.get(), refTree.get());
+}
+
+/*
+ * Trees that share lexemes are changed concurrently.
+ */
+void TestSyntaxTree::case0010()
+{
+    std::string s;
+    for (auto i = 0U; i < 100; ++i)
+        s += "int x" + std::to_string(i) + ";\n";
+    auto baseTree = SyntaxTree::parseText(s);
+
+    const unsigned int kThreadCnt = 4;
+    std::vector<std::unique_ptr<SyntaxTree>> trees(kThreadCnt);
+    std::vector<std::thread> workers;
+    for (auto i = 0U; i < kThreadCnt; ++i) {
+        workers.emplace_back([&, i] () {
+            for (auto j = 0U; j < 100; ++j) {
+                std::string ident = "t" + std::to_string(i) + "_" + std::to_string(j);
+                trees[i] = baseTree->withChangedText(TextChange(TextSpan(4, 6), ident));
+            }
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+
+    for (auto i = 0U; i < kThreadCnt; ++i) {
+        auto refTree = SyntaxTree::parseText(std::string(trees[i]->text().rawText()));
+        expectSameTokens(trees[i].get(), refTree.get());
+    }
+}
+
+namespace {
+
+/*
+ * A text of (at least) \p size bytes, large enough to be lexed in chunks,
+ * whose constructs (comments, strings, continued lines, line directives,
+ * brackets) are likely to cross the boundaries of the chunks.
+ */
+std::string largeText(std::size_t size)
+{
+    std::string s;
+    for (auto i = 0U; s.size() < size; ++i) {
+        auto n = std::to_string(i);
+        s += "/* \xc3\xa1 " + n + "\n"
+             "   a comment of many lines */\n"
+             "# " + n + " \"f" + n + ".h\"\n"
+             "const char* s" + n + " = \"a \\\" \\n string\";\n"
+             "int x" + n + " = \\\n"
+             "    '\\'' + 0x" + n + ";\n"
+             "void f" + n + "(int a[" + n + "]) {\n"
+             "    if (a[0]) { x" + n + " = (a[1] + (" + n + ")); } // \xc3\xa9\n"
+             "}\n";
+    }
+    return s;
+}
+
+} // anonymous
+
+/*
+ * A large text is lexed in chunks, concurrently, as it's lexed sequentially.
+ */
+void TestSyntaxTree::case0050()
+{
+    const auto s = largeText(3 << 19);
+    ParseOptions options;
+    options.setCommentMode(ParseOptions::CommentMode::KeepAll);
+    auto refTree = SyntaxTree::parseText(s, options);
+    options.setLexingThreadCount(4);
+    auto tree = SyntaxTree::parseText(s, options);
+    expectSameTokens(tree.get(), refTree.get());
+    expectSameText(tree.get(), refTree.get());
+    PSYCHE_EXPECT_INT_EQ(refTree->diagnosticCount(), tree->diagnosticCount());
+}
+
+/*
+ * A large text, whose chunks can't be lexed independently (one starts within
+ * a comment), is lexed as it's lexed sequentially.
+ */
+void TestSyntaxTree::case0051()
+{
+    std::string s = "/*\n";
+    for (auto i = 0U; s.size() < (3 << 19); ++i)
+        s += "int y" + std::to_string(i) + ";\n";
+    s += "*/\n" + largeText(1 << 18);
+    ParseOptions options;
+    auto refTree = SyntaxTree::parseText(s, options);
+    options.setLexingThreadCount(4);
+    auto tree = SyntaxTree::parseText(s, options);
+    expectSameTokens(tree.get(), refTree.get());
+    expectSameText(tree.get(), refTree.get());
+}
+
+void TestSyntaxTree::parseInParallelAndCompare(const std::string& text)
+{
+    ParseOptions options;
+    auto refTree = SyntaxTree::parseText(text, options);
+    options.setParsingThreadCount(4);
+    auto tree = SyntaxTree::parseText(text, options);
+    expectSameText(tree.get(), refTree.get());
+
+    auto refDeclIt = refTree->translationUnitRoot()->declarations();
+    auto declIt = tree->translationUnitRoot()->declarations();
+    for (; refDeclIt && declIt; refDeclIt = refDeclIt->next, declIt = declIt->next) {
+        PSYCHE_EXPECT_INT_EQ(refDeclIt->value->kind(), declIt->value->kind());
+        PSYCHE_EXPECT_INT_EQ(refDeclIt->value->firstToken().span().start(),
+                             declIt->value->firstToken().span().start());
+        PSYCHE_EXPECT_INT_EQ(refDeclIt->value->lastToken().span().start(),
+                             declIt->value->lastToken().span().start());
+    }
+    PSYCHE_EXPECT_TRUE(!refDeclIt && !declIt);
+
+    const auto& refDiagnostics = refTree->diagnostics();
+    const auto& diagnostics = tree->diagnostics();
+    PSYCHE_EXPECT_INT_EQ(refDiagnostics.size(), diagnostics.size());
+    for (auto i = 0U; i < refDiagnostics.size(); ++i) {
+        PSYCHE_EXPECT_STR_EQ(refDiagnostics[i].descriptor().id(), diagnostics[i].descriptor().id());
+        PSYCHE_EXPECT_TRUE(refDiagnostics[i].location() == diagnostics[i].location());
+    }
+}
+
+/*
+ * A large text is parsed in regions, concurrently, as it's parsed sequentially.
+ */
+void TestSyntaxTree::case0052()
+{
+    parseInParallelAndCompare(largeText(1 << 19));
+}
+
+/*
+ * Syntax errors, in some regions, are diagnosed as in a sequential parse.
+ */
+void TestSyntaxTree::case0053()
+{
+    std::string s;
+    for (auto i = 0U; s.size() < (1 << 19); ++i) {
+        auto n = std::to_string(i);
+        s += "int x" + n + " = (" + n + " + 1);\n";
+        if (i % 997 == 0)
+            s += "int y" + n + " = ;\n";
+        if (i % 1999 == 0)
+            s += "void f" + n + "(int a) { if (a) { x0 = a } }\n";
+    }
+    parseInParallelAndCompare(s);
+}
+
+/*
+ * A declaration whose compound literals end in a \c } (after a \c ) ), which
+ * is guessed as the boundary of a region, is parsed as in a sequential parse:
+ * the regions it crosses are parsed again, sequentially.
+ */
+void TestSyntaxTree::case0054()
+{
+    std::string s;
+    for (auto i = 0U; s.size() < (1 << 19); ++i) {
+        auto n = std::to_string(i);
+        s += "int* p" + n + " = (int[]){ " + n + " }";
+        for (auto j = 0U; j < 8; ++j)
+            s += ", *q" + std::to_string(j) + " = (int[]){ " + n + " }";
+        s += ";\n";
+    }
+    parseInParallelAndCompare(s);
+}
+
+/*
+ * A slice of a text, which ends at a line start (not followed by a null
+ * character, as a chunk), is lexed as a copy of it is lexed, even where the
+ * slice ends within a comment, a string, or a continued line.
+ */
+void TestSyntaxTree::case0055()
+{
+    const auto text = SourceText(largeText(1 << 10));
+    const auto& lineStarts = text.lineStarts();
+    for (auto lineIdx = 1U; lineIdx < lineStarts.size(); ++lineIdx) {
+        const auto size = lineStarts[lineIdx];
+        std::unique_ptr<SyntaxTree> tree(new SyntaxTree(text.slice(0, size), ParseOptions(), ""));
+        tree->buildTree(SyntaxTree::SyntaxCategory::Unspecified);
+        auto refTree = SyntaxTree::parseText(std::string(text.c_str(), size), ParseOptions());
+        expectSameTokens(tree.get(), refTree.get());
+        PSYCHE_EXPECT_INT_EQ(refTree->diagnosticCount(), tree->diagnosticCount());
+    }
+}
+
+/*
+ * The lexeme of the \p constant, as decoded in an initializer.
+ */
+SyntaxLexeme* TestSyntaxTree::constantLexeme(const std::string& constant)
+{
+    constantTree_ = SyntaxTree::parseText("int x = " + constant + ";", ParseOptions());
+    PSYCHE_EXPECT_INT_EQ(0, constantTree_->diagnosticCount());
+
+    // The tokens are: the marker, `int', `x', `=', and the constant.
+    auto lexeme = constantTree_->tokens().lexemeAt(4);
+    PSYCHE_EXPECT_TRUE(lexeme != nullptr);
+    PSYCHE_EXPECT_STR_EQ(constant, lexeme->valueText());
+    return lexeme;
+}
+
+/*
+ * Decimal, hexadecimal, octal, and binary integer constants.
+ */
+void TestSyntaxTree::case0100()
+{
+    PSYCHE_EXPECT_INT_EQ(42, constantLexeme("42")->value<unsigned long long>());
+    PSYCHE_EXPECT_INT_EQ(0, constantLexeme("0")->value<unsigned long long>());
+    PSYCHE_EXPECT_INT_EQ(42, constantLexeme("0x2a")->value<unsigned long long>());
+    PSYCHE_EXPECT_INT_EQ(42, constantLexeme("0X2AUL")->value<unsigned long long>());
+    PSYCHE_EXPECT_INT_EQ(42, constantLexeme("052")->value<unsigned long long>());
+    PSYCHE_EXPECT_INT_EQ(42, constantLexeme("0b101010")->value<unsigned long long>());
+    PSYCHE_EXPECT_INT_EQ(42, constantLexeme("42ull")->value<unsigned long long>());
+    PSYCHE_EXPECT_INT_EQ(0xFFFFFFFFFFFFFFFFull,
+                         constantLexeme("0xFFFFFFFFFFFFFFFF")->value<unsigned long long>());
+
+    auto lexeme = constantLexeme("42lu")->asIntegerConstant();
+    PSYCHE_EXPECT_TRUE(lexeme != nullptr);
+    PSYCHE_EXPECT_TRUE(lexeme->signedness() == IntegerConstant::Signedness::Unsigned);
+    PSYCHE_EXPECT_TRUE(lexeme->variant() == IntegerConstant::Variant::Long);
+}
+
+/*
+ * An integer constant that doesn't fit in any integer type saturates.
+ */
+void TestSyntaxTree::case0101()
+{
+    PSYCHE_EXPECT_INT_EQ(0xFFFFFFFFFFFFFFFFull,
+                         constantLexeme("18446744073709551616")->value<unsigned long long>());
+    PSYCHE_EXPECT_INT_EQ(0xFFFFFFFFFFFFFFFFull,
+                         constantLexeme("0x10000000000000000")->value<unsigned long long>());
+}
+
+/*
+ * Decimal and hexadecimal floating constants, of every variant.
+ */
+void TestSyntaxTree::case0102()
+{
+    PSYCHE_EXPECT_INT_EQ(1.5, constantLexeme("1.5")->value<double>());
+    PSYCHE_EXPECT_INT_EQ(0.25f, constantLexeme(".25f")->value<float>());
+    PSYCHE_EXPECT_INT_EQ(1000.0L, constantLexeme("1e3L")->value<long double>());
+    PSYCHE_EXPECT_INT_EQ(16.0, constantLexeme("0x1p4")->value<double>());
+    PSYCHE_EXPECT_INT_EQ(3.0, constantLexeme("0x1.8p1")->value<double>());
+    PSYCHE_EXPECT_INT_EQ(0.5f, constantLexeme("0x.8p0f")->value<float>());
+    PSYCHE_EXPECT_INT_EQ(0.75L, constantLexeme("0X3P-2L")->value<long double>());
+
+    auto lexeme = constantLexeme("2.5F")->asFloatingConstant();
+    PSYCHE_EXPECT_TRUE(lexeme != nullptr);
+    PSYCHE_EXPECT_TRUE(lexeme->variant() == FloatingConstant::Variant::Float);
+    PSYCHE_EXPECT_INT_EQ(2.5f, lexeme->value<float>());
+}
+
+/*
+ * Character constants with simple, octal, hexadecimal, and universal escapes,
+ * and with UTF-8 characters.
+ */
+void TestSyntaxTree::case0103()
+{
+    auto charValue = [this] (const std::string& constant) {
+        return static_cast<unsigned long>(constantLexeme(constant)->value<char32_t>());
+    };
+
+    PSYCHE_EXPECT_INT_EQ(97, charValue("'a'"));
+    PSYCHE_EXPECT_INT_EQ(10, charValue("'\\n'"));
+    PSYCHE_EXPECT_INT_EQ(39, charValue("'\\''"));
+    PSYCHE_EXPECT_INT_EQ(92, charValue("'\\\\'"));
+    PSYCHE_EXPECT_INT_EQ(0, charValue("'\\0'"));
+    PSYCHE_EXPECT_INT_EQ(65, charValue("'\\101'"));
+    PSYCHE_EXPECT_INT_EQ(65, charValue("'\\x41'"));
+    PSYCHE_EXPECT_INT_EQ(27, charValue("'\\e'"));
+    PSYCHE_EXPECT_INT_EQ(0xE1, charValue("L'\\u00e1'"));
+    PSYCHE_EXPECT_INT_EQ(0x1F600, charValue("U'\\U0001F600'"));
+    PSYCHE_EXPECT_INT_EQ(0xE1, charValue("u'\xc3\xa1'"));
+}
+
+/*
+ * Multi-character constants: a plain one has its characters packed; any
+ * other one has the value of its last character.
+ */
+void TestSyntaxTree::case0104()
+{
+    PSYCHE_EXPECT_INT_EQ(0x6162, constantLexeme("'ab'")->value<int>());
+    PSYCHE_EXPECT_INT_EQ(0x61626364, constantLexeme("'abcd'")->value<int>());
+    PSYCHE_EXPECT_INT_EQ(0x610A, constantLexeme("'a\\n'")->value<int>());
+    PSYCHE_EXPECT_INT_EQ(98, constantLexeme("L'ab'")->value<int>());
+}
+
+std::string TestSyntaxTree::makeCacheDirectory()
+{
+    auto dir = std::filesystem::temp_directory_path() / ("psyche-token-cache-" + curTestName_);
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir.string();
+}
+
+std::string TestSyntaxTree::cacheFilePath(const std::string& cacheDir)
+{
+    for (const auto& entry : std::filesystem::directory_iterator(cacheDir)) {
+        if (entry.path().extension() == ".psytk")
+            return entry.path().string();
+    }
+    return "";
+}
+
+bool TestSyntaxTree::loadFromCache(const std::string& text, const ParseOptions& options)
+{
+    std::unique_ptr<SyntaxTree> tree(new SyntaxTree(SourceText(text), options, ""));
+    if (!TokenCache(tree.get()).load())
+        return false;
+
+    // Query every token position, as diagnostics would do.
+    std::vector<unsigned int> offsets;
+    for (auto tkIdx = 1U; tkIdx < tree->tokenCount(); ++tkIdx)
+        offsets.push_back(tree->tokens().byteOffsetAt(tkIdx));
+    PSYCHE_EXPECT_INT_EQ(offsets.size(), tree->linePositions(offsets).size());
+    return true;
+}
+
+namespace {
+
+const std::string kCachedText =
+        "int x; /* \xc3\xa1 */\n"
+        "# 10 \"a.h\"\n"
+        "void f(int a) {\n"
+        "    if (a) { x = a + 0x1f; }\n"
+        "    g(\"s\", 'c', 1.5);\n"
+        "}\n";
+
+} // anonymous
+
+/*
+ * A text is stored into the cache, and loaded from it as if it were lexed.
+ */
+void TestSyntaxTree::case0150()
+{
+    const auto cacheDir = makeCacheDirectory();
+    ParseOptions options;
+    options.setCommentMode(ParseOptions::CommentMode::KeepAll);
+    options.setTokenCacheDirectory(cacheDir);
+
+    auto storingTree = SyntaxTree::parseText(kCachedText, options);
+    PSYCHE_EXPECT_FALSE(cacheFilePath(cacheDir).empty());
+    PSYCHE_EXPECT_TRUE(loadFromCache(kCachedText, options));
+
+    auto tree = SyntaxTree::parseText(kCachedText, options);
+    options.setTokenCacheDirectory("");
+    auto refTree = SyntaxTree::parseText(kCachedText, options);
+    expectSameTokens(tree.get(), refTree.get());
+    expectSameTokens(storingTree.get(), refTree.get());
+    expectSameText(tree.get(), refTree.get());
+
+    std::filesystem::remove_all(cacheDir);
+}
+
+/*
+ * A truncated cache file isn't loaded.
+ */
+void TestSyntaxTree::case0151()
+{
+    const auto cacheDir = makeCacheDirectory();
+    ParseOptions options;
+    options.setTokenCacheDirectory(cacheDir);
+    SyntaxTree::parseText(kCachedText, options);
+
+    const auto path = cacheFilePath(cacheDir);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+    PSYCHE_EXPECT_FALSE(loadFromCache(kCachedText, options));
+
+    auto tree = SyntaxTree::parseText(kCachedText, options);
+    options.setTokenCacheDirectory("");
+    auto refTree = SyntaxTree::parseText(kCachedText, options);
+    expectSameTokens(tree.get(), refTree.get());
+
+    std::filesystem::remove_all(cacheDir);
+}
+
+/*
+ * A cache file corrupted anywhere (but with the right size and key) is either
+ * rejected or yields tokens within the text.
+ */
+void TestSyntaxTree::case0152()
+{
+    const auto cacheDir = makeCacheDirectory();
+    ParseOptions options;
+    options.setTokenCacheDirectory(cacheDir);
+    SyntaxTree::parseText(kCachedText, options);
+
+    const auto path = cacheFilePath(cacheDir);
+    std::string data;
+    {
+        std::ifstream ifs(path, std::ios::binary);
+        std::ostringstream oss;
+        oss << ifs.rdbuf();
+        data = oss.str();
+    }
+
+    int rejectedCnt = 0;
+    for (auto i = 0U; i < data.size(); ++i) {
+        auto corrupted = data;
+        corrupted[i] = corrupted[i] == '\xff' ? '\x7f' : '\xff';
+        {
+            std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+            ofs.write(corrupted.data(), corrupted.size());
+        }
+        if (!loadFromCache(kCachedText, options))
+            ++rejectedCnt;
+    }
+    PSYCHE_EXPECT_TRUE(rejectedCnt > 0);
+
+    std::filesystem::remove_all(cacheDir);
+}
+
+/*
+ * A cache file of another text (of the same size) isn't loaded.
+ */
+void TestSyntaxTree::case0153()
+{
+    const auto cacheDir = makeCacheDirectory();
+    ParseOptions options;
+    options.setTokenCacheDirectory(cacheDir);
+    SyntaxTree::parseText(std::string("int x;"), options);
+
+    const auto path = cacheFilePath(cacheDir);
+    const auto otherPath = cacheDir + "/"
+            + std::filesystem::path(path).filename().string() + ".other";
+    std::filesystem::rename(path, otherPath);
+    SyntaxTree::parseText(std::string("int y;"), options);
+    const auto pathOfOther = cacheFilePath(cacheDir);
+
+    // Give the file of the first text the name (key) of the second one's.
+    std::filesystem::remove(pathOfOther);
+    std::filesystem::rename(otherPath, pathOfOther);
+    PSYCHE_EXPECT_FALSE(loadFromCache("int y;", options));
+
+    std::filesystem::remove_all(cacheDir);
+}
+
+/*
+ * A cache file whose header has counts beyond the file's size (including ones
+ * that overflow 32 bits when multiplied by the size of an element) isn't loaded.
+ */
+void TestSyntaxTree::case0154()
+{
+    const auto cacheDir = makeCacheDirectory();
+    ParseOptions options;
+    options.setTokenCacheDirectory(cacheDir);
+    SyntaxTree::parseText(kCachedText, options);
+
+    const auto path = cacheFilePath(cacheDir);
+    std::string data;
+    {
+        std::ifstream ifs(path, std::ios::binary);
+        std::ostringstream oss;
+        oss << ifs.rdbuf();
+        data = oss.str();
+    }
+
+    // The offsets of the counts in the header: after the magic, the key, and
+    // the text's digest and size (8 bytes each), there are 6 counts of 4 bytes
+    // each: lexemes, tokens, comments, line directives, expansions, and lines.
+    const std::uint32_t crafted[] = { 0x55555556, 0xFFFFFFFF, 0x40000001 };
+    for (auto cntIdx = 0U; cntIdx < 6; ++cntIdx) {
+        for (auto cnt : crafted) {
+            auto corrupted = data;
+            std::memcpy(&corrupted[32 + 4 * cntIdx], &cnt, sizeof(cnt));
+            {
+                std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+                ofs.write(corrupted.data(), corrupted.size());
+            }
+            PSYCHE_EXPECT_FALSE(loadFromCache(kCachedText, options));
+        }
+    }
+
+    std::filesystem::remove_all(cacheDir);
+}
+
+void TestSyntaxTree::streamAndCompare(const std::string& text, ParseOptions options)
+{
+    std::ostringstream oss;
+    unsigned int declCnt = 0;
+    auto tree = SyntaxTree::streamText(text, options, "",
+                                       [&oss, &declCnt] (const DeclarationSyntax* decl) {
+        Unparser(const_cast<SyntaxTree*>(decl->syntaxTree())).unparse(decl, oss);
+        ++declCnt;
+    });
+
+    auto refTree = SyntaxTree::parseText(text, options);
+    auto unit = refTree->translationUnitRoot();
+    PSYCHE_EXPECT_TRUE(unit != nullptr);
+    unsigned int refDeclCnt = 0;
+    for (auto it = unit->declarations(); it; it = it->next)
+        ++refDeclCnt;
+    PSYCHE_EXPECT_INT_EQ(refDeclCnt, declCnt);
+
+    std::ostringstream refOss;
+    Unparser(refTree.get()).unparse(unit, refOss);
+    PSYCHE_EXPECT_STR_EQ(refOss.str(), oss.str());
+    PSYCHE_EXPECT_INT_EQ(refTree->diagnosticCount(), tree->diagnosticCount());
+}
+
+/*
+ * A few declarations, which fit in a single batch of streamed tokens.
+ */
+void TestSyntaxTree::case0200()
+{
+    streamAndCompare("int x;\n"
+                     "void f(int a) { x = a; }\n"
+                     "struct s { int m; } y;\n");
+}
+
+/*
+ * Declarations whose identifier role is determined by looking far ahead (past
+ * the usual lookahead), as they cross the edges of the batches of streamed
+ * tokens at every offset.
+ */
+void TestSyntaxTree::case0201()
+{
+    std::string s;
+    for (auto i = 0U; i < 3 * Lexer::kStreamedTkCnt; ++i) {
+        const std::string parens(1 + i % 40, '(');
+        s += "t" + parens + "v" + std::to_string(i)
+                + std::string(parens.size(), ')') + ";\n";
+        if (i % 3)
+            s += "int a" + std::to_string(i) + ";\n";
+    }
+    streamAndCompare(s);
+}
+
+/*
+ * A function body spans several batches of streamed tokens.
+ */
+void TestSyntaxTree::case0202()
+{
+    std::string s = "int x;\n"
+                    "void f(int a) {\n";
+    for (auto i = 0U; i < 2 * Lexer::kStreamedTkCnt; ++i)
+        s += "    if (a) { x = (a + " + std::to_string(i) + "); }\n";
+    s += "}\n"
+         "int y;\n";
+    streamAndCompare(s);
+}
+
+void TestSyntaxTree::expectSameLinePositions(const std::string& text, ParseOptions options)
+{
+    auto tree = SyntaxTree::parseText(text, options);
+
+    // Every offset that isn't within a UTF-8 sequence, plus the end of the text.
+    std::vector<unsigned int> offsets;
+    for (auto offset = 0U; offset <= text.size(); ++offset) {
+        if (offset == text.size() || (text[offset] & 0xC0) != 0x80)
+            offsets.push_back(offset);
+    }
+
+    auto positions = tree->linePositions(offsets);
+    PSYCHE_EXPECT_INT_EQ(offsets.size(), positions.size());
+    for (auto i = 0U; i < offsets.size(); ++i) {
+        auto refPosition = tree->computePosition(offsets[i]);
+        PSYCHE_EXPECT_INT_EQ(refPosition.line(), positions[i].line());
+        PSYCHE_EXPECT_INT_EQ(refPosition.character(), positions[i].character());
+    }
+}
+
+namespace {
+
+const std::string kLineDirectivesText =
+        "int a;\n"
+        "# 10 \"x.h\"\n"
+        "int b; int c;\n"
+        "\n"
+        "# line 20 \"y.h\"\n"
+        "int d;\n"
+        "# 30 \"x.h\"\n"
+        "int e;\n";
+
+const std::string kNonASCIIText =
+        "char* a = \"\xc3\xa7\xc3\xa3o\"; int b;\n"
+        "/* \xe2\x82\xac \xf0\x9f\x98\x80 */ int c; char* d = \"\xf0\x9f\x98\x80\";\n"
+        "# 5 \"x.h\"\n"
+        "char* e = \"\xc3\xa9\"; int f;\n";
+
+} // anonymous
+
+/*
+ * Line directives, of either spelling, rebase the line numbers.
+ */
+void TestSyntaxTree::case0250()
+{
+    expectSameLinePositions(kLineDirectivesText);
+
+    // The text's own directive, at offset 0, comes first.
+    auto tree = SyntaxTree::parseText(kLineDirectivesText);
+    PSYCHE_EXPECT_INT_EQ(4, tree->lineDirectives().size());
+}
+
+/*
+ * Non-ASCII text, with columns counted in bytes or in UTF-16 code units.
+ */
+void TestSyntaxTree::case0251()
+{
+    expectSameLinePositions(kNonASCIIText);
+
+    ParseOptions options;
+    options.trackUTF16Offsets(true);
+    expectSameLinePositions(kNonASCIIText, options);
+}
+
+/*
+ * Expanded tokens take the positions recorded in the expansion marks.
+ */
+void TestSyntaxTree::case0252()
+{
+    const std::string s = "int x, y, z;\n"
+                          "void f(void) {\n"
+                          "# expansion begin 30,3 ~2 3:7 ~1\n"
+                          "x = y + z;\n"
+                          "# expansion end\n"
+                          "# 40 \"x.h\"\n"
+                          "x = 1;\n"
+                          "}\n";
+    expectSameLinePositions(s);
+
+    auto tree = SyntaxTree::parseText(s);
+    PSYCHE_EXPECT_FALSE(tree->expansions().empty());
+}
+
+/*
+ * Non-ASCII text, with offsets tracked in bytes only: the character offset
+ * and size of a token are its byte ones, and columns are counted in bytes.
+ */
+void TestSyntaxTree::case0253()
+{
+    ParseOptions options;
+    options.trackUTF16Offsets(false);
+    auto tree = SyntaxTree::parseText(kNonASCIIText, options);
+    PSYCHE_EXPECT_INT_EQ(0, tree->diagnosticCount());
+
+    const auto& tokens = tree->tokens();
+    std::vector<unsigned int> offsets;
+    for (auto tkIdx = 1U; tkIdx < tokens.count(); ++tkIdx) {
+        PSYCHE_EXPECT_INT_EQ(tokens.byteOffsetAt(tkIdx), tokens.charOffsetAt(tkIdx));
+        PSYCHE_EXPECT_INT_EQ(tokens.byteSizeAt(tkIdx), tokens.charSizeAt(tkIdx));
+        offsets.push_back(tokens.byteOffsetAt(tkIdx));
+    }
+
+    auto positions = tree->linePositions(offsets);
+    for (auto i = 0U; i < offsets.size(); ++i) {
+        auto lineEnd = offsets[i] ? kNonASCIIText.rfind('\n', offsets[i] - 1) : std::string::npos;
+        unsigned int lineStart = lineEnd == std::string::npos ? 0 : lineEnd + 1;
+        // The first token of a line is positioned by the line lookup, which is
+        // independent of how offsets are tracked.
+        if (offsets[i] == lineStart)
+            continue;
+        PSYCHE_EXPECT_INT_EQ(int(offsets[i] - lineStart), positions[i].character());
+    }
+
+    // A token after a 3-byte and a 4-byte code point (one and two UTF-16 code
+    // units): its column in bytes is beyond that in UTF-16 code units.
+    const unsigned int offset = kNonASCIIText.find("int c;");
+    auto UTF16Tree = SyntaxTree::parseText(kNonASCIIText, ParseOptions());
+    auto byteColumn = tree->linePositions({ offset })[0].character();
+    auto UTF16Column = UTF16Tree->linePositions({ offset })[0].character();
+    PSYCHE_EXPECT_INT_EQ(int(offset - kNonASCIIText.find('\n') - 1), byteColumn);
+    PSYCHE_EXPECT_INT_EQ(byteColumn - 4, UTF16Column);
+}
+
+std::vector<std::string> TestSyntaxTree::diagnosticIds(const std::string& text, ParseOptions options)
+{
+    auto tree = SyntaxTree::parseText(text, options);
+    std::vector<std::string> ids;
+    for (const auto& diagnostic : tree->diagnostics())
+        ids.push_back(diagnostic.descriptor().id());
+    PSYCHE_EXPECT_INT_EQ(ids.size(), tree->diagnosticCount());
+    return ids;
+}
+
+namespace {
+
+// A warning, from the lexer, and an error, from the parser.
+const std::string kDiagnosticsText =
+        "double d = 0x1p4;\n"
+        "int x = ;\n";
+
+const std::string kWarningId = "Lexer-001";
+const std::string kErrorId = "Parser-200-6.5";
+
+} // anonymous
+
+/*
+ * By default, every diagnostic is reported.
+ */
+void TestSyntaxTree::case0300()
+{
+    ParseOptions options(LanguageDialect(LanguageDialect::Std::C89_90));
+    auto ids = diagnosticIds(kDiagnosticsText, options);
+    PSYCHE_EXPECT_INT_EQ(2, ids.size());
+    PSYCHE_EXPECT_STR_EQ(kWarningId, ids[0]);
+    PSYCHE_EXPECT_STR_EQ(kErrorId, ids[1]);
+}
+
+/*
+ * Diagnostics below the severity threshold aren't reported.
+ */
+void TestSyntaxTree::case0301()
+{
+    ParseOptions options(LanguageDialect(LanguageDialect::Std::C89_90));
+    options.setDiagnosticSeverityThreshold(DiagnosticSeverity::Error);
+    auto ids = diagnosticIds(kDiagnosticsText, options);
+    PSYCHE_EXPECT_INT_EQ(1, ids.size());
+    PSYCHE_EXPECT_STR_EQ(kErrorId, ids[0]);
+
+    options.setDiagnosticSeverityThreshold(DiagnosticSeverity::Warning);
+    ids = diagnosticIds(kDiagnosticsText, options);
+    PSYCHE_EXPECT_INT_EQ(2, ids.size());
+}
+
+/*
+ * Suppressed diagnostics aren't reported, whatever their severity.
+ */
+void TestSyntaxTree::case0302()
+{
+    ParseOptions options(LanguageDialect(LanguageDialect::Std::C89_90));
+    options.suppressDiagnostic(kErrorId);
+    auto ids = diagnosticIds(kDiagnosticsText, options);
+    PSYCHE_EXPECT_INT_EQ(1, ids.size());
+    PSYCHE_EXPECT_STR_EQ(kWarningId, ids[0]);
+
+    options.suppressDiagnostic(kWarningId);
+    ids = diagnosticIds(kDiagnosticsText, options);
+    PSYCHE_EXPECT_INT_EQ(0, ids.size());
+}
+
+/*
+ * Filtering diagnostics doesn't affect the tree.
+ */
+void TestSyntaxTree::case0303()
+{
+    ParseOptions refOptions(LanguageDialect(LanguageDialect::Std::C89_90));
+    auto refTree = SyntaxTree::parseText(kDiagnosticsText, refOptions);
+
+    ParseOptions options(LanguageDialect(LanguageDialect::Std::C89_90));
+    options.setDiagnosticSeverityThreshold(DiagnosticSeverity::Error);
+    options.suppressDiagnostic(kErrorId);
+    auto tree = SyntaxTree::parseText(kDiagnosticsText, options);
+    PSYCHE_EXPECT_INT_EQ(0, tree->diagnosticCount());
+
+    expectSameTokens(tree.get(), refTree.get());
+    expectSameText(tree.get(), refTree.get());
+}
+
+/*
+ * The diagnostics returned are a snapshot: diagnostics reported later (by the
+ * parse of a deferred body) don't affect them.
+ */
+void TestSyntaxTree::case0304()
+{
+    ParseOptions options;
+    options.deferFunctionBodies(true);
+    auto tree = SyntaxTree::parseText(std::string("int x = ;\n"
+                                                  "void f(void) { int y = ; }\n"),
+                                      options);
+    auto diagnostics = tree->diagnostics();
+    PSYCHE_EXPECT_INT_EQ(1, diagnostics.size());
+
+    auto funcDefs = functionDefinitions(tree.get());
+    PSYCHE_EXPECT_INT_EQ(1, funcDefs.size());
+    funcDefs[0]->body();
+    PSYCHE_EXPECT_INT_EQ(1, diagnostics.size());
+    PSYCHE_EXPECT_INT_EQ(2, tree->diagnosticCount());
+
+    auto allDiagnostics = tree->diagnostics();
+    PSYCHE_EXPECT_INT_EQ(2, allDiagnostics.size());
+    PSYCHE_EXPECT_TRUE(diagnostics[0].location() == allDiagnostics[0].location());
+    PSYCHE_EXPECT_STR_EQ(kErrorId, allDiagnostics[1].descriptor().id());
+}
+
+std::vector<const FunctionDefinitionSyntax*> TestSyntaxTree::functionDefinitions(const SyntaxTree* tree)
+{
+    std::vector<const FunctionDefinitionSyntax*> funcDefs;
+    for (auto it = tree->translationUnitRoot()->declarations(); it; it = it->next) {
+        if (it->value->kind() == FunctionDefinition)
+            funcDefs.push_back(static_cast<const FunctionDefinitionSyntax*>(it->value));
+    }
+    return funcDefs;
+}
+
+namespace {
+
+const std::string kFunctionsText =
+        "typedef int t;\n"
+        "int x;\n"
+        "void f(int a) { if (a) { x = a; } }\n"
+        "int g(t b) { t c = b; return c * x; }\n"
+        "struct s { int m; };\n"
+        "void h(void) { struct s v; v.m = g(1); f(v.m); }\n";
+
+struct NodeCounter : SyntaxVisitor
+{
+    using SyntaxVisitor::SyntaxVisitor;
+    bool preVisit(const SyntaxNode*) override { ++cnt_; return true; }
+    unsigned int cnt_ = 0;
+};
+
+} // anonymous
+
+/*
+ * A traversal visits deferred bodies, as if they had been parsed up front.
+ */
+void TestSyntaxTree::case0350()
+{
+    ParseOptions options;
+    options.deferFunctionBodies(true);
+    auto tree = SyntaxTree::parseText(kFunctionsText, options);
+    auto funcDefs = functionDefinitions(tree.get());
+    PSYCHE_EXPECT_INT_EQ(3, funcDefs.size());
+    for (auto funcDef : funcDefs)
+        PSYCHE_EXPECT_TRUE(funcDef->isBodyDeferred());
+
+    NodeCounter counter(tree.get());
+    counter.visit(tree->root());
+    for (auto funcDef : funcDefs)
+        PSYCHE_EXPECT_FALSE(funcDef->isBodyDeferred());
+
+    auto refTree = SyntaxTree::parseText(kFunctionsText, ParseOptions());
+    NodeCounter refCounter(refTree.get());
+    refCounter.visit(refTree->root());
+    PSYCHE_EXPECT_INT_EQ(refCounter.cnt_, counter.cnt_);
+}
+
+/*
+ * An unparse of deferred bodies is that of bodies parsed up front.
+ */
+void TestSyntaxTree::case0351()
+{
+    ParseOptions options;
+    options.deferFunctionBodies(true);
+    auto tree = SyntaxTree::parseText(kFunctionsText, options);
+    auto refTree = SyntaxTree::parseText(kFunctionsText, ParseOptions());
+    expectSameText(tree.get(), refTree.get());
+}
+
+/*
+ * A print of the names of deferred bodies is that of bodies parsed up front.
+ */
+void TestSyntaxTree::case0352()
+{
+    ParseOptions options;
+    options.deferFunctionBodies(true);
+    auto tree = SyntaxTree::parseText(kFunctionsText, options);
+    std::ostringstream oss;
+    SyntaxNamePrinter(tree.get()).print(tree->root(), SyntaxNamePrinter::Style::Decorated, oss);
+
+    auto refTree = SyntaxTree::parseText(kFunctionsText, ParseOptions());
+    std::ostringstream refOss;
+    SyntaxNamePrinter(refTree.get()).print(refTree->root(), SyntaxNamePrinter::Style::Decorated, refOss);
+    PSYCHE_EXPECT_STR_EQ(refOss.str(), oss.str());
+}
+
+/*
+ * The diagnostics of a deferred body are reported when it's parsed.
+ */
+void TestSyntaxTree::case0353()
+{
+    const std::string s = "int x;\n"
+                          "void f(int a) { x = a + ; }\n";
+    ParseOptions options;
+    options.deferFunctionBodies(true);
+    auto tree = SyntaxTree::parseText(s, options);
+    PSYCHE_EXPECT_INT_EQ(0, tree->diagnosticCount());
+
+    auto funcDefs = functionDefinitions(tree.get());
+    PSYCHE_EXPECT_INT_EQ(1, funcDefs.size());
+    PSYCHE_EXPECT_TRUE(funcDefs[0]->body() != nullptr);
+
+    auto refTree = SyntaxTree::parseText(s, ParseOptions());
+    PSYCHE_EXPECT_TRUE(refTree->diagnosticCount() > 0);
+    PSYCHE_EXPECT_INT_EQ(refTree->diagnosticCount(), tree->diagnosticCount());
+}
+
+/*
+ * A deferred body is parsed once: neither its node nor its diagnostics are
+ * produced again by later calls.
+ */
+void TestSyntaxTree::case0354()
+{
+    const std::string s = "void f(int a) { a = + ; }\n";
+    ParseOptions options;
+    options.deferFunctionBodies(true);
+    auto tree = SyntaxTree::parseText(s, options);
+    auto funcDefs = functionDefinitions(tree.get());
+    PSYCHE_EXPECT_INT_EQ(1, funcDefs.size());
+
+    auto body = funcDefs[0]->body();
+    auto diagnosticCnt = tree->diagnosticCount();
+    PSYCHE_EXPECT_TRUE(diagnosticCnt > 0);
+    for (int i = 0; i < 3; ++i) {
+        PSYCHE_EXPECT_TRUE(funcDefs[0]->body() == body);
+        funcDefs[0]->childNodesAndTokens();
+    }
+    PSYCHE_EXPECT_FALSE(funcDefs[0]->isBodyDeferred());
+    PSYCHE_EXPECT_INT_EQ(diagnosticCnt, tree->diagnosticCount());
+}
+
+/*
+ * Deferred bodies of a tree may be parsed by concurrent calls; each is
+ * parsed once, as if by a single call.
+ */
+void TestSyntaxTree::case0355()
+{
+    std::string s;
+    for (int i = 0; i < 64; ++i)
+        s += "int f" + std::to_string(i) + "(int a) { int b = a * " + std::to_string(i) + "; return b + ; }\n";
+
+    ParseOptions options;
+    options.deferFunctionBodies(true);
+    auto tree = SyntaxTree::parseText(s, options);
+    auto funcDefs = functionDefinitions(tree.get());
+    PSYCHE_EXPECT_INT_EQ(64, funcDefs.size());
+
+    constexpr int kThreadCnt = 4;
+    std::vector<std::vector<const StatementSyntax*>> bodies(kThreadCnt);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreadCnt; ++t) {
+        threads.emplace_back([&funcDefs, &bodies, t] () {
+            for (auto funcDef : funcDefs)
+                bodies[t].push_back(funcDef->body());
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    for (int t = 1; t < kThreadCnt; ++t)
+        PSYCHE_EXPECT_TRUE(bodies[t] == bodies[0]);
+
+    auto refTree = SyntaxTree::parseText(s, ParseOptions());
+    PSYCHE_EXPECT_INT_EQ(refTree->diagnosticCount(), tree->diagnosticCount());
+    expectSameText(tree.get(), refTree.get());
+}
+
+namespace {
+
+struct KindCollector : SyntaxVisitor
+{
+    using SyntaxVisitor::SyntaxVisitor;
+    bool preVisit(const SyntaxNode* node) override { kinds_.push_back(node->kind()); return true; }
+    std::vector<SyntaxKind> kinds_;
+};
+
+} // anonymous
+
+std::vector<SyntaxKind> TestSyntaxTree::parseWithTypedefNamesTracked(const std::string& text,
+                                                                     bool deferBodies)
+{
+    ParseOptions options;
+    options.trackTypedefNames(true);
+    options.deferFunctionBodies(deferBodies);
+    auto tree = SyntaxTree::parseText(text, options);
+    PSYCHE_EXPECT_INT_EQ(0, tree->diagnosticCount());
+
+    KindCollector collector(tree.get());
+    collector.visit(tree->root());
+    return collector.kinds_;
+}
+
+void TestSyntaxTree::expectKinds(const std::vector<SyntaxKind>& kinds,
+                                 const std::vector<SyntaxKind>& expected,
+                                 const std::vector<SyntaxKind>& unexpected)
+{
+    for (auto k : expected)
+        PSYCHE_EXPECT_TRUE(std::find(kinds.begin(), kinds.end(), k) != kinds.end());
+    for (auto k : unexpected)
+        PSYCHE_EXPECT_TRUE(std::find(kinds.begin(), kinds.end(), k) == kinds.end());
+}
+
+/*
+ * The operand of `sizeof' is a typedef-name: it's a type-name.
+ */
+void TestSyntaxTree::case0400()
+{
+    auto kinds = parseWithTypedefNamesTracked("typedef int t;\n"
+                                              "int x = sizeof (t);\n");
+    expectKinds(kinds,
+                { SizeofExpression, TypeNameAsTypeReference },
+                { ExpressionAsTypeReference, AmbiguousTypeNameOrExpressionAsTypeReference });
+}
+
+/*
+ * The operand of `sizeof' is a variable: it's an expression.
+ */
+void TestSyntaxTree::case0401()
+{
+    auto kinds = parseWithTypedefNamesTracked("int t;\n"
+                                              "int x = sizeof (t);\n");
+    expectKinds(kinds,
+                { SizeofExpression, ExpressionAsTypeReference },
+                { TypeNameAsTypeReference, AmbiguousTypeNameOrExpressionAsTypeReference });
+}
+
+/*
+ * The operand of `_Alignof' is a typedef-name: it's a type-name.
+ */
+void TestSyntaxTree::case0402()
+{
+    auto kinds = parseWithTypedefNamesTracked("typedef int t;\n"
+                                              "int x = _Alignof (t);\n");
+    expectKinds(kinds,
+                { AlignofExpression, TypeNameAsTypeReference },
+                { ExpressionAsTypeReference, AmbiguousTypeNameOrExpressionAsTypeReference });
+}
+
+/*
+ * The operand of `sizeof' is a compound literal of a typedef-name: it's an
+ * expression.
+ */
+void TestSyntaxTree::case0403()
+{
+    auto kinds = parseWithTypedefNamesTracked("typedef int t;\n"
+                                              "int x = sizeof (t){ 1 };\n");
+    expectKinds(kinds,
+                { SizeofExpression, ExpressionAsTypeReference, CompoundLiteralExpression },
+                { TypeNameAsTypeReference, AmbiguousTypeNameOrExpressionAsTypeReference });
+}
+
+/*
+ * A parenthesized typedef-name followed by an operand is a cast.
+ */
+void TestSyntaxTree::case0404()
+{
+    auto kinds = parseWithTypedefNamesTracked("typedef int t;\n"
+                                              "void f(int y) { int x = (t) - y; }\n");
+    expectKinds(kinds,
+                { CastExpression },
+                { AmbiguousCastOrBinaryExpression });
+}
+
+/*
+ * A parenthesized variable followed by an operand is a binary expression.
+ */
+void TestSyntaxTree::case0405()
+{
+    auto kinds = parseWithTypedefNamesTracked("int t;\n"
+                                              "void f(int y) { int x = (t) - y; }\n");
+    expectKinds(kinds,
+                { SubstractExpression },
+                { CastExpression, AmbiguousCastOrBinaryExpression });
+}
+
+/*
+ * A statement `a * b;' is an expression, or a declaration, by the role of `a'.
+ */
+void TestSyntaxTree::case0406()
+{
+    auto kinds = parseWithTypedefNamesTracked("int a;\n"
+                                              "void f(int b) { a * b; }\n");
+    expectKinds(kinds,
+                { ExpressionStatement, MultiplyExpression },
+                { DeclarationStatement, AmbiguousMultiplicationOrPointerDeclaration });
+
+    kinds = parseWithTypedefNamesTracked("typedef int a;\n"
+                                         "void f(void) { a * b; }\n");
+    expectKinds(kinds,
+                { DeclarationStatement },
+                { ExpressionStatement, AmbiguousMultiplicationOrPointerDeclaration });
+}
+
+/*
+ * A deferred body sees only the names of the file scope declared before it,
+ * as a body parsed up front does.
+ */
+void TestSyntaxTree::case0407()
+{
+    const std::string s = "void f(void) { a * b; }\n"
+                          "typedef int a;\n"
+                          "void g(void) { a * b; }\n";
+    auto kinds = parseWithTypedefNamesTracked(s, true);
+    auto refKinds = parseWithTypedefNamesTracked(s);
+    PSYCHE_EXPECT_TRUE(kinds == refKinds);
+    expectKinds(kinds,
+                { AmbiguousMultiplicationOrPointerDeclaration, DeclarationStatement },
+                {});
+}
+
+/*
+ * A variable of a block hides a typedef-name of the file scope: `T * x;' is
+ * an expression.
+ */
+void TestSyntaxTree::case0408()
+{
+    auto kinds = parseWithTypedefNamesTracked("typedef int T;\n"
+                                              "void f(void) { int T; T * x; }\n");
+    expectKinds(kinds,
+                { ExpressionStatement, MultiplyExpression },
+                { PointerDeclarator, AmbiguousMultiplicationOrPointerDeclaration });
+}
+
+/*
+ * A typedef-name of a block isn't visible once the block is closed: `T * x;'
+ * isn't taken as a declaration, but (as with an undeclared name) guessed.
+ */
+void TestSyntaxTree::case0409()
+{
+    auto kinds = parseWithTypedefNamesTracked("void f(void) { { typedef int T; } T * x; }\n");
+    expectKinds(kinds,
+                { AmbiguousMultiplicationOrPointerDeclaration },
+                {});
+
+    kinds = parseWithTypedefNamesTracked("void f(void) { { typedef int T; T * x; } }\n");
+    expectKinds(kinds,
+                { PointerDeclarator },
+                { AmbiguousMultiplicationOrPointerDeclaration });
+}
+
+namespace {
+
+/*
+ * The kernels, other than the scalar ones, that are available, and the ones
+ * to which the scans dispatch: all of them are compared to the scalar ones.
+ */
+std::vector<TextScanner::Kernels> kernelsUnderTest()
+{
+    std::vector<TextScanner::Kernels> kernels;
+    for (auto set : { TextScanner::InstructionSet::SSE2, TextScanner::InstructionSet::AVX2 }) {
+        if (auto k = TextScanner::kernels(set))
+            kernels.push_back(*k);
+    }
+    kernels.push_back({ TextScanner::skipHorizontalWhitespace,
+                        TextScanner::findAnyOf,
+                        TextScanner::findAnyOfCountingUTF16,
+                        TextScanner::skipIdentifierCharacters });
+    return kernels;
+}
+
+/*
+ * Texts of every length up to a few blocks (of 32 bytes), made of the bytes of
+ * \p filler, in which a byte of \p breakers is placed at every position (or at
+ * none); what follows the end of a text is a breaker, which mustn't be read.
+ */
+template <class ScanT>
+void forEachText(const std::string& filler, const std::string& breakers, ScanT scan)
+{
+    constexpr unsigned int kMaxSize = 3 * 32 + 1;
+    for (auto size = 0U; size <= kMaxSize; ++size) {
+        for (auto breakIdx = 0U; breakIdx <= size; ++breakIdx) {
+            for (auto breaker : breakers) {
+                std::string text;
+                for (auto i = 0U; i < size; ++i)
+                    text += filler[i % filler.size()];
+                if (breakIdx < size)
+                    text[breakIdx] = breaker;
+                text += breaker;
+                scan(text.c_str(), text.c_str() + size);
+            }
+        }
+    }
+}
+
+} // anonymous
+
+/*
+ * The whitespace skip of the SIMD kernels is that of the scalar kernel.
+ */
+void TestSyntaxTree::case0450()
+{
+    const auto scalar = TextScanner::kernels(TextScanner::InstructionSet::Scalar);
+    PSYCHE_EXPECT_TRUE(scalar != nullptr);
+
+    for (const auto& kernels : kernelsUnderTest()) {
+        forEachText(std::string(" \t\v\f\r"),
+                    std::string("\n\0a\x08\x0E\x1F\x80\xC3\xFF", 9),
+                    [&] (const char* beg, const char* end) {
+            PSYCHE_EXPECT_INT_EQ(scalar->skipHorizontalWhitespace_(beg, end) - beg,
+                                 kernels.skipHorizontalWhitespace_(beg, end) - beg);
+        });
+    }
+}
+
+/*
+ * The search of the SIMD kernels, which stops at a null byte and at a byte of
+ * a multi-byte code point, is that of the scalar kernel.
+ */
+void TestSyntaxTree::case0451()
+{
+    const auto scalar = TextScanner::kernels(TextScanner::InstructionSet::Scalar);
+
+    for (const auto& kernels : kernelsUnderTest()) {
+        forEachText(std::string("ab9 ;*/'\t"),
+                    std::string("\"\\\n\0\x7F\x80\xBF\xC3\xF0\xFF", 10),
+                    [&] (const char* beg, const char* end) {
+            PSYCHE_EXPECT_INT_EQ(scalar->findAnyOf_(beg, end, '"', '\\', '\n') - beg,
+                                 kernels.findAnyOf_(beg, end, '"', '\\', '\n') - beg);
+        });
+    }
+}
+
+/*
+ * The search of the SIMD kernels that counts UTF-16 code units, through 2-,
+ * 3-, and 4-byte code points (a surrogate pair), is that of the scalar kernel.
+ */
+void TestSyntaxTree::case0452()
+{
+    const auto scalar = TextScanner::kernels(TextScanner::InstructionSet::Scalar);
+
+    const std::vector<std::string> codePoints = {
+        "a", "\xC3\xA1", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\x7F", "\xDF\xBF", "\xF4\x8F\xBF\xBF"
+    };
+    const std::string breakers("\"\\\n\0", 4);
+
+    for (const auto& kernels : kernelsUnderTest()) {
+        for (auto shift = 0U; shift < codePoints.size(); ++shift) {
+            for (auto cpCnt = 0U; cpCnt <= 40; ++cpCnt) {
+                for (auto breakIdx = 0U; breakIdx <= cpCnt; ++breakIdx) {
+                    for (auto breaker : breakers) {
+                        std::string text;
+                        for (auto i = 0U; i < cpCnt; ++i)
+                            text += i == breakIdx ? std::string(1, breaker)
+                                                  : codePoints[(i * 3 + shift) % codePoints.size()];
+                        const auto size = text.size();
+                        text += codePoints[3] + breaker;
+
+                        const char* beg = text.c_str();
+                        const char* end = beg + size;
+                        unsigned int scalarUnits = 7;
+                        unsigned int units = 7;
+                        PSYCHE_EXPECT_INT_EQ(scalar->findAnyOfCountingUTF16_(beg, end, '"', '\\', '\n', scalarUnits) - beg,
+                                             kernels.findAnyOfCountingUTF16_(beg, end, '"', '\\', '\n', units) - beg);
+                        PSYCHE_EXPECT_INT_EQ(scalarUnits, units);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/*
+ * The identifier skip of the SIMD kernels is that of the scalar kernel.
+ */
+void TestSyntaxTree::case0453()
+{
+    const auto scalar = TextScanner::kernels(TextScanner::InstructionSet::Scalar);
+
+    for (const auto& kernels : kernelsUnderTest()) {
+        forEachText(std::string("aZ_$09zAm"),
+                    std::string(" @[`{/:\0\x80\xC3\xFF", 11),
+                    [&] (const char* beg, const char* end) {
+            PSYCHE_EXPECT_INT_EQ(scalar->skipIdentifierCharacters_(beg, end) - beg,
+                                 kernels.skipIdentifierCharacters_(beg, end) - beg);
+        });
+    }
+}
+
+std::vector<const Identifier*> TestSyntaxTree::identifiersOf(const SyntaxTree* tree,
+                                                             const std::string& spelling)
+{
+    std::vector<const Identifier*> idents;
+    for (auto tkIdx = 1U; tkIdx < tree->tokenCount(); ++tkIdx) {
+        SyntaxLexeme* lexeme = tree->tokenAt(tkIdx).valueLexeme();
+        if (lexeme && lexeme->asIdentifier() && lexeme->valueText() == spelling)
+            idents.push_back(lexeme->asIdentifier());
+    }
+    return idents;
+}
+
+/*
+ * The trees of a compilation, parsed with its interner, share their lexemes.
+ */
+void TestSyntaxTree::case0500()
+{
+    auto compilation = Compilation::create("interned");
+    ParseOptions options;
+    options.setLexemeInterner(compilation->lexemeInterner());
+    auto tree1 = SyntaxTree::parseText(std::string("int x = 1; int y;\n"), options);
+    auto tree2 = SyntaxTree::parseText(std::string("double y; int x = 2;\n"), options);
+
+    auto xs = identifiersOf(tree1.get(), "x");
+    auto otherXs = identifiersOf(tree2.get(), "x");
+    PSYCHE_EXPECT_INT_EQ(1, xs.size());
+    PSYCHE_EXPECT_INT_EQ(1, otherXs.size());
+    PSYCHE_EXPECT_TRUE(xs[0] == otherXs[0]);
+    PSYCHE_EXPECT_TRUE(identifiersOf(tree1.get(), "y")[0] == identifiersOf(tree2.get(), "y")[0]);
+    PSYCHE_EXPECT_FALSE(xs[0] == identifiersOf(tree2.get(), "y")[0]);
+    PSYCHE_EXPECT_INT_EQ(2, compilation->lexemeInterner()->identifierCount());
+
+    // Without the interner, each tree has its own lexemes.
+    auto tree3 = SyntaxTree::parseText(std::string("int x;\n"));
+    PSYCHE_EXPECT_FALSE(xs[0] == identifiersOf(tree3.get(), "x")[0]);
+}
+
+/*
+ * Elements inserted into, and looked up in, a concurrent table from many
+ * threads at once are unique.
+ */
+void TestSyntaxTree::case0501()
+{
+    const unsigned int kThreadCnt = 8;
+    const unsigned int kElemCnt = 2000;
+    std::vector<std::string> spellings;
+    for (auto i = 0U; i < kElemCnt; ++i)
+        spellings.push_back("ident" + std::to_string(i));
+
+    ConcurrentTextElementTable<Identifier> table;
+    std::vector<std::vector<const Identifier*>> found(kThreadCnt);
+    std::vector<std::thread> workers;
+    for (auto t = 0U; t < kThreadCnt; ++t) {
+        workers.emplace_back([&, t] () {
+            // Each thread walks the spellings from a different start, so that
+            // the same element is raced for by different threads.
+            found[t].resize(kElemCnt);
+            for (auto j = 0U; j < kElemCnt; ++j) {
+                auto i = (j + t * kElemCnt / kThreadCnt) % kElemCnt;
+                const auto& spelling = spellings[i];
+                found[t][i] = table.findOrInsert(spelling.c_str(), spelling.size());
+                table.find(spelling.c_str(), spelling.size());
+            }
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+
+    PSYCHE_EXPECT_INT_EQ(kElemCnt, table.size());
+    for (auto i = 0U; i < kElemCnt; ++i) {
+        const auto& spelling = spellings[i];
+        const Identifier* ident = table.find(spelling.c_str(), spelling.size());
+        PSYCHE_EXPECT_TRUE(ident != nullptr);
+        PSYCHE_EXPECT_STR_EQ(spelling, ident->valueText());
+        for (auto t = 0U; t < kThreadCnt; ++t)
+            PSYCHE_EXPECT_TRUE(found[t][i] == ident);
+    }
+    PSYCHE_EXPECT_TRUE(table.find("ident", 5) == nullptr);
+}
+
+/*
+ * Trees of a compilation that are parsed concurrently share their lexemes.
+ */
+void TestSyntaxTree::case0502()
+{
+    auto compilation = Compilation::create("interned");
+    ParseOptions options;
+    options.setLexemeInterner(compilation->lexemeInterner());
+
+    std::string s;
+    for (auto i = 0U; i < 200; ++i)
+        s += "int x" + std::to_string(i) + " = " + std::to_string(i) + ";\n";
+
+    const unsigned int kThreadCnt = 4;
+    std::vector<std::unique_ptr<SyntaxTree>> trees(kThreadCnt);
+    std::vector<std::thread> workers;
+    for (auto t = 0U; t < kThreadCnt; ++t) {
+        workers.emplace_back([&, t] () {
+            trees[t] = SyntaxTree::parseText(s, options);
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+
+    PSYCHE_EXPECT_INT_EQ(200, compilation->lexemeInterner()->identifierCount());
+    for (auto i = 0U; i < 200; i += 50) {
+        auto ident = "x" + std::to_string(i);
+        auto lexemes = identifiersOf(trees[0].get(), ident);
+        PSYCHE_EXPECT_INT_EQ(1, lexemes.size());
+        for (auto t = 1U; t < kThreadCnt; ++t)
+            PSYCHE_EXPECT_TRUE(identifiersOf(trees[t].get(), ident)[0] == lexemes[0]);
+    }
+}
+
+/*
+ * The allocations of a pool that are rolled back are reused, within a block
+ * and across blocks, without more blocks being reserved.
+ */
+void TestSyntaxTree::case0550()
+{
+    MemoryPool pool;
+    auto start = pool.mark();
+    void* first = pool.allocate(24);
+    pool.rollback(start);
+    PSYCHE_EXPECT_TRUE(pool.allocate(24) == first);
+
+    auto mark = pool.mark();
+    void* next = pool.allocate(16);
+    for (auto i = 0U; i < 4096; ++i)
+        pool.allocate(64);
+    auto peakBytes = pool.reservedBytes();
+    PSYCHE_EXPECT_TRUE(peakBytes > 8 * 1024);
+
+    pool.rollback(mark);
+    PSYCHE_EXPECT_TRUE(pool.allocate(16) == next);
+    for (auto i = 0U; i < 4096; ++i)
+        pool.allocate(64);
+    PSYCHE_EXPECT_INT_EQ(peakBytes, pool.reservedBytes());
+
+    // Memory allocated before the mark is kept.
+    std::memset(first, 0x5a, 24);
+    pool.rollback(mark);
+    std::memset(pool.allocate(4096), 0, 4096);
+    PSYCHE_EXPECT_INT_EQ(0x5a, static_cast<unsigned char*>(first)[23]);
+}
+
+/*
+ * The nodes of a statement that is parsed as an expression, and then (upon a
+ * backtrack) as a declaration, are released: the tree, and the memory that
+ * holds it, are as those of a parse in which the statement is known to be a
+ * declaration upfront.
+ */
+void TestSyntaxTree::case0551()
+{
+    std::string s = "typedef int t;\n";
+    for (auto i = 0U; i < 100; ++i) {
+        s += "void f" + std::to_string(i) + "(void) {\n"
+             "    t (*p)[1 + 2 + 3 + 4 + 5 + 6 + 7 + 8 + 9 + 10 + 11 + 12] = { 0 };\n"
+             "    t (*q)[(1 * 2) - (3 / 4) + (5 % 6) - (7 << 8)] = { 0 };\n"
+             "}\n";
+    }
+
+    auto tree = SyntaxTree::parseText(s);
+    PSYCHE_EXPECT_INT_EQ(0, tree->diagnosticCount());
+    std::ostringstream oss;
+    SyntaxNamePrinter(tree.get()).print(tree->root(), SyntaxNamePrinter::Style::Decorated, oss);
+
+    ParseOptions options;
+    options.trackTypedefNames(true);
+    auto refTree = SyntaxTree::parseText(s, options);
+    std::ostringstream refOss;
+    SyntaxNamePrinter(refTree.get()).print(refTree->root(), SyntaxNamePrinter::Style::Decorated, refOss);
+    PSYCHE_EXPECT_STR_EQ(refOss.str(), oss.str());
+
+    PSYCHE_EXPECT_INT_EQ(refTree->unitPoolBytes(), tree->unitPoolBytes());
+}
@@ -0,0 +1,247 @@
+// Copyright (c) 2020/21 Leandro T. C. Melo <ltcmelo@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PSYCHE_C_TEST_SYNTAX_TREE_H__
+#define PSYCHE_C_TEST_SYNTAX_TREE_H__
+
+#include "TestFrontend.h"
+
+#include <memory>
+
+#define TEST_SYNTAX_TREE(Function) TestFunction { &TestSyntaxTree::Function, #Function }
+
+namespace psy {
+namespace C {
+
+class TestSyntaxTree final : public TestFrontend
+{
+public:
+    void testAll() override;
+
+    /*
+        + 0000-0049 -> incremental relex (text changes)
+        + 0050-0099 -> parallel lexing and parsing
+        + 0100-0149 -> decoding of constants
+        + 0150-0199 -> token cache
+        + 0200-0249 -> streaming
+        + 0250-0299 -> line positions
+        + 0300-0349 -> diagnostics filter
+        + 0350-0399 -> deferred function bodies
+        + 0400-0449 -> typedef-name tracking
+        + 0450-0499 -> text scanning kernels
+     */
+
+    void case0001();
+    void case0002();
+    void case0003();
+    void case0004();
+    void case0005();
+    void case0006();
+    void case0007();
+    void case0008();
+    void case0009();
+    void case0010();
+
+    void case0050();
+    void case0051();
+    void case0052();
+    void case0053();
+    void case0054();
+    void case0055();
+
+    void case0100();
+    void case0101();
+    void case0102();
+    void case0103();
+    void case0104();
+
+    void case0150();
+    void case0151();
+    void case0152();
+    void case0153();
+    void case0154();
+
+    void case0200();
+    void case0201();
+    void case0202();
+
+    void case0250();
+    void case0251();
+    void case0252();
+    void case0253();
+
+    void case0300();
+    void case0301();
+    void case0302();
+    void case0303();
+    void case0304();
+
+    void case0350();
+    void case0351();
+    void case0352();
+    void case0353();
+    void case0354();
+    void case0355();
+
+    void case0400();
+    void case0401();
+    void case0402();
+    void case0403();
+    void case0404();
+    void case0405();
+    void case0406();
+    void case0407();
+    void case0408();
+    void case0409();
+
+    void case0450();
+    void case0451();
+    void case0452();
+    void case0453();
+
+    void case0500();
+    void case0501();
+    void case0502();
+
+    void case0550();
+    void case0551();
+
+private:
+    using TestFunction = std::pair<std::function<void(TestSyntaxTree*)>, const char*>;
+
+    void setUp() override;
+    void tearDown() override;
+
+    void expectSameTokens(const SyntaxTree* tree, const SyntaxTree* refTree);
+    void expectSameText(const SyntaxTree* tree, const SyntaxTree* refTree);
+
+    void relexAndCompare(const std::string& text,
+                         unsigned int spanStart,
+                         unsigned int spanEnd,
+                         const std::string& newText,
+                         ParseOptions options = ParseOptions());
+
+    void parseInParallelAndCompare(const std::string& text);
+
+    SyntaxLexeme* constantLexeme(const std::string& constant);
+    std::unique_ptr<SyntaxTree> constantTree_;
+
+    std::string makeCacheDirectory();
+    std::string cacheFilePath(const std::string& cacheDir);
+    bool loadFromCache(const std::string& text, const ParseOptions& options);
+
+    void streamAndCompare(const std::string& text, ParseOptions options = ParseOptions());
+
+    void expectSameLinePositions(const std::string& text, ParseOptions options = ParseOptions());
+
+    std::vector<std::string> diagnosticIds(const std::string& text, ParseOptions options);
+    std::vector<const Identifier*> identifiersOf(const SyntaxTree* tree, const std::string& spelling);
+
+    std::vector<const FunctionDefinitionSyntax*> functionDefinitions(const SyntaxTree* tree);
+
+    std::vector<SyntaxKind> parseWithTypedefNamesTracked(const std::string& text,
+                                                         bool deferBodies = false);
+    void expectKinds(const std::vector<SyntaxKind>& kinds,
+                     const std::vector<SyntaxKind>& expected,
+                     const std::vector<SyntaxKind>& unexpected);
+
+    std::vector<TestFunction> tests_
+    {
+        TEST_SYNTAX_TREE(case0001),
+        TEST_SYNTAX_TREE(case0002),
+        TEST_SYNTAX_TREE(case0003),
+        TEST_SYNTAX_TREE(case0004),
+        TEST_SYNTAX_TREE(case0005),
+        TEST_SYNTAX_TREE(case0006),
+        TEST_SYNTAX_TREE(case0007),
+        TEST_SYNTAX_TREE(case0008),
+        TEST_SYNTAX_TREE(case0009),
+        TEST_SYNTAX_TREE(case0010),
+
+        TEST_SYNTAX_TREE(case0050),
+        TEST_SYNTAX_TREE(case0051),
+        TEST_SYNTAX_TREE(case0052),
+        TEST_SYNTAX_TREE(case0053),
+        TEST_SYNTAX_TREE(case0054),
+        TEST_SYNTAX_TREE(case0055),
+
+        TEST_SYNTAX_TREE(case0100),
+        TEST_SYNTAX_TREE(case0101),
+        TEST_SYNTAX_TREE(case0102),
+        TEST_SYNTAX_TREE(case0103),
+        TEST_SYNTAX_TREE(case0104),
+
+        TEST_SYNTAX_TREE(case0150),
+        TEST_SYNTAX_TREE(case0151),
+        TEST_SYNTAX_TREE(case0152),
+        TEST_SYNTAX_TREE(case0153),
+        TEST_SYNTAX_TREE(case0154),
+
+        TEST_SYNTAX_TREE(case0200),
+        TEST_SYNTAX_TREE(case0201),
+        TEST_SYNTAX_TREE(case0202),
+
+        TEST_SYNTAX_TREE(case0250),
+        TEST_SYNTAX_TREE(case0251),
+        TEST_SYNTAX_TREE(case0252),
+        TEST_SYNTAX_TREE(case0253),
+
+        TEST_SYNTAX_TREE(case0300),
+        TEST_SYNTAX_TREE(case0301),
+        TEST_SYNTAX_TREE(case0302),
+        TEST_SYNTAX_TREE(case0303),
+        TEST_SYNTAX_TREE(case0304),
+
+        TEST_SYNTAX_TREE(case0350),
+        TEST_SYNTAX_TREE(case0351),
+        TEST_SYNTAX_TREE(case0352),
+        TEST_SYNTAX_TREE(case0353),
+        TEST_SYNTAX_TREE(case0354),
+        TEST_SYNTAX_TREE(case0355),
+
+        TEST_SYNTAX_TREE(case0400),
+        TEST_SYNTAX_TREE(case0401),
+        TEST_SYNTAX_TREE(case0402),
+        TEST_SYNTAX_TREE(case0403),
+        TEST_SYNTAX_TREE(case0404),
+        TEST_SYNTAX_TREE(case0405),
+        TEST_SYNTAX_TREE(case0406),
+        TEST_SYNTAX_TREE(case0407),
+        TEST_SYNTAX_TREE(case0408),
+        TEST_SYNTAX_TREE(case0409),
+
+        TEST_SYNTAX_TREE(case0450),
+        TEST_SYNTAX_TREE(case0451),
+        TEST_SYNTAX_TREE(case0452),
+        TEST_SYNTAX_TREE(case0453),
+
+        TEST_SYNTAX_TREE(case0500),
+        TEST_SYNTAX_TREE(case0501),
+        TEST_SYNTAX_TREE(case0502),
+
+        TEST_SYNTAX_TREE(case0550),
+        TEST_SYNTAX_TREE(case0551)
+    };
+};
+
+} // C
+} // psy
+
+#endif
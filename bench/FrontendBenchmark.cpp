@@ -0,0 +1,495 @@
+// Copyright (c) 2020/21 Leandro T. C. Melo <ltcmelo@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+/*
+ * Throughput benchmark of the frontend: lexing, parsing, traversal, and dump
+ * of syntax trees, over the preprocessed files of the test data and/or over
+ * synthetic sources. For each input and phase, the best of a number of runs
+ * is reported, in MB/s, tokens/s, and nodes/s; together with the bytes that
+ * the syntax tree's memory pool reserved.
+ *
+ *     psychec-bench [options] [file.i ...]
+ *
+ *     --data DIR             the directory of the .i files (by default, that
+ *                            of the test data); "" for none
+ *     --synthetic SHAPE:SIZE a synthetic input, e.g., funcs:4M; the shapes are
+ *                            decls, structs, funcs, exprs, nested, and
+ *                            keywords
+ *     --repeat N             the runs per phase (default: 5)
+ *     --defer-bodies         defer the parse of function bodies
+ *     --parse-threads N      the threads with which to parse (default: 1)
+ *     --track-typedefs       track the typedef-names declared during the parse
+ *     --format text|csv      the output format (default: text)
+ *     --output FILE          write the output into FILE
+ *     --baseline FILE        compare against a (csv) output saved earlier and
+ *                            fail if any phase is slower beyond the tolerance
+ *     --tolerance PERCENT    the tolerated slowdown (default: 10)
+ */
+
+#include "SyntheticSources.h"
+
+#include "SyntaxTree.h"
+#include "SyntaxTreeInternals.h"
+#include "parser/ParseOptions.h"
+#include "syntax/SyntaxNamePrinter.h"
+#include "syntax/SyntaxVisitor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef PSYCHE_BENCH_DATA_DIR
+#define PSYCHE_BENCH_DATA_DIR "tests/data"
+#endif
+
+namespace psy {
+namespace C {
+
+/**
+ * \brief The FrontendBenchmark class.
+ *
+ * Measures the phases of the frontend, separately, over a given input.
+ */
+class FrontendBenchmark
+{
+public:
+    FrontendBenchmark(ParseOptions options, unsigned int repeat)
+        : options_(std::move(options))
+        , repeat_(std::max(repeat, 1U))
+    {}
+
+    struct Input
+    {
+        std::string name_;
+        std::string text_;
+    };
+
+    struct Measurement
+    {
+        std::string input_;
+        std::string phase_;
+        std::size_t bytes_;
+        std::size_t tokens_;
+        std::size_t nodes_;
+        std::size_t poolBytes_;
+        double seconds_;
+    };
+
+    std::vector<Measurement> run(const Input& input) const;
+
+private:
+    template <class PrepareT, class MeasureT>
+    double bestOf(PrepareT prepare, MeasureT measure) const;
+
+    std::unique_ptr<SyntaxTree> newTree(const Input& input) const
+    {
+        return SyntaxTreeInternals::newTree(SourceText(input.text_), options_, input.name_);
+    }
+
+    static void lex(SyntaxTree* tree) { SyntaxTreeInternals::lex(tree); }
+    static void parse(SyntaxTree* tree) { SyntaxTreeInternals::parse(tree); }
+
+    struct NodeCounter : SyntaxVisitor
+    {
+        using SyntaxVisitor::SyntaxVisitor;
+        bool preVisit(const SyntaxNode*) override { ++cnt_; return true; }
+        std::size_t cnt_ = 0;
+    };
+
+    ParseOptions options_;
+    unsigned int repeat_;
+};
+
+template <class PrepareT, class MeasureT>
+double FrontendBenchmark::bestOf(PrepareT prepare, MeasureT measure) const
+{
+    double best = 0;
+    for (auto i = 0U; i < repeat_; ++i) {
+        auto tree = prepare();
+        auto start = std::chrono::steady_clock::now();
+        measure(tree.get());
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (!i || elapsed.count() < best)
+            best = elapsed.count();
+    }
+    return best;
+}
+
+std::vector<FrontendBenchmark::Measurement> FrontendBenchmark::run(const Input& input) const
+{
+    // The tree of reference, from which the counts are taken.
+    auto tree = newTree(input);
+    lex(tree.get());
+    parse(tree.get());
+    NodeCounter counter(tree.get());
+    counter.visit(tree->root());
+
+    const std::size_t tokens = SyntaxTreeInternals::tokenCount(tree.get()) - 1; // Skip the initial EOF marker.
+    const std::size_t nodes = counter.cnt_;
+    const std::size_t poolBytes = SyntaxTreeInternals::unitPoolBytes(tree.get());
+
+    auto fresh = [&] () { return newTree(input); };
+    auto lexed = [&] () { auto t = newTree(input); lex(t.get()); return t; };
+    auto parsed = [&] () { auto t = lexed(); parse(t.get()); return t; };
+
+    std::vector<Measurement> measurements;
+    auto add = [&] (const char* phase, double seconds) {
+        measurements.push_back({ input.name_, phase, input.text_.size(), tokens, nodes, poolBytes, seconds });
+    };
+
+    add("lex", bestOf(fresh, lex));
+    add("parse", bestOf(lexed, parse));
+    add("traverse", bestOf(parsed, [] (SyntaxTree* t) {
+        NodeCounter counter(t);
+        counter.visit(t->root());
+    }));
+    add("dump", bestOf(parsed, [] (SyntaxTree* t) {
+        std::ostringstream oss;
+        SyntaxNamePrinter printer(t);
+        printer.print(t->root(), SyntaxNamePrinter::Style::Decorated, oss);
+    }));
+
+    return measurements;
+}
+
+} // C
+} // psy
+
+using namespace psy;
+using namespace C;
+
+namespace {
+
+using Measurement = FrontendBenchmark::Measurement;
+
+const char* const kCSVHeader = "input,phase,bytes,tokens,nodes,pool_bytes,seconds,mb_per_s,tokens_per_s,nodes_per_s";
+
+double perSecond(std::size_t cnt, double seconds)
+{
+    return seconds > 0 ? cnt / seconds : 0;
+}
+
+bool readFile(const std::string& path, std::string& text)
+{
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs)
+        return false;
+    text.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool parseSize(const std::string& s, std::size_t& size)
+{
+    char* end = nullptr;
+    auto value = std::strtoull(s.c_str(), &end, 10);
+    if (end == s.c_str())
+        return false;
+    switch (*end) {
+        case '\0': break;
+        case 'k': case 'K': value <<= 10; ++end; break;
+        case 'm': case 'M': value <<= 20; ++end; break;
+        case 'g': case 'G': value <<= 30; ++end; break;
+        default: return false;
+    }
+    size = value;
+    return *end == '\0' && size;
+}
+
+/*
+ * The totals, per phase, of all the inputs.
+ */
+std::vector<Measurement> totalsOf(const std::vector<Measurement>& measurements)
+{
+    std::vector<Measurement> totals;
+    for (const auto& m : measurements) {
+        auto it = std::find_if(totals.begin(), totals.end(),
+                               [&m] (const auto& t) { return t.phase_ == m.phase_; });
+        if (it == totals.end()) {
+            totals.push_back({ "*", m.phase_, 0, 0, 0, 0, 0 });
+            it = totals.end() - 1;
+        }
+        it->bytes_ += m.bytes_;
+        it->tokens_ += m.tokens_;
+        it->nodes_ += m.nodes_;
+        it->poolBytes_ = std::max(it->poolBytes_, m.poolBytes_);
+        it->seconds_ += m.seconds_;
+    }
+    return totals;
+}
+
+void writeCSV(const std::vector<Measurement>& measurements, std::ostream& os)
+{
+    os << kCSVHeader << "\n";
+    for (const auto& m : measurements) {
+        os << m.input_ << ","
+           << m.phase_ << ","
+           << m.bytes_ << ","
+           << m.tokens_ << ","
+           << m.nodes_ << ","
+           << m.poolBytes_ << ","
+           << std::setprecision(9) << m.seconds_ << ","
+           << std::setprecision(6) << perSecond(m.bytes_, m.seconds_) / 1e6 << ","
+           << perSecond(m.tokens_, m.seconds_) << ","
+           << perSecond(m.nodes_, m.seconds_) << "\n";
+    }
+}
+
+void writeText(const std::vector<Measurement>& measurements, std::ostream& os)
+{
+    os << std::left << std::setw(32) << "input"
+       << std::setw(10) << "phase"
+       << std::right << std::setw(12) << "ms"
+       << std::setw(10) << "MB/s"
+       << std::setw(12) << "Mtokens/s"
+       << std::setw(12) << "Mnodes/s"
+       << std::setw(12) << "pool KiB" << "\n";
+
+    os << std::fixed;
+    for (const auto& m : measurements) {
+        auto name = m.input_;
+        if (name.size() > 31)
+            name = "..." + name.substr(name.size() - 28);
+        os << std::left << std::setw(32) << name
+           << std::setw(10) << m.phase_
+           << std::right << std::setprecision(3)
+           << std::setw(12) << m.seconds_ * 1e3
+           << std::setprecision(1)
+           << std::setw(10) << perSecond(m.bytes_, m.seconds_) / 1e6
+           << std::setprecision(2)
+           << std::setw(12) << perSecond(m.tokens_, m.seconds_) / 1e6
+           << std::setw(12) << perSecond(m.nodes_, m.seconds_) / 1e6
+           << std::setw(12) << m.poolBytes_ / 1024 << "\n";
+    }
+    os << std::defaultfloat;
+}
+
+/*
+ * Compare the \p measurements against those of the \p baselinePath, and
+ * return how many regressed (beyond the \p tolerance), or -1 on failure.
+ */
+int compareToBaseline(const std::vector<Measurement>& measurements,
+                      const std::string& baselinePath,
+                      double tolerance,
+                      std::ostream& os)
+{
+    std::ifstream ifs(baselinePath);
+    std::string line;
+    if (!ifs || !std::getline(ifs, line) || line != kCSVHeader) {
+        std::cerr << "invalid baseline " << baselinePath << std::endl;
+        return -1;
+    }
+
+    std::map<std::pair<std::string, std::string>, double> baseline;
+    while (std::getline(ifs, line)) {
+        std::vector<std::string> fields;
+        std::istringstream iss(line);
+        std::string field;
+        while (std::getline(iss, field, ','))
+            fields.push_back(field);
+        if (fields.size() < 7)
+            continue;
+        baseline[std::make_pair(fields[0], fields[1])] = std::strtod(fields[6].c_str(), nullptr);
+    }
+
+    int regressionCnt = 0;
+    os << "\ncomparison to " << baselinePath << " (tolerance " << tolerance * 100 << "%)\n";
+    for (const auto& m : measurements) {
+        auto it = baseline.find(std::make_pair(m.input_, m.phase_));
+        if (it == baseline.end() || it->second <= 0)
+            continue;
+        auto ratio = m.seconds_ / it->second;
+        bool regressed = ratio > 1 + tolerance;
+        if (regressed)
+            ++regressionCnt;
+        os << std::left << std::setw(32) << m.input_
+           << std::setw(10) << m.phase_
+           << std::right << std::fixed << std::setprecision(3)
+           << std::setw(10) << ratio << "x"
+           << (regressed ? "  REGRESSION" : "") << "\n"
+           << std::defaultfloat;
+    }
+    return regressionCnt;
+}
+
+int usage()
+{
+    std::cerr << "usage: psychec-bench [--data DIR] [--synthetic SHAPE:SIZE]... [--repeat N] [--defer-bodies]\n"
+                 "                     [--parse-threads N] [--track-typedefs]\n"
+                 "                     [--format text|csv] [--output FILE]\n"
+                 "                     [--baseline FILE] [--tolerance PERCENT] [file ...]"
+              << std::endl;
+    return 1;
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+    std::string dataDir = PSYCHE_BENCH_DATA_DIR;
+    std::vector<std::string> files;
+    std::vector<std::pair<bench::SourceShape, std::size_t>> synthetics;
+    unsigned int repeat = 5;
+    ParseOptions options;
+    std::string format = "text";
+    std::string outputPath;
+    std::string baselinePath;
+    double tolerance = 0.10;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&] () -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        if (arg == "--data" || arg == "--synthetic" || arg == "--repeat" || arg == "--parse-threads" || arg == "--format"
+                || arg == "--output" || arg == "--baseline" || arg == "--tolerance") {
+            auto v = value();
+            if (!v)
+                return usage();
+            if (arg == "--data") {
+                dataDir = v;
+            }
+            else if (arg == "--synthetic") {
+                std::string spec = v;
+                auto colon = spec.find(':');
+                bench::SourceShape shape;
+                std::size_t size;
+                if (colon == std::string::npos
+                        || !bench::sourceShapeNamed(spec.substr(0, colon), shape)
+                        || !parseSize(spec.substr(colon + 1), size)) {
+                    std::cerr << "invalid synthetic input " << spec << std::endl;
+                    return usage();
+                }
+                synthetics.emplace_back(shape, size);
+            }
+            else if (arg == "--repeat") {
+                repeat = std::strtoul(v, nullptr, 10);
+            }
+            else if (arg == "--parse-threads") {
+                options.setParsingThreadCount(std::strtoul(v, nullptr, 10));
+            }
+            else if (arg == "--format") {
+                format = v;
+                if (format != "text" && format != "csv")
+                    return usage();
+            }
+            else if (arg == "--output") {
+                outputPath = v;
+            }
+            else if (arg == "--baseline") {
+                baselinePath = v;
+            }
+            else {
+                tolerance = std::strtod(v, nullptr) / 100;
+            }
+        }
+        else if (arg == "--defer-bodies") {
+            options.deferFunctionBodies(true);
+        }
+        else if (arg == "--track-typedefs") {
+            options.trackTypedefNames(true);
+        }
+        else if (!arg.empty() && arg[0] == '-') {
+            return usage();
+        }
+        else {
+            files.push_back(arg);
+        }
+    }
+
+    if (!dataDir.empty()) {
+        std::error_code ec;
+        std::vector<std::string> dataFiles;
+        for (const auto& entry : std::filesystem::directory_iterator(dataDir, ec)) {
+            if (entry.path().extension() == ".i")
+                dataFiles.push_back(entry.path().string());
+        }
+        if (ec) {
+            std::cerr << "cannot list " << dataDir << std::endl;
+            return 1;
+        }
+        std::sort(dataFiles.begin(), dataFiles.end());
+        files.insert(files.end(), dataFiles.begin(), dataFiles.end());
+    }
+
+    std::vector<FrontendBenchmark::Input> inputs;
+    for (const auto& path : files) {
+        FrontendBenchmark::Input input;
+        input.name_ = std::filesystem::path(path).filename().string();
+        if (!readFile(path, input.text_)) {
+            std::cerr << "cannot read " << path << std::endl;
+            return 1;
+        }
+        inputs.push_back(std::move(input));
+    }
+    for (const auto& synthetic : synthetics) {
+        FrontendBenchmark::Input input;
+        input.name_ = std::string("synthetic-") + bench::nameOf(synthetic.first)
+                + "-" + std::to_string(synthetic.second);
+        input.text_ = bench::synthesizeSource(synthetic.first, synthetic.second);
+        inputs.push_back(std::move(input));
+    }
+    if (inputs.empty()) {
+        std::cerr << "no inputs" << std::endl;
+        return usage();
+    }
+
+    FrontendBenchmark benchmark(options, repeat);
+    std::vector<Measurement> measurements;
+    for (const auto& input : inputs) {
+        auto inputMeasurements = benchmark.run(input);
+        measurements.insert(measurements.end(), inputMeasurements.begin(), inputMeasurements.end());
+    }
+    if (inputs.size() > 1) {
+        auto totals = totalsOf(measurements);
+        measurements.insert(measurements.end(), totals.begin(), totals.end());
+    }
+
+    std::ofstream ofs;
+    if (!outputPath.empty()) {
+        ofs.open(outputPath);
+        if (!ofs) {
+            std::cerr << "cannot write " << outputPath << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& os = outputPath.empty() ? std::cout : ofs;
+
+    if (format == "csv")
+        writeCSV(measurements, os);
+    else
+        writeText(measurements, os);
+
+    if (!baselinePath.empty()) {
+        auto regressionCnt = compareToBaseline(measurements, baselinePath, tolerance, std::cout);
+        if (regressionCnt) {
+            if (regressionCnt > 0)
+                std::cerr << regressionCnt << " phase(s) regressed" << std::endl;
+            return 2;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,149 @@
+// Copyright (c) 2020/21 Leandro T. C. Melo <ltcmelo@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+/*
+ * Microbenchmark of keyword classification: the perfect hash of
+ * Lexer::classify, in isolation from the rest of the lexer. Identifiers are
+ * taken from the files given as arguments or, if none, from a built-in sample.
+ *
+ *     psychec-bench-keywords [file.i ...]
+ *
+ * The nested-`if` classifier that the perfect hash replaced isn't kept around
+ * for a side-by-side run. Instead, a change to classification is compared
+ * against a build from before it through psychec-bench, whose `keywords'
+ * synthetic shape is dense in keywords: save the CSV of the earlier build
+ * (e.g., --synthetic keywords:4M --format csv --output before.csv) and run
+ * the same input with --baseline before.csv on the later one.
+ */
+
+#include "LanguageExtensions.h"
+#include "parser/Lexer.h"
+#include "parser/ParseOptions.h"
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace psy;
+using namespace C;
+
+namespace {
+
+const char* const sample[] = {
+    "int", "main", "argc", "char", "argv", "return", "static", "const", "size_t",
+    "struct", "node", "next", "if", "else", "while", "for", "i", "n", "len", "buf",
+    "unsigned", "long", "void", "ptr", "typedef", "uint32_t", "sizeof", "break",
+    "__attribute__", "__inline", "__restrict", "_Bool", "bool", "NULL", "errno",
+    "continue", "switch", "case", "default", "enum", "value", "volatile", "and",
+    "extern", "fprintf", "stderr", "double", "float", "_Static_assert", "or_eq",
+    "register", "goto", "do", "union", "short", "signed", "__typeof__", "memcpy",
+};
+
+void appendIdentifiers(const std::string& text, std::vector<std::string>& idents)
+{
+    auto isStart = [] (char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+    };
+    auto isContinue = [&] (char c) { return isStart(c) || (c >= '0' && c <= '9'); };
+
+    for (std::size_t i = 0; i < text.size();) {
+        if (!isStart(text[i])) {
+            ++i;
+            continue;
+        }
+        auto j = i;
+        while (j < text.size() && isContinue(text[j]))
+            ++j;
+        idents.emplace_back(text, i, j - i);
+        i = j;
+    }
+}
+
+double nanosecondsPerIdentifier(const std::vector<std::string>& idents,
+                                std::uint32_t mask,
+                                std::uint64_t& checksum)
+{
+    constexpr std::size_t kTarget = 20000000;
+    const std::size_t rounds = kTarget / idents.size() + 1;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t r = 0; r < rounds; ++r) {
+        for (const auto& ident : idents) {
+            bool isOperatorName;
+            checksum += Lexer::classify(ident.c_str(),
+                                        static_cast<int>(ident.size()),
+                                        mask,
+                                        isOperatorName);
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return std::chrono::duration<double, std::nano>(elapsed).count()
+            / (rounds * idents.size());
+}
+
+} // anonymous
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> idents;
+    for (int i = 1; i < argc; ++i) {
+        std::ifstream ifs(argv[i], std::ios::binary);
+        if (!ifs) {
+            std::cerr << "cannot read " << argv[i] << std::endl;
+            return 1;
+        }
+        appendIdentifiers(std::string(std::istreambuf_iterator<char>(ifs),
+                                      std::istreambuf_iterator<char>()),
+                          idents);
+    }
+    if (idents.empty())
+        idents.assign(std::begin(sample), std::end(sample));
+
+    LanguageExtensions exts;
+    exts.enable_ExtGNU_AlternateKeywords(true)
+        .enable_Expand_operatorNames(true)
+        .enable_Expand_bool_AsKeyword(true)
+        .enable_NULLAsBuiltin(true);
+    ParseOptions opts(LanguageDialect(LanguageDialect::Std::C11), exts);
+    const auto mask = Lexer::classificationMask(opts);
+
+    std::size_t keywordCnt = 0;
+    for (const auto& ident : idents) {
+        bool isOperatorName;
+        if (Lexer::classify(ident.c_str(), static_cast<int>(ident.size()), mask, isOperatorName)
+                != IdentifierToken) {
+            ++keywordCnt;
+        }
+    }
+
+    std::uint64_t checksum = 0;
+    auto ns = nanosecondsPerIdentifier(idents, mask, checksum);
+
+    std::cout << "identifiers:  " << idents.size()
+              << " (" << keywordCnt << " keywords/operator names)\n"
+              << "perfect hash: " << ns << " ns/identifier\n"
+              << "checksum:     " << checksum << "\n";
+    return 0;
+}
@@ -0,0 +1,299 @@
+// Copyright (c) 2020/21 Leandro T. C. Melo <ltcmelo@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "SyntheticSources.h"
+
+#include <random>
+
+using namespace psy;
+using namespace C;
+using namespace bench;
+
+namespace {
+
+const struct
+{
+    SourceShape shape_;
+    const char* name_;
+} shapeNames[] = {
+    { SourceShape::Declarations, "decls" },
+    { SourceShape::Structs, "structs" },
+    { SourceShape::Functions, "funcs" },
+    { SourceShape::Expressions, "exprs" },
+    { SourceShape::Nesting, "nested" },
+    { SourceShape::Keywords, "keywords" },
+};
+
+class Synthesizer
+{
+public:
+    Synthesizer(unsigned int seed) : rng_(seed), cnt_(0) {}
+
+    void declarations(std::string& s)
+    {
+        auto n = std::to_string(cnt_++);
+        switch (pick(6)) {
+            case 0:
+                s += "static int v" + n + " = " + n + ";\n";
+                break;
+            case 1:
+                s += "extern const char *s" + n + ";\n";
+                break;
+            case 2:
+                s += "unsigned long a" + n + "[16] = { 1, 2, 3, " + n + " };\n";
+                break;
+            case 3:
+                s += "double (*fp" + n + ")(int, double *, ...);\n";
+                break;
+            case 4:
+                s += "typedef struct node" + n + " node" + n + "_t;\n";
+                break;
+            default:
+                s += "int f" + n + "(int x, const char *restrict p, long long y[static 4]);\n";
+                break;
+        }
+    }
+
+    void structs(std::string& s)
+    {
+        auto n = std::to_string(cnt_++);
+        switch (pick(3)) {
+            case 0:
+                s += "struct s" + n + " {\n"
+                     "    int a;\n"
+                     "    unsigned char b[8];\n"
+                     "    struct s" + n + " *next;\n"
+                     "    union { long l; double d; } u;\n"
+                     "    unsigned int flag : 1;\n"
+                     "};\n";
+                break;
+            case 1:
+                s += "enum e" + n + " { E" + n + "_A, E" + n + "_B = 4, E" + n + "_C };\n";
+                break;
+            default:
+                s += "typedef struct {\n"
+                     "    const char *name;\n"
+                     "    int (*handler)(void *, int);\n"
+                     "    short values[4];\n"
+                     "} t" + n + ";\n";
+                break;
+        }
+    }
+
+    void function(std::string& s)
+    {
+        auto n = std::to_string(cnt_);
+        auto callee = std::to_string(cnt_ ? cnt_ - 1 : 0);
+        ++cnt_;
+        s += "int f" + n + "(int a, int b)\n"
+             "{\n"
+             "    int x = a + b;\n"
+             "    for (int i = 0; i < b; ++i) {\n"
+             "        if (x > i)\n"
+             "            x -= i;\n"
+             "        else\n"
+             "            x += f" + callee + "(i, a);\n"
+             "    }\n"
+             "    while (x > 100)\n"
+             "        x /= 2;\n"
+             "    switch (a) {\n"
+             "        case 1:\n"
+             "            x = 2;\n"
+             "            break;\n"
+             "        default:\n"
+             "            break;\n"
+             "    }\n"
+             "    return x;\n"
+             "}\n";
+    }
+
+    void expressions(std::string& s)
+    {
+        s += "int g" + std::to_string(cnt_++) + "(int a, int b, int c, int *p)\n{\n    int r = 0;\n";
+        for (auto i = 0; i < 16; ++i) {
+            s += "    r = ";
+            expression(s, 4);
+            s += ";\n";
+        }
+        s += "    return r;\n}\n";
+    }
+
+    void nesting(std::string& s)
+    {
+        const auto depth = 8 + pick(56);
+        s += "void h" + std::to_string(cnt_++) + "(int a)\n{\n";
+        for (auto i = 0U; i < depth; ++i)
+            s += "if (a > " + std::to_string(i) + ") {\n";
+        s += "a = ";
+        for (auto i = 0U; i < depth; ++i)
+            s += "(a + ";
+        s += "1";
+        for (auto i = 0U; i < depth; ++i)
+            s += ")";
+        s += ";\n";
+        for (auto i = 0U; i < depth; ++i)
+            s += "}\n";
+        s += "}\n";
+    }
+
+    /*
+     * Mostly keywords (including alternate ones), and identifiers that are
+     * spelled like keywords, so that the lexer's classification of them
+     * dominates.
+     */
+    void keywords(std::string& s)
+    {
+        static const char* const quals[] = { "const", "volatile", "__const", "__volatile__",
+                                             "restrict", "__restrict" };
+        static const char* const types[] = { "char", "short", "int", "long", "long long",
+                                             "float", "double", "_Bool" };
+        static const char* const idents[] = { "integer", "do_it", "iff", "structure",
+                                              "constant", "longer", "unsigned_", "fortune" };
+
+        auto n = std::to_string(cnt_++);
+        auto ident = std::string(idents[pick(sizeof(idents) / sizeof(idents[0]))]);
+        s += "static __inline__ unsigned " + std::string(types[pick(3) + 1]) + " k" + n + "("
+             + quals[pick(sizeof(quals) / sizeof(quals[0]))] + " signed char *"
+             + quals[pick(sizeof(quals) / sizeof(quals[0]))] + " " + ident + ", register "
+             + types[pick(sizeof(types) / sizeof(types[0]))] + " " + ident + "2)\n"
+             "{\n"
+             "    auto unsigned int i = sizeof(struct k" + n + " *) + _Alignof(double);\n"
+             "    if (" + ident + ") return (" + types[pick(sizeof(types) / sizeof(types[0]))] + ") i;\n"
+             "    else while (" + ident + "2) { if (i) continue; else break; }\n"
+             "    do { switch (i) { case 0: goto out; default: break; } } while (0);\n"
+             "out:\n"
+             "    return (unsigned long) " + ident + "2;\n"
+             "}\n";
+    }
+
+private:
+    unsigned int pick(unsigned int n) { return rng_() % n; }
+
+    void expression(std::string& s, int depth)
+    {
+        static const char* const operands[] = { "a", "b", "c", "p[a]", "*p", "42", "0x7f", "'c'" };
+        static const char* const binOps[] = { " + ", " - ", " * ", " / ", " % ", " << ", " >> ",
+                                              " & ", " | ", " ^ ", " && ", " || ", " < ", " == " };
+
+        if (depth == 0 || pick(4) == 0) {
+            s += operands[pick(sizeof(operands) / sizeof(operands[0]))];
+            return;
+        }
+
+        switch (pick(5)) {
+            case 0:
+                s += "(";
+                expression(s, depth - 1);
+                s += ")";
+                break;
+            case 1:
+                s += "-";
+                expression(s, depth - 1);
+                break;
+            case 2:
+                s += "f0(";
+                expression(s, depth - 1);
+                s += ", ";
+                expression(s, depth - 1);
+                s += ")";
+                break;
+            case 3:
+                expression(s, depth - 1);
+                s += " ? ";
+                expression(s, depth - 1);
+                s += " : ";
+                expression(s, depth - 1);
+                break;
+            default:
+                expression(s, depth - 1);
+                s += binOps[pick(sizeof(binOps) / sizeof(binOps[0]))];
+                expression(s, depth - 1);
+                break;
+        }
+    }
+
+    std::minstd_rand rng_;
+    unsigned int cnt_;
+};
+
+} // anonymous
+
+namespace psy {
+namespace C {
+namespace bench {
+
+bool sourceShapeNamed(const std::string& name, SourceShape& shape)
+{
+    for (const auto& entry : shapeNames) {
+        if (name == entry.name_) {
+            shape = entry.shape_;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* nameOf(SourceShape shape)
+{
+    for (const auto& entry : shapeNames) {
+        if (shape == entry.shape_)
+            return entry.name_;
+    }
+    return "";
+}
+
+std::string synthesizeSource(SourceShape shape, std::size_t size, unsigned int seed)
+{
+    Synthesizer synth(seed);
+    std::string s;
+    s.reserve(size + 4096);
+
+    // The functions of expressions call this one.
+    if (shape == SourceShape::Expressions)
+        s += "int f0(int, int);\n";
+
+    while (s.size() < size) {
+        switch (shape) {
+            case SourceShape::Declarations:
+                synth.declarations(s);
+                break;
+            case SourceShape::Structs:
+                synth.structs(s);
+                break;
+            case SourceShape::Functions:
+                synth.function(s);
+                break;
+            case SourceShape::Expressions:
+                synth.expressions(s);
+                break;
+            case SourceShape::Nesting:
+                synth.nesting(s);
+                break;
+            case SourceShape::Keywords:
+                synth.keywords(s);
+                break;
+        }
+    }
+    return s;
+}
+
+} // bench
+} // C
+} // psy
@@ -0,0 +1,65 @@
+// Copyright (c) 2020/21 Leandro T. C. Melo <ltcmelo@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PSYCHE_C_BENCH_SYNTHETIC_SOURCES_H__
+#define PSYCHE_C_BENCH_SYNTHETIC_SOURCES_H__
+
+#include <cstddef>
+#include <string>
+
+namespace psy {
+namespace C {
+namespace bench {
+
+/**
+ * The shapes of synthetic (already preprocessed) C sources, each one
+ * stressing a different part of the frontend.
+ */
+enum class SourceShape : char
+{
+    Declarations,   /**< File-scope declarations (many short statements). */
+    Structs,        /**< Struct, union, and enum definitions, and typedefs. */
+    Functions,      /**< Function definitions with a mix of statements. */
+    Expressions,    /**< Functions with long, randomly shaped, expressions. */
+    Nesting,        /**< Deeply nested blocks and parenthesized expressions. */
+    Keywords,       /**< Keywords, alternate keywords, and identifiers alike. */
+};
+
+/**
+ * The SourceShape named \p name (e.g., \c "decls"); \c false if none is.
+ */
+bool sourceShapeNamed(const std::string& name, SourceShape& shape);
+
+/**
+ * The name of the SourceShape \p shape.
+ */
+const char* nameOf(SourceShape shape);
+
+/**
+ * A synthetic source of the given \p shape, with (at least) \p size bytes;
+ * the same \p seed yields the same source.
+ */
+std::string synthesizeSource(SourceShape shape, std::size_t size, unsigned int seed = 1);
+
+} // bench
+} // C
+} // psy
+
+#endif
@@ -22,7 +22,6 @@
 
 #include "Executer_C.h"
 #include "FileInfo.h"
-#include "IO.h"
 #include "Plugin.h"
 
 #include <algorithm>
@@ -140,12 +139,14 @@ int Driver::execute(int argc, char* argv[])
         return ERROR_UnrecognizedCommandLine;
     }
 
-    auto [exit, source] = readFile(config_->input_.fullFileName());
-    if (exit != 0)
+    auto [exit, text] = SourceText::mapFile(config_->input_.fullFileName());
+    if (exit != 0) {
+        std::cerr << kCnip << "file input error: " << config_->input_.fullFileName() << std::endl;
         return ERROR_InputFileReadingFailure;
+    }
 
     if (lang == "C")
-        return Executer_C(this).execute(source);
+        return Executer_C(this).execute(std::move(text));
 
     std::cerr << kCnip << "unsupported language" << std::endl;
     return ERROR_UnsupportedLanguage;
@@ -28,6 +28,8 @@
 #include "plugin-api/SourceInspector.h"
 #include "syntax/SyntaxNamePrinter.h"
 
+#include <iterator>
+
 using namespace cnip;
 using namespace psy;
 using namespace C;
@@ -47,13 +49,13 @@ constexpr int Executer_C::ERROR_PreprocessedFileWritingFailure;
 constexpr int Executer_C::ERROR_UnsuccessfulParsing;
 constexpr int Executer_C::ERROR_InvalidSyntaxTree;
 
-int Executer_C::execute(const std::string& source)
+int Executer_C::execute(SourceText text)
 {
-    if (source.empty())
+    if (!text.size())
          return 0;
 
     try {
-        return executeCore(source);
+        return executeCore(std::move(text));
     }
     catch (...) {
         Plugin::unload();
@@ -61,23 +63,36 @@ int Executer_C::execute(const std::string& source)
     }
 }
 
-int Executer_C::executeCore(std::string source)
+int Executer_C::executeCore(SourceText text)
 {
     if (driver_->config_->C_infer
             || driver_->config_->C_inferOnly) {
         inferMode_ = true;
     }
 
-    auto [includes, source_P] = extendSource(source);
+    // When the source is neither extended nor preprocessed, its text (which
+    // may be a file mapping) is parsed as is, without being copied.
+    if (!Plugin::isLoaded() && !driver_->config_->C_pp_) {
+        reportUnextendedSource();
+        return invokeParser(std::move(text));
+    }
+
+    auto [includes, source_P] = extendSource(std::string(text.rawText()));
 
     if (driver_->config_->C_pp_) {
         auto [exit, source_PP] = invokePreprocessor(source_P);
         if (exit != 0)
             return exit;
-        source_P = source_PP;
+        source_P = std::move(source_PP);
     }
 
-    return invokeParser(source_P);
+    return invokeParser(SourceText(std::move(source_P)));
+}
+
+void Executer_C::reportUnextendedSource() const
+{
+    if (inferMode_)
+        std::cout << kCnip << "stdlib names will be treated as ordinary identifiers" << std::endl;
 }
 
 std::pair<std::string, std::string> Executer_C::extendSource(
@@ -93,8 +108,7 @@ std::pair<std::string, std::string> Executer_C::extendSource(
     }
 
     if (!Plugin::isLoaded()) {
-        if (inferMode_)
-            std::cout << kCnip << "stdlib names will be treated as ordinary identifiers" << std::endl;
+        reportUnextendedSource();
         return std::make_pair(includes, source);
     }
 
@@ -138,9 +152,9 @@ std::pair<int, std::string> Executer_C::invokePreprocessor(std::string source)
     return std::make_pair(0, ppSource);
 }
 
-int Executer_C::invokeParser(const std::string& source)
+int Executer_C::invokeParser(SourceText text)
 {
-    auto tree = SyntaxTree::parseText(source,
+    auto tree = SyntaxTree::parseText(std::move(text),
                                       ParseOptions(),
                                       driver_->config_->input_.fileName());
 
@@ -155,8 +169,8 @@ int Executer_C::invokeParser(const std::string& source)
         return ERROR_InvalidSyntaxTree;
     }
 
-    if (!tree->diagnostics().empty()) {
-        auto c = tree->diagnostics();
+    if (tree->diagnosticCount()) {
+        const auto& c = tree->diagnostics();
         std::copy(c.begin(), c.end(),
                   std::ostream_iterator<Diagnostic>(std::cerr));
         std::cerr << std::endl;
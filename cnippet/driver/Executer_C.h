@@ -23,6 +23,8 @@
 
 #include "Driver.h"
 
+#include "common/text/SourceText.h"
+
 #include <utility>
 #include <string>
 
@@ -36,14 +38,15 @@ public:
         , inferMode_(false)
     {}
 
-    int execute(const std::string& source);
+    int execute(psy::SourceText text);
 
 private:
-    int executeCore(std::string source);
+    int executeCore(psy::SourceText text);
 
+    void reportUnextendedSource() const;
     std::pair<std::string, std::string> extendSource(const std::string& source);
     std::pair<int, std::string> invokePreprocessor(std::string source);
-    int invokeParser(const std::string& source);
+    int invokeParser(psy::SourceText text);
 
     Driver* driver_;
     bool inferMode_;
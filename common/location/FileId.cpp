@@ -0,0 +1,77 @@
+// Copyright (c) 2020/21 Leandro T. C. Melo <ltcmelo@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "FileId.h"
+
+#include <mutex>
+#include <unordered_set>
+
+using namespace psy;
+
+namespace {
+
+struct FileIdTable
+{
+    std::mutex mutex_;
+    std::unordered_set<std::string> paths_;
+};
+
+FileIdTable& table()
+{
+    // Never destroyed: FileIds may outlive static objects that hold them.
+    static FileIdTable* tab = new FileIdTable;
+    return *tab;
+}
+
+const std::string* emptyPath()
+{
+    static const std::string* path = [] () {
+        auto& tab = table();
+        std::lock_guard<std::mutex> lock(tab.mutex_);
+        return &*tab.paths_.insert(std::string()).first;
+    }();
+    return path;
+}
+
+} // anonymous
+
+FileId::FileId()
+    : path_(emptyPath())
+{}
+
+FileId FileId::of(const std::string& path)
+{
+    if (path.empty())
+        return FileId();
+
+    auto& tab = table();
+    std::lock_guard<std::mutex> lock(tab.mutex_);
+    return FileId(&*tab.paths_.insert(path).first);
+}
+
+namespace psy {
+
+std::ostream& operator<<(std::ostream& os, FileId fileId)
+{
+    os << fileId.path();
+    return os;
+}
+
+} // psy
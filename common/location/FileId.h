@@ -0,0 +1,77 @@
+// Copyright (c) 2020/21 Leandro T. C. Melo <ltcmelo@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PSYCHE_FILE_ID_H__
+#define PSYCHE_FILE_ID_H__
+
+#include "../API.h"
+
+#include <ostream>
+#include <string>
+
+namespace psy {
+
+/**
+ * \brief The FileId class.
+ *
+ * An interned identity of a file path: all FileIds of the same path share
+ * the path's single copy, so a FileId is copied and compared as a pointer.
+ * The path (as a string) is resolved only when it's presented.
+ *
+ * \note
+ * The interning is process-wide, and the paths are never released; the
+ * files of a program are few, even when their (line-directive) mentions
+ * are numerous.
+ */
+class PSY_API FileId
+{
+public:
+    /**
+     * The FileId of the empty path.
+     */
+    FileId();
+
+    /**
+     * The FileId of the given \p path.
+     */
+    static FileId of(const std::string& path);
+
+    /**
+     * The path of the file.
+     */
+    const std::string& path() const { return *path_; }
+
+private:
+    explicit FileId(const std::string* path) : path_(path) {}
+
+    friend bool operator==(FileId a, FileId b);
+
+    const std::string* path_;
+};
+
+inline bool operator==(FileId a, FileId b) { return a.path_ == b.path_; }
+
+inline bool operator!=(FileId a, FileId b) { return !(a == b); }
+
+std::ostream& operator<<(std::ostream& os, FileId fileId);
+
+} // psy
+
+#endif
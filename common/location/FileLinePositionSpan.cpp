@@ -24,12 +24,12 @@ namespace psy {
 
 bool operator==(const FileLinePositionSpan& a, const FileLinePositionSpan& b)
 {
-    return a.path() == b.path() && a.span() == b.span();
+    return a.fileId() == b.fileId() && a.span() == b.span();
 }
 
 std::ostream& operator<<(std::ostream& os, const FileLinePositionSpan& span)
 {
-    os << span.path() << ":" << span.span();
+    os << span.fileId() << ":" << span.span();
     return os;
 }
 
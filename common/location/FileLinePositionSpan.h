@@ -23,6 +23,7 @@
 
 #include "../API.h"
 
+#include "FileId.h"
 #include "LinePositionSpan.h"
 
 #include <ostream>
@@ -43,22 +44,37 @@ namespace psy {
 class PSY_API FileLinePositionSpan
 {
 public:
-    FileLinePositionSpan(std::string path, LinePositionSpan span)
-        : path_(std::move(path))
+    FileLinePositionSpan(FileId fileId, LinePositionSpan span)
+        : fileId_(fileId)
         , span_(std::move(span))
     {}
 
-    FileLinePositionSpan(std::string path,
+    FileLinePositionSpan(FileId fileId,
                          const LinePosition& start,
                          const LinePosition& end)
-        : path_(std::move(path))
+        : fileId_(fileId)
         , span_(start, end)
     {}
 
+    FileLinePositionSpan(const std::string& path, LinePositionSpan span)
+        : FileLinePositionSpan(FileId::of(path), std::move(span))
+    {}
+
+    FileLinePositionSpan(const std::string& path,
+                         const LinePosition& start,
+                         const LinePosition& end)
+        : FileLinePositionSpan(FileId::of(path), start, end)
+    {}
+
+    /**
+     * The identity of the file.
+     */
+    FileId fileId() const { return fileId_; }
+
     /**
      * The path of the file.
      */
-    std::string path() const { return path_; }
+    const std::string& path() const { return fileId_.path(); }
 
     /**
      * The line span within the file.
@@ -76,7 +92,7 @@ public:
     LinePosition starLinePosition() const { return span_.start(); }
 
 private:
-    std::string path_;
+    FileId fileId_;
     LinePositionSpan span_;
 };
 
@@ -36,6 +36,11 @@ Location Location::create(std::string filePath, LinePositionSpan span)
     return loc;
 }
 
+Location Location::create(FileId fileId, LinePositionSpan lineSpan)
+{
+    return Location(FileLinePositionSpan(fileId, std::move(lineSpan)));
+}
+
 Location Location::create(FileLinePositionSpan fileLineSpan)
 {
     return Location(std::move(fileLineSpan));
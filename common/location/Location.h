@@ -41,6 +41,7 @@ class PSY_API Location
 {
 public:
     static Location create(std::string filePath, LinePositionSpan lineSpan);
+    static Location create(FileId fileId, LinePositionSpan lineSpan);
     static Location create(FileLinePositionSpan fileLineSpan);
 
     /**
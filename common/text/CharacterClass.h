@@ -0,0 +1,98 @@
+// Copyright (c) 2020/21 Leandro T. C. Melo <ltcmelo@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PSYCHE_CHARACTER_CLASS_H__
+#define PSYCHE_CHARACTER_CLASS_H__
+
+#include <cstdint>
+
+namespace psy {
+
+/**
+ * \brief The CharacterClass class.
+ *
+ * A locale-independent classification of ASCII characters through a table
+ * computed at compile time. A byte with the most significant bit set (i.e.,
+ * a byte of a multi-byte UTF-8 code point) belongs to no class.
+ */
+class CharacterClass
+{
+public:
+    enum : std::uint8_t
+    {
+        IdentifierStart    = 1 << 0,  /**< \c A-Z, \c a-z, \c _, and \c $ */
+        IdentifierContinue = 1 << 1,  /**< \c IdentifierStart and \c 0-9 */
+        Digit              = 1 << 2,  /**< \c 0-9 */
+        HexDigit           = 1 << 3,  /**< \c 0-9, \c A-F, and \c a-f */
+        Space              = 1 << 4,  /**< As \c std::isspace in the "C" locale */
+        Punctuation        = 1 << 5   /**< As \c std::ispunct in the "C" locale */
+    };
+
+    static constexpr std::uint8_t of(unsigned char c);
+
+    static constexpr bool isIdentifierStart(unsigned char c) { return of(c) & IdentifierStart; }
+    static constexpr bool isIdentifierContinue(unsigned char c) { return of(c) & IdentifierContinue; }
+    static constexpr bool isDigit(unsigned char c) { return of(c) & Digit; }
+    static constexpr bool isHexDigit(unsigned char c) { return of(c) & HexDigit; }
+    static constexpr bool isSpace(unsigned char c) { return of(c) & Space; }
+    static constexpr bool isPunctuation(unsigned char c) { return of(c) & Punctuation; }
+
+private:
+    struct Table
+    {
+        std::uint8_t v_[256];
+    };
+
+    static constexpr Table build();
+    static const Table table_;
+};
+
+constexpr CharacterClass::Table CharacterClass::build()
+{
+    Table t {};
+    for (int c = 0; c < 128; ++c) {
+        std::uint8_t k = 0;
+        bool alpha = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+        bool digit = c >= '0' && c <= '9';
+        if (alpha || c == '_' || c == '$')
+            k |= IdentifierStart | IdentifierContinue;
+        if (digit)
+            k |= IdentifierContinue | Digit | HexDigit;
+        if ((c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f'))
+            k |= HexDigit;
+        if (c == ' ' || (c >= '\t' && c <= '\r'))
+            k |= Space;
+        if (c > ' ' && c < 127 && !alpha && !digit)
+            k |= Punctuation;
+        t.v_[c] = k;
+    }
+    return t;
+}
+
+inline constexpr CharacterClass::Table CharacterClass::table_ = CharacterClass::build();
+
+constexpr std::uint8_t CharacterClass::of(unsigned char c)
+{
+    return table_.v_[c];
+}
+
+} // psy
+
+#endif
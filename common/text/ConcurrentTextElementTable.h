@@ -0,0 +1,97 @@
+// Copyright (c) 2016/17/18/19/20/21 Leandro T. C. Melo <ltcmelo@gmail.com>
+// Copyright (c) 2008 Roberto Raggi <roberto.raggi@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+
+// THE SOFTWARE.
+
+#ifndef PSYCHE_CONCURRENT_TEXT_ELEMENT_TABLE_H__
+#define PSYCHE_CONCURRENT_TEXT_ELEMENT_TABLE_H__
+
+#include "TextElementTable.h"
+
+#include <mutex>
+
+namespace psy {
+
+/**
+ * \brief The ConcurrentTextElementTable class.
+ *
+ * A table of unique TextElements that may be looked up, and inserted into,
+ * from multiple threads at once.
+ *
+ * The table is split into shards, each one a TextElementTable guarded by
+ * its own lock; the shard of an element is picked from bits of its hash code
+ * that the shard's table doesn't use for the element's group (unless it's
+ * very large) nor for its control byte. Given that the elements are allocated
+ * from the arenas of the shards, a pointer to an element is stable for the
+ * lifetime of the table.
+ */
+template <class ElemT>
+class ConcurrentTextElementTable
+{
+public:
+    ConcurrentTextElementTable(const ConcurrentTextElementTable&) = delete;
+    void operator=(const ConcurrentTextElementTable&) = delete;
+
+    ConcurrentTextElementTable() = default;
+
+    const ElemT* find(const char* chars, unsigned int size) const
+    {
+        const unsigned int h = ElemT::hashCode(chars, size);
+        const Shard& shard = shardOf(h);
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        return shard.table_.find(chars, size, h);
+    }
+
+    const ElemT* findOrInsert(const char* chars, unsigned int size)
+    {
+        const unsigned int h = ElemT::hashCode(chars, size);
+        Shard& shard = shardOf(h);
+        std::lock_guard<std::mutex> lock(shard.mutex_);
+        return shard.table_.findOrInsert(chars, size, h);
+    }
+
+    unsigned int size() const
+    {
+        unsigned int cnt = 0;
+        for (const auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex_);
+            cnt += shard.table_.size();
+        }
+        return cnt;
+    }
+
+private:
+    static constexpr unsigned int kShardCnt = 32;
+
+    struct alignas(64) Shard
+    {
+        mutable std::mutex mutex_;
+        TextElementTable<ElemT> table_;
+    };
+
+    Shard& shardOf(unsigned int h) { return shards_[(h >> 20) & (kShardCnt - 1)]; }
+    const Shard& shardOf(unsigned int h) const { return shards_[(h >> 20) & (kShardCnt - 1)]; }
+
+    Shard shards_[kShardCnt];
+};
+
+} // psy
+
+#endif
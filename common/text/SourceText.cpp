@@ -20,13 +20,212 @@
 
 #include "SourceText.h"
 
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+#if !defined _WIN32 && !defined __CYGWIN__
+  #define PSY_MMAP_AVAILABLE
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
 using namespace psy;
 
-SourceText::SourceText(std::string rawText)
-    : rawText_(std::move(rawText))
+struct SourceText::SourceTextImpl
+{
+    SourceTextImpl()
+        : chars_("")
+        , size_(0)
+        , map_(nullptr)
+        , mapSize_(0)
+    {}
+
+    ~SourceTextImpl()
+    {
+#ifdef PSY_MMAP_AVAILABLE
+        if (map_)
+            munmap(map_, mapSize_);
+#endif
+    }
+
+    void own(std::string rawText)
+    {
+        owned_ = std::move(rawText);
+        chars_ = owned_.c_str();
+        size_ = owned_.size();
+    }
+
+    std::string owned_;
+    std::shared_ptr<SourceTextImpl> base_;
+    const char* chars_;
+    std::size_t size_;
+    void* map_;
+    std::size_t mapSize_;
+
+    std::once_flag lineStartsFlag_;
+    std::vector<unsigned int> lineStarts_;
+};
+
+SourceText::SourceText()
+    : P(std::make_shared<SourceTextImpl>())
 {}
 
-const std::string& SourceText::rawText() const
+SourceText::SourceText(std::string rawText)
+    : P(std::make_shared<SourceTextImpl>())
+{
+    P->own(std::move(rawText));
+}
+
+namespace {
+
+std::pair<int, std::string> readAll(const std::string& filePath)
+{
+    std::ifstream ifs(filePath, std::ios::binary);
+    if (!ifs)
+        return std::make_pair(1, std::string());
+
+    // A non-seekable input (e.g., a pipe) is read through a stream.
+    ifs.seekg(0, std::ios::end);
+    auto size = ifs.tellg();
+    if (size == std::ifstream::pos_type(-1)) {
+        ifs.clear();
+        std::ostringstream oss;
+        oss << ifs.rdbuf();
+        return std::make_pair(ifs.bad() ? 1 : 0, oss.str());
+    }
+
+    std::string s(static_cast<std::size_t>(size), '\0');
+    ifs.seekg(0);
+    ifs.read(&s[0], s.size());
+    return std::make_pair(ifs && ifs.gcount() == size ? 0 : 1, std::move(s));
+}
+
+} // anonymous
+
+std::pair<int, SourceText> SourceText::mapFile(const std::string& filePath)
+{
+    SourceText text;
+
+#ifdef PSY_MMAP_AVAILABLE
+    // Only a regular file is mapped; the size of anything else (e.g., a
+    // pipe) isn't known upfront, so it's read.
+    struct stat st;
+    if (stat(filePath.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+        int fd = open(filePath.c_str(), O_RDONLY);
+        if (fd == -1)
+            return std::make_pair(1, text);
+
+        if (fstat(fd, &st) == -1) {
+            close(fd);
+            return std::make_pair(1, text);
+        }
+
+        std::size_t size = st.st_size;
+        if (!size) {
+            close(fd);
+            return std::make_pair(0, text);
+        }
+
+        // Reserve (zero-filled) room for the text plus its terminating null
+        // character, and place the file mapping over the start of it; if the
+        // size of the file is a multiple of the page size, the null character
+        // comes from the reserved page that follows the file mapping.
+        std::size_t pageSize = sysconf(_SC_PAGESIZE);
+        std::size_t mapSize = (size + pageSize) & ~(pageSize - 1);
+        void* map = mmap(nullptr, mapSize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (map != MAP_FAILED
+                && mmap(map, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) != MAP_FAILED) {
+            close(fd);
+            madvise(map, size, MADV_SEQUENTIAL);
+            text.P->map_ = map;
+            text.P->mapSize_ = mapSize;
+            text.P->chars_ = static_cast<const char*>(map);
+            text.P->size_ = size;
+            return std::make_pair(0, text);
+        }
+
+        if (map != MAP_FAILED)
+            munmap(map, mapSize);
+        close(fd);
+    }
+#endif
+
+    auto [exit, rawText] = readAll(filePath);
+    if (exit != 0)
+        return std::make_pair(exit, text);
+
+    text.P->own(std::move(rawText));
+    return std::make_pair(0, text);
+}
+
+SourceText SourceText::withChange(const TextChange& change) const
+{
+    const auto& span = change.span();
+    const auto& newText = change.newText();
+
+    std::string rawText;
+    rawText.reserve(P->size_ - (span.end() - span.start()) + newText.size());
+    rawText.append(P->chars_, span.start());
+    rawText.append(newText);
+    rawText.append(P->chars_ + span.end(), P->size_ - span.end());
+    return SourceText(std::move(rawText));
+}
+
+SourceText SourceText::slice(std::size_t start, std::size_t size) const
+{
+    SourceText text;
+    text.P->base_ = P->base_ ? P->base_ : P;
+    text.P->chars_ = P->chars_ + start;
+    text.P->size_ = size;
+    return text;
+}
+
+std::string_view SourceText::rawText() const
+{
+    return std::string_view(P->chars_, P->size_);
+}
+
+const char* SourceText::c_str() const
+{
+    return P->chars_;
+}
+
+std::size_t SourceText::size() const
+{
+    return P->size_;
+}
+
+bool SourceText::isMapped() const
+{
+    return P->map_ != nullptr || (P->base_ && P->base_->map_ != nullptr);
+}
+
+const std::vector<unsigned int>& SourceText::lineStarts() const
+{
+    std::call_once(P->lineStartsFlag_, [this] () {
+        auto& lineStarts = P->lineStarts_;
+        lineStarts.push_back(0);
+
+        // Let the (vectorized) memchr of the C library do the scanning.
+        const char* beg = P->chars_;
+        const char* end = beg + P->size_;
+        for (const char* p = beg;
+                (p = static_cast<const char*>(std::memchr(p, '\n', end - p)));
+                ++p) {
+            lineStarts.push_back(p - beg + 1);
+        }
+    });
+    return P->lineStarts_;
+}
+
+void SourceText::seedLineStarts(std::vector<unsigned int> lineStarts) const
 {
-    return rawText_;
+    std::call_once(P->lineStartsFlag_, [this, &lineStarts] () {
+        P->lineStarts_ = std::move(lineStarts);
+    });
 }
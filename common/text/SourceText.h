@@ -27,22 +27,92 @@
 
 #include "../API.h"
 
+#include "../infra/Pimpl.h"
+
+#include "TextChange.h"
+
+#include <cstddef>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace psy {
 
 /**
  * The SourceText class.
+ *
+ * The text is shared (not copied) among copies of a SourceText, and it
+ * is followed by a null character, so that it may be scanned as a C-style
+ * string; the exception is a slice (see SourceText::slice) that doesn't
+ * reach the end of the text it's taken from.
  */
 class PSY_API SourceText
 {
 public:
     SourceText(std::string rawText);
 
-    const std::string& rawText() const;
+    /**
+     * Create a SourceText with the contents of the file at \p filePath,
+     * mapped read-only into memory (the file contents are not copied).
+     * A file that can't be mapped (e.g., a pipe) is read instead. The
+     * returned \c int is \c 0 on success, and non-zero otherwise.
+     */
+    static std::pair<int, SourceText> mapFile(const std::string& filePath);
+
+    /**
+     * Create a SourceText with the text of \c this SourceText as changed by
+     * the given \p change, whose span is in bytes.
+     */
+    SourceText withChange(const TextChange& change) const;
+
+    /**
+     * Create a SourceText with the \p size bytes of \c this SourceText from
+     * \p start on. The slice shares (and keeps alive) the text of \c this
+     * SourceText; it isn't followed by a null character unless it reaches
+     * the end of the text.
+     */
+    SourceText slice(std::size_t start, std::size_t size) const;
+
+    /**
+     * The raw text of \c this SourceText.
+     */
+    std::string_view rawText() const;
+
+    /**
+     * The raw text of \c this SourceText, as a C-style string (but see
+     * SourceText::slice).
+     */
+    const char* c_str() const;
+
+    /**
+     * The size, in bytes, of \c this SourceText.
+     */
+    std::size_t size() const;
+
+    /**
+     * Whether \c this SourceText (or the one it's a slice of) is backed by
+     * a memory-mapped file.
+     */
+    bool isMapped() const;
+
+    /**
+     * The byte offsets at which the lines of \c this SourceText start, in
+     * ascending order (the first one is \c 0). The line index is built on
+     * the first request, and shared among copies of \c this SourceText.
+     */
+    const std::vector<unsigned int>& lineStarts() const;
+
+    /**
+     * Seed the line index of \c this SourceText with \p lineStarts computed
+     * elsewhere (e.g., loaded from a cache), if the index isn't built yet.
+     */
+    void seedLineStarts(std::vector<unsigned int> lineStarts) const;
 
 private:
-    std::string rawText_;
+    SourceText();
+
+    DECL_SHARED_DATA(SourceText)
 };
 
 } // psy
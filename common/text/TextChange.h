@@ -0,0 +1,73 @@
+// Copyright (c) 2016/17/18/19/20/21 Leandro T. C. Melo <ltcmelo@gmail.com>
+// Copyright (c) 2008 Roberto Raggi <roberto.raggi@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PSYCHE_TEXT_CHANGE_H__
+#define PSYCHE_TEXT_CHANGE_H__
+
+#include "../API.h"
+
+#include "TextSpan.h"
+
+#include <ostream>
+#include <string>
+
+namespace psy {
+
+/**
+ * \brief The TextChange class.
+ *
+ * An abstraction representation of a change to a text: the replacement of the
+ * (possibly empty) span of text with a new (possibly empty) text.
+ *
+ * \note
+ * This API is inspired by that of \c Microsoft.CodeAnalysis.Text.TextChange
+ * from Roslyn, the .NET Compiler Platform.
+ */
+class PSY_API TextChange
+{
+public:
+    TextChange(TextSpan span, std::string newText)
+        : span_(std::move(span))
+        , newText_(std::move(newText))
+    {}
+
+    /**
+     * The span of (the original) text replaced by \c this change.
+     */
+    const TextSpan& span() const { return span_; }
+
+    /**
+     * The text that replaces that of the span of \c this change.
+     */
+    const std::string& newText() const { return newText_; }
+
+private:
+    TextSpan span_;
+    std::string newText_;
+};
+
+bool operator==(const TextChange& a, const TextChange& b);
+
+std::ostream& operator<<(std::ostream& os, const TextChange& change);
+
+} // psy
+
+#endif
@@ -21,43 +21,47 @@
 
 #include "TextElement.h"
 
+#include <cstdint>
 #include <cstring>
 
 using namespace psy;
 
-TextElement::TextElement(const char* chars, unsigned int size)
+TextElement::TextElement(const char* chars, unsigned int size, unsigned int hash)
     : size_(size)
-    , chars_(new char[size + 1])
-    , next_(nullptr)
-{
-    std::strncpy(chars_, chars, size);
-    chars_[size] = 0;
-    hashCode_ = hashCode(chars_, size_);
-}
+    , hashCode_(hash)
+    , chars_(chars)
+{}
 
 TextElement::~TextElement()
-{
-    delete[] chars_;
-}
+{}
 
 unsigned int TextElement::hashCode(const char* chars, unsigned int size)
 {
-    // Hash taken from QtCore's qHash for strings, which in turn has the note:
+    // A word-at-a-time hash: each 8-byte word (the last one, zero-padded)
+    // is mixed into the state with a multiplication, as in wyhash/murmur.
 
-    /*
-    These functions are based on Peter J. Weinberger's hash function
-    (from the Dragon Book). The constant 24 in the original function
-    was replaced with 23 to produce fewer collisions on input such as
-    "a", "aa", "aaa", "aaaa", ...
-    */
+    constexpr std::uint64_t kMul = 0x9e3779b97f4a7c15ULL;
 
-    unsigned int h = 0;
-    while (size--) {
-        h = (h << 4) + *chars++;
-        h ^= (h & 0xf0000000) >> 23;
-        h &= 0x0fffffff;
+    std::uint64_t h = size * kMul;
+    while (size >= 8) {
+        std::uint64_t w;
+        std::memcpy(&w, chars, 8);
+        h = (h ^ w) * kMul;
+        h ^= h >> 32;
+        chars += 8;
+        size -= 8;
+    }
+    if (size) {
+        std::uint64_t w = 0;
+        std::memcpy(&w, chars, size);
+        h = (h ^ w) * kMul;
+        h ^= h >> 32;
     }
-    return h;
+
+    h ^= h >> 29;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 32;
+    return static_cast<unsigned int>(h);
 }
 
 namespace psy {
@@ -29,15 +29,18 @@ namespace psy {
 /**
  * \brief The TextElement class.
  *
- * A read-only element of text, stored in dedicated memory, and
- * chained together with other elements within a hash table.
+ * A read-only element of text. The characters aren't copied: they must be
+ * null-terminated and outlive the element (a TextElementTable stores both
+ * the element and its characters in the table's arena). The hash code of
+ * the characters (see TextElement::hashCode) is given by the table, which
+ * computes it, once, for the lookup that precedes the element's creation.
  *
  * \see TextElementTable
  */
 class PSY_API TextElement
 {
 public:
-    TextElement(const char* c_str, unsigned int size);
+    TextElement(const char* c_str, unsigned int size, unsigned int hash);
     TextElement(const TextElement& other) = delete;
     virtual ~TextElement();
     void operator=(const TextElement& other) = delete;
@@ -68,15 +71,15 @@ public:
 
 private:
     template <class> friend class TextElementTable;
+    template <class> friend class ConcurrentTextElementTable;
     friend bool operator==(const TextElement& a, const TextElement& b);
 
     unsigned int size_;
-    char* chars_;
     unsigned int hashCode_;
-    TextElement* next_;
+    const char* chars_;
 
     unsigned int hashCode() const { return hashCode_; }
-    static unsigned int hashCode(const char* c_str, unsigned int size);
+    static unsigned int hashCode(const char* chars, unsigned int size);
 };
 
 } // psy
@@ -17,16 +17,42 @@
 // AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
 // LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
-// THE SOFTWARE.
 
 #ifndef PSYCHE_TEXT_ELEMENT_TABLE_H__
 #define PSYCHE_TEXT_ELEMENT_TABLE_H__
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <new>
+#include <vector>
+
+#if (defined(__GNUC__) && defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))) \
+        || (defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+  #define PSY_TEXT_ELEMENT_TABLE_SSE2
+  #include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+  #include <intrin.h>
+  #include <malloc.h>
+#endif
 
 namespace psy {
 
+/**
+ * \brief The TextElementTable class.
+ *
+ * A table of unique TextElements, in order of insertion.
+ *
+ * The table is open-addressed: along with the element slots, there's an
+ * array of control bytes, one per slot, which is either empty or holds 7
+ * bits of the hash code of the slot's element. A lookup probes groups of
+ * 16 control bytes (with SSE2, when available) and compares strings only
+ * when the bits match. The elements, and their characters, are allocated
+ * from an arena owned by the table.
+ */
 template <class ElemT>
 class TextElementTable
 {
@@ -35,11 +61,11 @@ public:
     void operator=(const TextElementTable&) = delete;
 
     TextElementTable()
-       : elements_(nullptr)
-       , count_(-1)
-       , allocated_(0)
-       , buckets_(nullptr)
-       , bucketCount_(0)
+        : ctrl_(nullptr)
+        , slots_(nullptr)
+        , groupMask_(0)
+        , arenaCur_(nullptr)
+        , arenaEnd_(nullptr)
     {}
 
     ~TextElementTable()
@@ -48,100 +74,205 @@ public:
     }
 
     typedef ElemT* const* iterator;
-    iterator begin() const { return elements_; }
-    iterator end() const { return elements_ + count_ + 1; }
+    iterator begin() const { return elements_.data(); }
+    iterator end() const { return elements_.data() + elements_.size(); }
 
-    bool empty() const { return count_ == -1; }
-    unsigned int size() const { return count_ + 1; }
+    bool empty() const { return elements_.empty(); }
+    unsigned int size() const { return elements_.size(); }
     const ElemT* at(unsigned int idx) const { return elements_[idx]; }
 
     const ElemT* find(const char* chars, unsigned int size) const
     {
-        if (buckets_) {
-            unsigned int h = ElemT::hashCode(chars, size);
-            ElemT* elem = buckets_[h % bucketCount_];
-            for (; elem; elem = static_cast<ElemT*>(elem->next_)) {
-                if (elem->size() == size && !std::strncmp(elem->c_str(), chars, size))
+        return find(chars, size, ElemT::hashCode(chars, size));
+    }
+
+    const ElemT* find(const char* chars, unsigned int size, unsigned int h) const
+    {
+        if (!ctrl_)
+            return nullptr;
+
+        const std::uint8_t tag = h >> 25;
+        auto groupIdx = h & groupMask_;
+        for (unsigned int stride = 1; ; ++stride) {
+            const std::uint8_t* group = ctrl_ + groupIdx * kGroupSize;
+            for (auto match = matchTag(group, tag); match; match &= match - 1) {
+                ElemT* elem = slots_[groupIdx * kGroupSize + lowestBitIndex(match)];
+                if (elem->size() == size && !std::memcmp(elem->c_str(), chars, size))
                     return elem;
             }
+            if (matchEmpty(group))
+                return nullptr;
+            groupIdx = (groupIdx + stride) & groupMask_;
         }
-        return nullptr;
     }
 
-    const ElemT* findOrInsert(const char *chars, unsigned int size)
+    const ElemT* findOrInsert(const char* chars, unsigned int size)
+    {
+        return findOrInsert(chars, size, ElemT::hashCode(chars, size));
+    }
+
+    const ElemT* findOrInsert(const char* chars, unsigned int size, unsigned int h)
     {
-        ElemT* elem = const_cast<ElemT*>(find(chars, size));
+        const ElemT* elem = find(chars, size, h);
         if (elem)
             return elem;
 
-        if (++count_ == allocated_) {
-            if (!allocated_)
-                allocated_ = 4;
-            else
-                allocated_ <<= 1;
-            elements_ = (ElemT**) std::realloc(elements_, sizeof(ElemT*)* allocated_);
-        }
+        if ((elements_.size() + 1) * 8 > capacity() * 7)
+            rehash();
 
-        elem = new ElemT(chars, size);
-        elements_[count_] = elem;
+        char* c_str = static_cast<char*>(allocate(size + 1, 1));
+        std::memcpy(c_str, chars, size);
+        c_str[size] = 0;
 
-        if (!buckets_ || count_ * 5 >= bucketCount_ * 3)
-            rehash();
-        else {
-            unsigned h = elem->hashCode() % bucketCount_;
-            elem ->next_ = buckets_[h];
-            buckets_[h] = elem;
-        }
+        ElemT* newElem = new (allocate(sizeof(ElemT), alignof(ElemT))) ElemT(c_str, size, h);
+        elements_.push_back(newElem);
+        place(newElem);
 
-        return elem;
+        return newElem;
     }
 
     void reset()
     {
-        if (elements_) {
-            ElemT** last = elements_ + count_ + 1;
-            for (ElemT** it = elements_; it != last; ++it)
-                delete *it;
-            std::free(elements_);
-        }
+        for (auto elem : elements_)
+            elem->~ElemT();
+        elements_.clear();
 
-        if (buckets_)
-            std::free(buckets_);
+        for (auto block : arena_)
+            std::free(block);
+        arena_.clear();
+        arenaCur_ = nullptr;
+        arenaEnd_ = nullptr;
 
-        elements_ = 0;
-        buckets_ = 0;
-        allocated_ = 0;
-        count_ = -1;
-        bucketCount_ = 0;
+        freeControlBytes(ctrl_);
+        std::free(slots_);
+        ctrl_ = nullptr;
+        slots_ = nullptr;
+        groupMask_ = 0;
     }
 
 private:
+    static constexpr unsigned int kGroupSize = 16;
+    static constexpr std::uint8_t kEmpty = 0x80;
+    static constexpr std::size_t kArenaBlockSize = 16 * 1024;
+
+    std::size_t capacity() const { return ctrl_ ? (groupMask_ + 1) * kGroupSize : 0; }
+
+    static unsigned int matchTag(const std::uint8_t* group, std::uint8_t tag)
+    {
+#ifdef PSY_TEXT_ELEMENT_TABLE_SSE2
+        auto ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(group));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(tag)));
+#else
+        unsigned int mask = 0;
+        for (auto i = 0U; i < kGroupSize; ++i)
+            mask |= (group[i] == tag) << i;
+        return mask;
+#endif
+    }
+
+    static unsigned int matchEmpty(const std::uint8_t* group)
+    {
+#ifdef PSY_TEXT_ELEMENT_TABLE_SSE2
+        auto ctrl = _mm_load_si128(reinterpret_cast<const __m128i*>(group));
+        return _mm_movemask_epi8(ctrl);
+#else
+        unsigned int mask = 0;
+        for (auto i = 0U; i < kGroupSize; ++i)
+            mask |= (group[i] == kEmpty) << i;
+        return mask;
+#endif
+    }
+
+    /* The index of the lowest bit set in the (non-zero) \p mask */
+    static unsigned int lowestBitIndex(unsigned int mask)
+    {
+#if defined(__GNUC__)
+        return __builtin_ctz(mask);
+#elif defined(_MSC_VER)
+        unsigned long idx;
+        _BitScanForward(&idx, mask);
+        return idx;
+#else
+        unsigned int idx = 0;
+        for (; !(mask & 1); mask >>= 1)
+            ++idx;
+        return idx;
+#endif
+    }
+
+    /* The control bytes are aligned to a group, for the SSE2 loads */
+    static std::uint8_t* allocateControlBytes(std::size_t size)
+    {
+#ifdef _MSC_VER
+        return static_cast<std::uint8_t*>(_aligned_malloc(size, kGroupSize));
+#else
+        return static_cast<std::uint8_t*>(std::aligned_alloc(kGroupSize, size));
+#endif
+    }
+
+    static void freeControlBytes(std::uint8_t* ctrl)
+    {
+#ifdef _MSC_VER
+        _aligned_free(ctrl);
+#else
+        std::free(ctrl);
+#endif
+    }
+
+    void place(ElemT* elem)
+    {
+        const unsigned int h = elem->hashCode();
+        auto groupIdx = h & groupMask_;
+        for (unsigned int stride = 1; ; ++stride) {
+            std::uint8_t* group = ctrl_ + groupIdx * kGroupSize;
+            if (auto empty = matchEmpty(group)) {
+                auto slotIdx = groupIdx * kGroupSize + lowestBitIndex(empty);
+                ctrl_[slotIdx] = h >> 25;
+                slots_[slotIdx] = elem;
+                return;
+            }
+            groupIdx = (groupIdx + stride) & groupMask_;
+        }
+    }
+
     void rehash()
     {
-       if (buckets_)
-           std::free(buckets_);
-
-       if (!bucketCount_)
-           bucketCount_ = 4;
-       else
-           bucketCount_ <<= 1;
-
-       buckets_ = (ElemT**)std::calloc(bucketCount_, sizeof(ElemT*));
-
-       ElemT** last = elements_ + (count_ + 1);
-       for (ElemT** it = elements_; it != last; ++it) {
-           ElemT* cur = *it;
-           unsigned int h = cur->hashCode() % bucketCount_;
-           cur->next_ = buckets_[h];
-           buckets_[h] = cur;
-       }
+        const std::size_t groupCnt = ctrl_ ? (groupMask_ + 1) * 2 : 1;
+        freeControlBytes(ctrl_);
+        std::free(slots_);
+
+        ctrl_ = allocateControlBytes(groupCnt * kGroupSize);
+        std::memset(ctrl_, kEmpty, groupCnt * kGroupSize);
+        slots_ = static_cast<ElemT**>(std::malloc(groupCnt * kGroupSize * sizeof(ElemT*)));
+        groupMask_ = groupCnt - 1;
+
+        for (auto elem : elements_)
+            place(elem);
+    }
+
+    void* allocate(std::size_t size, std::size_t align)
+    {
+        auto cur = reinterpret_cast<std::uintptr_t>(arenaCur_);
+        cur = (cur + align - 1) & ~(align - 1);
+        if (!arenaCur_ || cur + size > reinterpret_cast<std::uintptr_t>(arenaEnd_)) {
+            const std::size_t blockSize = std::max(kArenaBlockSize, size + align);
+            char* block = static_cast<char*>(std::malloc(blockSize));
+            arena_.push_back(block);
+            arenaEnd_ = block + blockSize;
+            cur = (reinterpret_cast<std::uintptr_t>(block) + align - 1) & ~(align - 1);
+        }
+        arenaCur_ = reinterpret_cast<char*>(cur + size);
+        return reinterpret_cast<void*>(cur);
     }
 
-    ElemT** elements_;
-    int count_;
-    int allocated_;
-    ElemT** buckets_;
-    int bucketCount_;
+    std::vector<ElemT*> elements_;
+    std::uint8_t* ctrl_;
+    ElemT** slots_;
+    std::size_t groupMask_;
+
+    std::vector<char*> arena_;
+    char* arenaCur_;
+    char* arenaEnd_;
 };
 
 } // psy
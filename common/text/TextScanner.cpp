@@ -0,0 +1,391 @@
+// Copyright (c) 2020/21 Leandro T. C. Melo <ltcmelo@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "TextScanner.h"
+
+#include "CharacterClass.h"
+
+#if defined(__GNUC__) && defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+  #define PSY_X86_SIMD
+  #include <immintrin.h>
+#endif
+
+using namespace psy;
+
+namespace {
+
+bool isHorizontalWhitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\v' || c == '\f' || c == '\r';
+}
+
+const char* skipHorizontalWhitespace_Scalar(const char* p, const char* end)
+{
+    while (p < end && isHorizontalWhitespace(*p))
+        ++p;
+    return p;
+}
+
+const char* findAnyOf_Scalar(const char* p, const char* end, char c1, char c2, char c3)
+{
+    for (; p < end; ++p) {
+        char c = *p;
+        if (c == c1 || c == c2 || c == c3 || !c || (c & 0x80))
+            break;
+    }
+    return p;
+}
+
+/*
+ * A byte adds a UTF-16 code unit unless it's a continuation byte (10xxxxxx),
+ * and the leading byte of a 4-byte sequence (11110xxx) adds another one: the
+ * code point is outside the BMP and is encoded as a surrogate pair.
+ */
+unsigned int utf16UnitsOf(unsigned char c)
+{
+    return ((c & 0xC0) != 0x80) + (c >= 0xF0);
+}
+
+const char* findAnyOfCountingUTF16_Scalar(const char* p,
+                                          const char* end,
+                                          char c1, char c2, char c3,
+                                          unsigned int& units)
+{
+    unsigned int n = 0;
+    for (; p < end; ++p) {
+        char c = *p;
+        if (c == c1 || c == c2 || c == c3 || !c)
+            break;
+        n += utf16UnitsOf(c);
+    }
+    units += n;
+    return p;
+}
+
+const char* skipIdentifierCharacters_Scalar(const char* p, const char* end)
+{
+    while (p < end && CharacterClass::isIdentifierContinue(*p))
+        ++p;
+    return p;
+}
+
+#ifdef PSY_X86_SIMD
+
+const char* skipHorizontalWhitespace_SSE2(const char* p, const char* end)
+{
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i four = _mm_set1_epi8(4);
+    const __m128i newline = _mm_set1_epi8('\n');
+
+    while (end - p >= 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+        // Bytes within '\t' (9) and '\r' (13), except '\n'; and ' '.
+        __m128i d = _mm_sub_epi8(x, tab);
+        __m128i ctrl = _mm_cmpeq_epi8(_mm_min_epu8(d, four), d);
+        ctrl = _mm_andnot_si128(_mm_cmpeq_epi8(x, newline), ctrl);
+        __m128i ws = _mm_or_si128(ctrl, _mm_cmpeq_epi8(x, space));
+
+        unsigned int mask = ~_mm_movemask_epi8(ws) & 0xFFFF;
+        if (mask)
+            return p + __builtin_ctz(mask);
+        p += 16;
+    }
+    return skipHorizontalWhitespace_Scalar(p, end);
+}
+
+const char* findAnyOf_SSE2(const char* p, const char* end, char c1, char c2, char c3)
+{
+    const __m128i v1 = _mm_set1_epi8(c1);
+    const __m128i v2 = _mm_set1_epi8(c2);
+    const __m128i v3 = _mm_set1_epi8(c3);
+    const __m128i zero = _mm_setzero_si128();
+
+    while (end - p >= 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i eq = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, v1),
+                                               _mm_cmpeq_epi8(x, v2)),
+                                  _mm_or_si128(_mm_cmpeq_epi8(x, v3),
+                                               _mm_cmpeq_epi8(x, zero)));
+
+        // The most significant bit of a byte flags a multi-byte code point.
+        unsigned int mask = _mm_movemask_epi8(eq) | _mm_movemask_epi8(x);
+        if (mask)
+            return p + __builtin_ctz(mask);
+        p += 16;
+    }
+    return findAnyOf_Scalar(p, end, c1, c2, c3);
+}
+
+/*
+ * The UTF-16 code units of a block are computed from the masks of its
+ * continuation bytes and of its 4-byte sequences' leading bytes (see
+ * utf16UnitsOf), restricted, through \p prefix, to the bytes skipped.
+ */
+const char* findAnyOfCountingUTF16_SSE2(const char* p,
+                                        const char* end,
+                                        char c1, char c2, char c3,
+                                        unsigned int& units)
+{
+    const __m128i v1 = _mm_set1_epi8(c1);
+    const __m128i v2 = _mm_set1_epi8(c2);
+    const __m128i v3 = _mm_set1_epi8(c3);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i contLimit = _mm_set1_epi8(static_cast<char>(0xC0));
+    const __m128i lead4 = _mm_set1_epi8(static_cast<char>(0xF0));
+
+    unsigned int n = 0;
+    while (end - p >= 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i eq = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, v1),
+                                               _mm_cmpeq_epi8(x, v2)),
+                                  _mm_or_si128(_mm_cmpeq_epi8(x, v3),
+                                               _mm_cmpeq_epi8(x, zero)));
+
+        // As signed, continuation bytes are the ones below 0xC0 (-64).
+        unsigned int cont = _mm_movemask_epi8(_mm_cmplt_epi8(x, contLimit));
+        unsigned int wide = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(x, lead4), x));
+
+        unsigned int stop = _mm_movemask_epi8(eq);
+        if (stop) {
+            unsigned int k = __builtin_ctz(stop);
+            unsigned int prefix = (1u << k) - 1;
+            units += n + k
+                    - __builtin_popcount(cont & prefix)
+                    + __builtin_popcount(wide & prefix);
+            return p + k;
+        }
+        n += 16 - __builtin_popcount(cont) + __builtin_popcount(wide);
+        p += 16;
+    }
+    units += n;
+    return findAnyOfCountingUTF16_Scalar(p, end, c1, c2, c3, units);
+}
+
+/*
+ * Identifiers are typically short, so they're scanned 16 bytes at a time
+ * even when wider registers are available.
+ */
+const char* skipIdentifierCharacters_SSE2(const char* p, const char* end)
+{
+    const __m128i lowerA = _mm_set1_epi8('a');
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i case_ = _mm_set1_epi8(0x20);
+    const __m128i twentyFive = _mm_set1_epi8(25);
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i underscore = _mm_set1_epi8('_');
+    const __m128i dollar = _mm_set1_epi8('$');
+
+    while (end - p >= 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+        // Setting bit 0x20 maps both upper and lower case letters (and
+        // only them) into the range of the lower case ones.
+        __m128i l = _mm_sub_epi8(_mm_or_si128(x, case_), lowerA);
+        __m128i alpha = _mm_cmpeq_epi8(_mm_min_epu8(l, twentyFive), l);
+        __m128i d = _mm_sub_epi8(x, zero);
+        __m128i digit = _mm_cmpeq_epi8(_mm_min_epu8(d, nine), d);
+        __m128i ident = _mm_or_si128(_mm_or_si128(alpha, digit),
+                                     _mm_or_si128(_mm_cmpeq_epi8(x, underscore),
+                                                  _mm_cmpeq_epi8(x, dollar)));
+
+        unsigned int mask = ~_mm_movemask_epi8(ident) & 0xFFFF;
+        if (mask)
+            return p + __builtin_ctz(mask);
+        p += 16;
+    }
+    return skipIdentifierCharacters_Scalar(p, end);
+}
+
+__attribute__((target("avx2")))
+const char* skipHorizontalWhitespace_AVX2(const char* p, const char* end)
+{
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i four = _mm256_set1_epi8(4);
+    const __m256i newline = _mm256_set1_epi8('\n');
+
+    while (end - p >= 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+
+        __m256i d = _mm256_sub_epi8(x, tab);
+        __m256i ctrl = _mm256_cmpeq_epi8(_mm256_min_epu8(d, four), d);
+        ctrl = _mm256_andnot_si256(_mm256_cmpeq_epi8(x, newline), ctrl);
+        __m256i ws = _mm256_or_si256(ctrl, _mm256_cmpeq_epi8(x, space));
+
+        unsigned int mask = ~static_cast<unsigned int>(_mm256_movemask_epi8(ws));
+        if (mask)
+            return p + __builtin_ctz(mask);
+        p += 32;
+    }
+    return skipHorizontalWhitespace_Scalar(p, end);
+}
+
+__attribute__((target("avx2")))
+const char* findAnyOf_AVX2(const char* p, const char* end, char c1, char c2, char c3)
+{
+    const __m256i v1 = _mm256_set1_epi8(c1);
+    const __m256i v2 = _mm256_set1_epi8(c2);
+    const __m256i v3 = _mm256_set1_epi8(c3);
+    const __m256i zero = _mm256_setzero_si256();
+
+    while (end - p >= 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i eq = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, v1),
+                                                     _mm256_cmpeq_epi8(x, v2)),
+                                     _mm256_or_si256(_mm256_cmpeq_epi8(x, v3),
+                                                     _mm256_cmpeq_epi8(x, zero)));
+
+        unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(eq))
+                | static_cast<unsigned int>(_mm256_movemask_epi8(x));
+        if (mask)
+            return p + __builtin_ctz(mask);
+        p += 32;
+    }
+    return findAnyOf_Scalar(p, end, c1, c2, c3);
+}
+
+__attribute__((target("avx2,popcnt")))
+const char* findAnyOfCountingUTF16_AVX2(const char* p,
+                                        const char* end,
+                                        char c1, char c2, char c3,
+                                        unsigned int& units)
+{
+    const __m256i v1 = _mm256_set1_epi8(c1);
+    const __m256i v2 = _mm256_set1_epi8(c2);
+    const __m256i v3 = _mm256_set1_epi8(c3);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i contLimit = _mm256_set1_epi8(static_cast<char>(0xC0));
+    const __m256i lead4 = _mm256_set1_epi8(static_cast<char>(0xF0));
+
+    unsigned int n = 0;
+    while (end - p >= 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i eq = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, v1),
+                                                     _mm256_cmpeq_epi8(x, v2)),
+                                     _mm256_or_si256(_mm256_cmpeq_epi8(x, v3),
+                                                     _mm256_cmpeq_epi8(x, zero)));
+
+        unsigned int cont = static_cast<unsigned int>(
+                    _mm256_movemask_epi8(_mm256_cmpgt_epi8(contLimit, x)));
+        unsigned int wide = static_cast<unsigned int>(
+                    _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_max_epu8(x, lead4), x)));
+
+        unsigned int stop = static_cast<unsigned int>(_mm256_movemask_epi8(eq));
+        if (stop) {
+            unsigned int k = __builtin_ctz(stop);
+            unsigned int prefix = (1u << k) - 1;
+            units += n + k
+                    - __builtin_popcount(cont & prefix)
+                    + __builtin_popcount(wide & prefix);
+            return p + k;
+        }
+        n += 32 - __builtin_popcount(cont) + __builtin_popcount(wide);
+        p += 32;
+    }
+    units += n;
+    return findAnyOfCountingUTF16_Scalar(p, end, c1, c2, c3, units);
+}
+
+#endif
+
+using Kernels = TextScanner::Kernels;
+
+const Kernels kScalarKernels = { skipHorizontalWhitespace_Scalar,
+                                 findAnyOf_Scalar,
+                                 findAnyOfCountingUTF16_Scalar,
+                                 skipIdentifierCharacters_Scalar };
+
+#ifdef PSY_X86_SIMD
+const Kernels kSSE2Kernels = { skipHorizontalWhitespace_SSE2,
+                               findAnyOf_SSE2,
+                               findAnyOfCountingUTF16_SSE2,
+                               skipIdentifierCharacters_SSE2 };
+
+const Kernels kAVX2Kernels = { skipHorizontalWhitespace_AVX2,
+                               findAnyOf_AVX2,
+                               findAnyOfCountingUTF16_AVX2,
+                               skipIdentifierCharacters_SSE2 };
+
+bool isAVX2Supported()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+}
+#endif
+
+const Kernels& selectKernels()
+{
+#ifdef PSY_X86_SIMD
+    if (isAVX2Supported())
+        return kAVX2Kernels;
+    return kSSE2Kernels;
+#else
+    return kScalarKernels;
+#endif
+}
+
+const Kernels& selectedKernels()
+{
+    static const Kernels& k = selectKernels();
+    return k;
+}
+
+} // anonymous
+
+const char* TextScanner::skipHorizontalWhitespace(const char* p, const char* end)
+{
+    return selectedKernels().skipHorizontalWhitespace_(p, end);
+}
+
+const char* TextScanner::findAnyOf(const char* p, const char* end, char c1, char c2, char c3)
+{
+    return selectedKernels().findAnyOf_(p, end, c1, c2, c3);
+}
+
+const char* TextScanner::findAnyOfCountingUTF16(const char* p,
+                                                const char* end,
+                                                char c1, char c2, char c3,
+                                                unsigned int& units)
+{
+    return selectedKernels().findAnyOfCountingUTF16_(p, end, c1, c2, c3, units);
+}
+
+const char* TextScanner::skipIdentifierCharacters(const char* p, const char* end)
+{
+    return selectedKernels().skipIdentifierCharacters_(p, end);
+}
+
+const TextScanner::Kernels* TextScanner::kernels(InstructionSet instructionSet)
+{
+    switch (instructionSet) {
+        case InstructionSet::Scalar:
+            return &kScalarKernels;
+#ifdef PSY_X86_SIMD
+        case InstructionSet::SSE2:
+            return &kSSE2Kernels;
+        case InstructionSet::AVX2:
+            return isAVX2Supported() ? &kAVX2Kernels : nullptr;
+#endif
+        default:
+            return nullptr;
+    }
+}
@@ -0,0 +1,106 @@
+// Copyright (c) 2020/21 Leandro T. C. Melo <ltcmelo@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef PSYCHE_TEXT_SCANNER_H__
+#define PSYCHE_TEXT_SCANNER_H__
+
+#include "../API.h"
+
+namespace psy {
+
+/**
+ * \brief The TextScanner class.
+ *
+ * Scanning primitives that look for the next "interesting" byte of a text
+ * many bytes at a time (with SSE2 or AVX2, chosen at runtime, and a scalar
+ * fallback). Every scan stops at a null byte and, unless it counts UTF-16
+ * code units, at a byte of a multi-byte UTF-8 code point, so the bytes that
+ * are skipped are always ASCII and can be accounted for in bulk.
+ *
+ * The scanned range is <tt>[p, end)</tt>; nothing at or beyond \c end is read.
+ */
+class PSY_API TextScanner
+{
+public:
+    /**
+     * The first byte in <tt>[p, end)</tt> that isn't a horizontal whitespace
+     * (i.e., one of <tt>' '</tt>, \c \\t, \c \\v, \c \\f, and \c \\r), or \p end.
+     */
+    static const char* skipHorizontalWhitespace(const char* p, const char* end);
+
+    /**
+     * The first byte in <tt>[p, end)</tt> that is either \p c1, \p c2,
+     * or \p c3, or \p end.
+     */
+    static const char* findAnyOf(const char* p, const char* end, char c1, char c2, char c3);
+
+    /**
+     * As \c findAnyOf, but the scan carries on through multi-byte UTF-8 code
+     * points (it still stops at a null byte). The number of UTF-16 code units
+     * that encode the bytes skipped, which must be valid UTF-8 starting at a
+     * code point boundary, is added to \p units.
+     */
+    static const char* findAnyOfCountingUTF16(const char* p,
+                                              const char* end,
+                                              char c1, char c2, char c3,
+                                              unsigned int& units);
+
+    /**
+     * The first byte in <tt>[p, end)</tt> that isn't an ASCII identifier
+     * character (see CharacterClass::IdentifierContinue), or \p end.
+     */
+    static const char* skipIdentifierCharacters(const char* p, const char* end);
+
+    /**
+     * \brief The InstructionSet enumeration.
+     *
+     * The instruction sets for which there are kernels of the scans.
+     */
+    enum class InstructionSet : char
+    {
+        Scalar,
+        SSE2,
+        AVX2,
+    };
+
+    /**
+     * \brief The Kernels struct.
+     *
+     * The kernels of the scans above, for a given instruction set.
+     */
+    struct Kernels
+    {
+        const char* (*skipHorizontalWhitespace_)(const char*, const char*);
+        const char* (*findAnyOf_)(const char*, const char*, char, char, char);
+        const char* (*findAnyOfCountingUTF16_)(const char*, const char*, char, char, char, unsigned int&);
+        const char* (*skipIdentifierCharacters_)(const char*, const char*);
+    };
+
+    /**
+     * The kernels for the \p instructionSet, or null if it isn't available
+     * (in this build, or in this CPU); the scans above use those of the best
+     * set available. This lets the kernels be tested against each other.
+     */
+    static const Kernels* kernels(InstructionSet instructionSet);
+};
+
+} // psy
+
+#endif
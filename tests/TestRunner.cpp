@@ -22,6 +22,7 @@
 
 #include "../C/tests/TestBinder.h"
 #include "../C/tests/TestParser.h"
+#include "../C/tests/TestSyntaxTree.h"
 #include "../C/tests/TestTypeChecker.h"
 
 #include <iostream>
@@ -36,5 +37,6 @@ void TestRunner::runSuite()
     // C
     std::cout << "  C" << std::endl;
     TestParser().testAll();
+    TestSyntaxTree().testAll();
     //TestBinder().testAll();
 }
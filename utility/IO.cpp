@@ -20,24 +20,21 @@
 
 #include "IO.h"
 
+#include "common/text/SourceText.h"
+
 #include <fstream>
 #include <iostream>
-#include <sstream>
 
 namespace psy {
 
 std::pair<int, std::string> readFile(const std::string& fileName)
 {
-    std::ifstream ifs(fileName);
-    if (!ifs) {
+    auto [exit, text] = SourceText::mapFile(fileName);
+    if (exit != 0) {
         std::cerr << "file input error: " << fileName << std::endl;
         return std::make_pair(1, "");
     }
-
-    std::stringstream ss;
-    ss << ifs.rdbuf();
-    ifs.close();
-    return std::make_pair(0, ss.str());
+    return std::make_pair(0, std::string(text.rawText()));
 }
 
 int writeFile(const std::string& fileName, const std::string& content)